@@ -0,0 +1,640 @@
+#pragma once
+
+#ifndef EMSCRIPTEN
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+
+#include "json.hpp"
+#include "../lpr_core/dual_simplex/dual_simplex.hpp"
+#include "../lpr_core/two_phase_simplex/two_phase_simplex.hpp"
+#include "../lpr_core/branch_and_bound/branch_and_bound.hpp"
+#include "../lpr_core/cutting_plane/cutting_plane.hpp"
+#include "../lpr_core/duality/duality.hpp"
+#include "../lpr_core/branch_and_bound_knapsack/branch_and_bound_knapsack.hpp"
+#include "../lpr_core/machine_scheduling/machine_scheduling_penalty.hpp"
+#include "../lpr_core/machine_scheduling/tardiness_scheduler.hpp"
+#include "../lpr_core/hungarian_algorithm/hungarian_algorithm.hpp"
+#include "../lpr_core/nearest_neighbor/nearest_neighbor_tsp.hpp"
+#include "../lpr_core/cheapest_insertion/cheapest_insertion_tsp.hpp"
+#include "../lpr_core/DEA/dea_solver.hpp"
+#include "../lpr_core/model_io/mps_reader.hpp"
+#include "../lpr_core/model_io/lp_reader.hpp"
+#include "../lpr_core/model_io/model_input.hpp"
+#include "../lpr_core/thread_pool/thread_pool.hpp"
+
+// Native batch front end. Every input record is one JSON object per line naming a solver and its data in
+// the same shape the web bindings take; MPS and LP files given on the command line become records of their
+// own. Records are solved in parallel a block at a time and one JSON result line per record is written in
+// input order
+class BatchCli
+{
+private:
+    struct Record
+    {
+        std::string source;
+        std::string json;
+        long index = 0;
+    };
+
+    struct LpInput
+    {
+        std::vector<double> objFunc;
+        std::vector<std::vector<double>> constraints;
+        bool isMin = false;
+        bool fromFile = false;
+        ModelFile file;
+    };
+
+    static constexpr std::size_t MIN_BLOCK = 64;
+
+    std::vector<std::string> inputs;
+    std::string outputPath;
+    std::string defaultSolver = "dualSimplex";
+    std::string defaultEngine = "dense";
+    std::size_t threadCount = 0;
+    bool fixedMps = false;
+    bool showHelp = false;
+    std::unique_ptr<ThreadPool> pool;
+
+    static constexpr const char *USAGE =
+        "usage: linprog-toolset [options] [file ...]\n"
+        "\n"
+        "Solves JSON-lines records (.jsonl, .json or - for stdin) and MPS/LP model files (.mps, .lp, optionally .gz)\n"
+        "and writes one JSON result per record, in input order. With no files, records are read from stdin.\n"
+        "\n"
+        "  -o, --output FILE   write results to FILE instead of stdout\n"
+        "  -s, --solver NAME   solver for model files and records without a \"solver\" (default dualSimplex)\n"
+        "  -e, --engine NAME   dualSimplex engine when a record names none: dense (default), revised, interiorPoint\n"
+        "  -j, --threads N     records solved at once; 0 uses every core (default), 1 solves in order\n"
+        "      --fixed-mps     read .mps files as fixed-column MPS\n"
+        "  -h, --help          show this text\n"
+        "\n"
+        "Solvers and their record fields:\n"
+        "  dualSimplex, twoPhaseSimplex, branchAndBound, cuttingPlane, duality\n"
+        "      objective, constraints (rows of coefficients, rhs, sign: 1 for >=, 0 for <=) or file,\n"
+        "      problemType (\"Max\" or \"Min\") or isMin; dualSimplex and twoPhaseSimplex take tableaus: true,\n"
+        "      dualSimplex takes engine; large model files want the revised engine; branchAndBound takes\n"
+        "      nodeLimit (default 100, 0 for none), timeLimit in seconds, absoluteGap, relativeGap and\n"
+        "      stopAtFirstIncumbent, and reports stop, bestBound, incumbent (when found), gap and nodes;\n"
+        "      its tableauRendering (none, finalOnly or full, the default) sets the tableaus in json\n"
+        "  knapsack                      objective, constraints\n"
+        "  cheapestInsertion, nearestNeighbor\n"
+        "                                distances, startCity\n"
+        "  hungarianAlgorithm            costs, maximize, blankValue\n"
+        "  machineSchedulingTardiness    jobs\n"
+        "  machineSchedulingPenalty      jobs, penalty\n"
+        "  dea                           inputs, outputs, isMin\n"
+        "\n"
+        "Every record may carry an id, which is copied to its result.\n";
+
+    // writing results through cout's buffer and pointing cout at stderr keeps solver chatter out of them
+    class CoutToStderr
+    {
+    private:
+        std::streambuf *saved;
+
+    public:
+        CoutToStderr() : saved(std::cout.rdbuf(std::cerr.rdbuf())) {}
+        ~CoutToStderr() { std::cout.rdbuf(saved); }
+        std::streambuf *Saved() const { return saved; }
+    };
+
+    static bool EndsWith(std::string_view text, std::string_view suffix)
+    {
+        return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+    }
+
+    static bool IsRecordFile(std::string_view path)
+    {
+        return path == "-" || EndsWith(path, ".jsonl") || EndsWith(path, ".json") || EndsWith(path, ".jsonl.gz");
+    }
+
+    void ParseArguments(int argc, char *argv[])
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                    throw std::runtime_error(arg + " needs a value.");
+                return argv[++i];
+            };
+
+            if (arg == "-h" || arg == "--help")
+                showHelp = true;
+            else if (arg == "-o" || arg == "--output")
+                outputPath = value();
+            else if (arg == "-s" || arg == "--solver")
+                defaultSolver = value();
+            else if (arg == "-e" || arg == "--engine")
+                defaultEngine = value();
+            else if (arg == "-j" || arg == "--threads")
+            {
+                std::string count = value();
+                try
+                {
+                    threadCount = static_cast<std::size_t>(std::stoul(count));
+                }
+                catch (const std::exception &)
+                {
+                    throw std::runtime_error("bad thread count '" + count + "'.");
+                }
+            }
+            else if (arg == "--fixed-mps")
+                fixedMps = true;
+            else if (arg.size() > 1 && arg[0] == '-')
+                throw std::runtime_error("unknown option " + arg + ".");
+            else
+                inputs.push_back(arg);
+        }
+        if (inputs.empty())
+            inputs.push_back("-");
+    }
+
+    static const JsonValue &Required(const JsonValue &record, std::string_view key)
+    {
+        const JsonValue *value = record.Find(key);
+        if (!value || value->IsNull())
+            throw std::runtime_error("missing \"" + std::string(key) + "\".");
+        return *value;
+    }
+
+    // the solvers index their input without checking it, so malformed shapes are rejected here
+    static void RequireRows(const std::vector<std::vector<double>> &mat, std::string_view key, size_t width)
+    {
+        if (mat.empty())
+            throw std::runtime_error("\"" + std::string(key) + "\" has no rows.");
+        for (size_t i = 0; i < mat.size(); i++)
+        {
+            if (mat[i].size() != width)
+                throw std::runtime_error("row " + std::to_string(i + 1) + " of \"" + std::string(key) + "\" has " +
+                                         std::to_string(mat[i].size()) + " entries; expected " + std::to_string(width) + ".");
+        }
+    }
+
+    static void RequireSquare(const std::vector<std::vector<double>> &mat, std::string_view key, size_t minSize)
+    {
+        if (mat.size() < minSize)
+            throw std::runtime_error("\"" + std::string(key) + "\" needs at least " + std::to_string(minSize) + " rows.");
+        RequireRows(mat, key, mat.size());
+    }
+
+    // "problemType" as the web front end sends it, or a plain isMin flag; max when neither is given
+    static bool ReadIsMin(const JsonValue &record, bool fallback)
+    {
+        if (const JsonValue *type = record.Find("problemType"))
+            return type->AsString("problemType") == "Min";
+        if (const JsonValue *isMin = record.Find("isMin"))
+            return isMin->AsBool("isMin");
+        return fallback;
+    }
+
+    ModelFile ReadModelFile(const std::string &path) const
+    {
+        if (EndsWith(path, ".lp") || EndsWith(path, ".lp.gz"))
+            return LpReader().ReadFile(path);
+        return MpsReader(fixedMps ? MpsFormat::Fixed : MpsFormat::Free).ReadFile(path);
+    }
+
+    LpInput ReadLp(const JsonValue &record) const
+    {
+        LpInput input;
+        if (const JsonValue *path = record.Find("file"))
+        {
+            input.file = ReadModelFile(path->AsString("file"));
+            input.fromFile = true;
+        }
+        else
+        {
+            input.objFunc = Required(record, "objective").AsVector("objective");
+            input.constraints = Required(record, "constraints").AsMatrix("constraints");
+            if (input.objFunc.empty())
+                throw std::runtime_error("\"objective\" is empty.");
+            // each row is the coefficients followed by the rhs and the sign
+            RequireRows(input.constraints, "constraints", input.objFunc.size() + 2);
+        }
+        input.isMin = ReadIsMin(record, input.fromFile && input.file.isMin);
+        return input;
+    }
+
+    // the solvers other than the dual simplex only take the dense rows of the web front end
+    static void Densify(LpInput &input, const std::string &solver)
+    {
+        if (!input.fromFile)
+            return;
+        if (input.file.HasBounds())
+            throw std::runtime_error(solver + " takes no variable bounds; solve this file with dualSimplex.");
+        input.objFunc = input.file.model.objective;
+        input.constraints = input.file.model.ToDense();
+    }
+
+    static bool WantsTableaus(const JsonValue &record)
+    {
+        const JsonValue *tableaus = record.Find("tableaus");
+        return tableaus && tableaus->AsBool("tableaus");
+    }
+
+    template <typename SolverResult>
+    static void WriteLpResult(JsonWriter &out, const SolverResult &res, double offset, bool withTableaus)
+    {
+        out.Field("status", std::isnan(res.optimalSolution) ? "noSolution" : "optimal");
+        out.Field("optimalSolution", res.optimalSolution + offset);
+        out.Field("changingVars", res.changingVars);
+        out.Field("pivots", static_cast<double>(res.pivotCols.size()));
+        if (withTableaus)
+        {
+            out.Field("tableaus", res.tableaus);
+            out.Field("pivotCols", res.pivotCols);
+            out.Field("pivotRows", res.pivotRows);
+            out.Field("headerRow", res.headerRow);
+        }
+    }
+
+    void SolveDualSimplex(const JsonValue &record, JsonWriter &out) const
+    {
+        LpInput input = ReadLp(record);
+        bool withTableaus = WantsTableaus(record);
+
+        DualSimplex solver;
+        solver.SetHistoryMode(withTableaus ? TableauHistory::Full : TableauHistory::FinalOnly);
+        const JsonValue *engine = record.Find("engine");
+        const std::string &name = engine ? engine->AsString("engine") : defaultEngine;
+        if (name == "dense")
+            solver.SetEngine(SimplexEngine::Dense);
+        else if (name == "revised")
+            solver.SetEngine(SimplexEngine::Revised);
+        else if (name == "interiorPoint")
+            solver.SetEngine(SimplexEngine::InteriorPoint);
+        else
+            throw std::runtime_error("unknown engine '" + name + "'.");
+        if (!input.fromFile)
+        {
+            WriteLpResult(out, solver.DoDualSimplex(input.objFunc, input.constraints, input.isMin), 0.0, withTableaus);
+            return;
+        }
+
+        const ModelFile &file = input.file;
+        if (file.HasBounds())
+        {
+            for (int j = 0; j < file.model.numCols; j++)
+            {
+                if (!std::isfinite(file.lower[j]))
+                    throw std::runtime_error("column " + file.colNames[j] + " has no finite lower bound; the simplex engines need one.");
+            }
+            solver.SetVariableBounds(file.lower, file.upper);
+        }
+        WriteLpResult(out, solver.DoDualSimplex(file.model, input.isMin), file.objectiveOffset, withTableaus);
+    }
+
+    static BranchAndBound::SearchLimits ReadSearchLimits(const JsonValue &record)
+    {
+        BranchAndBound::SearchLimits limits;
+        if (const JsonValue *nodeLimit = record.Find("nodeLimit"))
+            limits.nodeLimit = static_cast<int>(nodeLimit->AsNumber("nodeLimit"));
+        if (const JsonValue *timeLimit = record.Find("timeLimit"))
+            limits.timeLimit = timeLimit->AsNumber("timeLimit");
+        if (const JsonValue *absoluteGap = record.Find("absoluteGap"))
+            limits.absoluteGap = absoluteGap->AsNumber("absoluteGap");
+        if (const JsonValue *relativeGap = record.Find("relativeGap"))
+            limits.relativeGap = relativeGap->AsNumber("relativeGap");
+        if (const JsonValue *firstIncumbent = record.Find("stopAtFirstIncumbent"))
+            limits.stopAtFirstIncumbent = firstIncumbent->AsBool("stopAtFirstIncumbent");
+        return limits;
+    }
+
+    static TableauRendering ReadTableauRendering(const JsonValue &record)
+    {
+        const JsonValue *rendering = record.Find("tableauRendering");
+        if (!rendering)
+            return TableauRendering::Full;
+        const std::string &name = rendering->AsString("tableauRendering");
+        if (name == "none")
+            return TableauRendering::None;
+        if (name == "finalOnly")
+            return TableauRendering::FinalOnly;
+        if (name == "full")
+            return TableauRendering::Full;
+        throw std::runtime_error("unknown tableauRendering '" + name + "'.");
+    }
+
+    void SolveRecord(const JsonValue &record, const std::string &solverName, JsonWriter &out) const
+    {
+        if (solverName == "dualSimplex")
+        {
+            SolveDualSimplex(record, out);
+        }
+        else if (solverName == "twoPhaseSimplex")
+        {
+            LpInput input = ReadLp(record);
+            Densify(input, solverName);
+            TwoPhaseSimplex solver;
+            solver.DoTwoPhase(input.objFunc, input.constraints, input.isMin);
+            WriteLpResult(out, solver.GetResult(), input.file.objectiveOffset, WantsTableaus(record));
+        }
+        else if (solverName == "branchAndBound")
+        {
+            LpInput input = ReadLp(record);
+            Densify(input, solverName);
+            BranchAndBound solver;
+            solver.SetLimits(ReadSearchLimits(record));
+            solver.SetTableauRendering(ReadTableauRendering(record));
+            solver.RunBranchAndBound(input.objFunc, input.constraints, input.isMin);
+            const BranchAndBound::SearchResult &search = solver.GetLastResult();
+            out.Field("status", "ok");
+            out.Field("stop", BranchAndBound::SearchStopName(search.stop));
+            out.Field("bestBound", search.bestBound);
+            if (search.incumbent)
+                out.Field("incumbent", *search.incumbent);
+            out.Field("gap", search.gap);
+            out.Field("nodes", static_cast<double>(search.nodes));
+            out.Field("json", solver.getJSON());
+            out.Field("solution", solver.getSolutionStr());
+        }
+        else if (solverName == "cuttingPlane")
+        {
+            LpInput input = ReadLp(record);
+            Densify(input, solverName);
+            CuttingPlane solver;
+            solver.RunCuttingPlane(input.objFunc, input.constraints, input.isMin);
+            out.Field("status", "ok");
+            out.Field("solution", solver.getCollectedOutput());
+        }
+        else if (solverName == "duality")
+        {
+            LpInput input = ReadLp(record);
+            Densify(input, solverName);
+            Duality solver;
+            solver.RunDuality(input.objFunc, input.constraints, input.isMin);
+            out.Field("status", "ok");
+            out.Field("outputString", solver.getOutput());
+        }
+        else if (solverName == "knapsack")
+        {
+            auto values = Required(record, "objective").AsVector("objective");
+            auto capacityRows = Required(record, "constraints").AsMatrix("constraints");
+            if (values.empty())
+                throw std::runtime_error("\"objective\" is empty.");
+            RequireRows(capacityRows, "constraints", values.size() + 2);
+            KnapSack solver;
+            solver.RunBranchAndBoundKnapSack(values, capacityRows);
+            out.Field("status", "ok");
+            out.Field("json", solver.getJSON());
+            out.Field("ranking", solver.getRanking());
+            out.Field("solution", solver.getFinalSolution());
+        }
+        else if (solverName == "cheapestInsertion" || solverName == "nearestNeighbor")
+        {
+            auto distances = Required(record, "distances").AsMatrix("distances");
+            RequireSquare(distances, "distances", 2);
+            // cities are numbered from 1; only cheapest insertion picks its own start
+            const JsonValue *start = record.Find("startCity");
+            int startCity = start ? static_cast<int>(start->AsNumber("startCity")) : (solverName == "cheapestInsertion" ? -1 : 1);
+            if (start && (startCity < 1 || startCity > static_cast<int>(distances.size())))
+                throw std::runtime_error("\"startCity\" must be between 1 and " + std::to_string(distances.size()) + ".");
+            std::string solution;
+            if (solverName == "cheapestInsertion")
+            {
+                CheapestInsertion solver;
+                solver.runCheapestInsertion(distances, startCity);
+                solution = solver.getCollectedOutput();
+            }
+            else
+            {
+                NearestNeighbour solver;
+                solver.runNearestNeighbour(distances, startCity);
+                solution = solver.getCollectedOutput();
+            }
+            out.Field("status", "ok");
+            out.Field("solution", solution);
+        }
+        else if (solverName == "hungarianAlgorithm")
+        {
+            const JsonValue *maximize = record.Find("maximize");
+            const JsonValue *blank = record.Find("blankValue");
+            auto costs = Required(record, "costs").AsMatrix("costs");
+            RequireRows(costs, "costs", costs.empty() ? 0 : costs[0].size());
+            if (costs[0].empty())
+                throw std::runtime_error("\"costs\" has no columns.");
+            Hungarian solver;
+            solver.runHungarian(costs, maximize && maximize->AsBool("maximize"),
+                                blank ? blank->AsNumber("blankValue") : 0.0, blank != nullptr);
+            out.Field("status", "ok");
+            out.Field("solution", solver.getCollectedOutput());
+        }
+        else if (solverName == "machineSchedulingTardiness")
+        {
+            // a job is its number, processing time and due date
+            auto jobs = Required(record, "jobs").AsMatrix("jobs");
+            RequireRows(jobs, "jobs", 3);
+            MachineSchedulingTardiness solver;
+            solver.runTardinessScheduler(jobs);
+            out.Field("status", "ok");
+            out.Field("json", solver.getJSON());
+        }
+        else if (solverName == "machineSchedulingPenalty")
+        {
+            auto jobs = Required(record, "jobs").AsMatrix("jobs");
+            auto penalty = Required(record, "penalty").AsVector("penalty");
+            RequireRows(jobs, "jobs", 3);
+            if (penalty.size() != jobs.size())
+                throw std::runtime_error("\"penalty\" needs one rate per job.");
+            MachineSchedulingPenalty solver;
+            solver.runPenaltyScheduler(jobs, penalty);
+            out.Field("status", "ok");
+            out.Field("json", solver.getJSON());
+        }
+        else if (solverName == "dea")
+        {
+            bool isMin = ReadIsMin(record, false);
+            auto inputs = Required(record, "inputs").AsMatrix("inputs");
+            auto outputs = Required(record, "outputs").AsMatrix("outputs");
+            RequireRows(inputs, "inputs", inputs.empty() ? 0 : inputs[0].size());
+            RequireRows(outputs, "outputs", outputs.empty() ? 0 : outputs[0].size());
+            if (inputs.size() != outputs.size())
+                throw std::runtime_error("\"inputs\" and \"outputs\" need one row per unit.");
+            DEASolver solver;
+            solver.setProblemType(isMin ? "Min" : "Max");
+            solver.doDEA(inputs, outputs, isMin);
+            out.Field("status", "ok");
+            out.Field("outputString", solver.getOutput());
+        }
+        else
+        {
+            throw std::runtime_error("unknown solver '" + solverName + "'.");
+        }
+    }
+
+    std::string Solve(const Record &rec, bool &failed) const
+    {
+        JsonWriter out;
+        JsonValue id;
+        id.type = JsonValue::Type::Number;
+        id.number = static_cast<double>(rec.index);
+        std::string solverName = defaultSolver;
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            JsonValue record = JsonReader::Parse(rec.json);
+            if (record.type != JsonValue::Type::Object)
+                throw std::runtime_error("a record must be a JSON object.");
+            if (const JsonValue *given = record.Find("id"))
+                id = *given;
+            if (const JsonValue *given = record.Find("solver"))
+                solverName = given->AsString("solver");
+
+            JsonWriter solved;
+            solved.Field("id", id);
+            solved.Field("solver", solverName);
+            SolveRecord(record, solverName, solved);
+            out = std::move(solved);
+        }
+        catch (const std::exception &e)
+        {
+            failed = true;
+            out = JsonWriter();
+            out.Field("id", id);
+            out.Field("solver", solverName);
+            out.Field("status", "error");
+            out.Field("error", rec.source + ": " + e.what());
+        }
+        out.Field("seconds", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        return out.Finish();
+    }
+
+    // solves the block in parallel and writes it in order; returns the number of failed records
+    std::size_t SolveBlock(const std::vector<Record> &block, std::ostream &results)
+    {
+        std::vector<std::string> lines(block.size());
+        std::vector<char> failures(block.size(), 0);
+        auto solveOne = [&](std::size_t i)
+        {
+            bool failed = false;
+            lines[i] = Solve(block[i], failed);
+            failures[i] = failed;
+        };
+
+        if (threadCount == 1)
+        {
+            for (std::size_t i = 0; i < block.size(); i++)
+                solveOne(i);
+        }
+        else
+        {
+            ThreadPool &workers = threadCount == 0 ? ThreadPool::Shared() : *pool;
+            workers.ForEach(0, block.size(), solveOne);
+        }
+
+        for (const std::string &line : lines)
+            results << line << '\n';
+        results.flush();
+        return static_cast<std::size_t>(std::count(failures.begin(), failures.end(), 1));
+    }
+
+    std::size_t BlockSize() const
+    {
+        std::size_t threads = threadCount == 0 ? ThreadPool::Shared().Size() : threadCount;
+        return std::max(MIN_BLOCK, 8 * threads);
+    }
+
+public:
+    // 0 when every record solved, 1 when some failed, 2 for bad arguments or unreadable inputs
+    int Run(int argc, char *argv[])
+    {
+        try
+        {
+            ParseArguments(argc, argv);
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << "\n\n"
+                      << USAGE;
+            return 2;
+        }
+        if (showHelp)
+        {
+            std::cout << USAGE;
+            return 0;
+        }
+
+        std::ofstream outFile;
+        if (!outputPath.empty())
+        {
+            outFile.open(outputPath, std::ios::binary);
+            if (!outFile)
+            {
+                std::cerr << "Cannot write " << outputPath << ".\n";
+                return 2;
+            }
+        }
+        if (threadCount > 1)
+            pool = std::make_unique<ThreadPool>(threadCount);
+
+        CoutToStderr redirect;
+        std::ostream results(outputPath.empty() ? redirect.Saved() : outFile.rdbuf());
+
+        std::vector<Record> block;
+        std::size_t blockSize = BlockSize();
+        std::size_t failed = 0;
+        long index = 0;
+        auto add = [&](std::string source, std::string json)
+        {
+            block.push_back({std::move(source), std::move(json), index++});
+            if (block.size() >= blockSize)
+            {
+                failed += SolveBlock(block, results);
+                block.clear();
+            }
+        };
+
+        for (const std::string &path : inputs)
+        {
+            if (!IsRecordFile(path))
+            {
+                JsonWriter fileRecord;
+                fileRecord.Field("id", path);
+                fileRecord.Field("file", path);
+                add(path, fileRecord.Finish());
+                continue;
+            }
+
+            ModelInput input;
+            try
+            {
+                if (path == "-")
+                    input.OpenStream(std::cin);
+                else
+                    input.OpenFile(path);
+
+                std::string_view line;
+                while (input.NextLine(line))
+                {
+                    if (ModelFileParsing::Trim(line).empty())
+                        continue;
+                    add(path + ":" + std::to_string(input.LineNumber()), std::string(line));
+                }
+            }
+            catch (const std::exception &e)
+            {
+                failed += SolveBlock(block, results);
+                std::cerr << e.what() << "\n";
+                return 2;
+            }
+        }
+        failed += SolveBlock(block, results);
+        return failed == 0 ? 0 : 1;
+    }
+};
+
+#endif
@@ -0,0 +1,514 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <cctype>
+#include <type_traits>
+
+// Parsed JSON document. Objects keep their members in file order, which is all the command line needs
+// for records of a few dozen fields
+class JsonValue
+{
+public:
+    enum class Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+
+    bool IsNull() const { return type == Type::Null; }
+
+    // nullptr when this is not an object or has no such member
+    const JsonValue *Find(std::string_view key) const
+    {
+        for (const auto &member : members)
+        {
+            if (member.first == key)
+                return &member.second;
+        }
+        return nullptr;
+    }
+
+    double AsNumber(std::string_view what) const
+    {
+        if (type != Type::Number)
+            throw std::runtime_error(std::string(what) + " must be a number.");
+        return number;
+    }
+
+    bool AsBool(std::string_view what) const
+    {
+        if (type != Type::Bool)
+            throw std::runtime_error(std::string(what) + " must be true or false.");
+        return boolean;
+    }
+
+    const std::string &AsString(std::string_view what) const
+    {
+        if (type != Type::String)
+            throw std::runtime_error(std::string(what) + " must be a string.");
+        return text;
+    }
+
+    std::vector<double> AsVector(std::string_view what) const
+    {
+        if (type != Type::Array)
+            throw std::runtime_error(std::string(what) + " must be an array of numbers.");
+        std::vector<double> vec;
+        vec.reserve(items.size());
+        for (const JsonValue &item : items)
+            vec.push_back(item.AsNumber(what));
+        return vec;
+    }
+
+    std::vector<std::vector<double>> AsMatrix(std::string_view what) const
+    {
+        if (type != Type::Array)
+            throw std::runtime_error(std::string(what) + " must be an array of rows.");
+        std::vector<std::vector<double>> mat;
+        mat.reserve(items.size());
+        for (const JsonValue &item : items)
+            mat.push_back(item.AsVector(what));
+        return mat;
+    }
+};
+
+// Recursive descent parser for one JSON text; errors give the byte offset
+class JsonReader
+{
+private:
+    static constexpr int MAX_DEPTH = 256;
+
+    std::string_view text;
+    std::size_t pos = 0;
+
+    [[noreturn]] void Fail(const std::string &message) const
+    {
+        throw std::runtime_error("JSON offset " + std::to_string(pos) + ": " + message);
+    }
+
+    void SkipSpace()
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+            pos++;
+    }
+
+    bool Consume(std::string_view word)
+    {
+        if (text.substr(pos, word.size()) != word)
+            return false;
+        pos += word.size();
+        return true;
+    }
+
+    unsigned ReadHex4()
+    {
+        if (pos + 4 > text.size())
+            Fail("short \\u escape.");
+        unsigned code = 0;
+        auto [end, ec] = std::from_chars(text.data() + pos, text.data() + pos + 4, code, 16);
+        if (ec != std::errc() || end != text.data() + pos + 4)
+            Fail("bad \\u escape.");
+        pos += 4;
+        return code;
+    }
+
+    static void AppendUtf8(std::string &out, unsigned code)
+    {
+        if (code < 0x80)
+        {
+            out += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            out += static_cast<char>(0xc0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            out += static_cast<char>(0xe0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            out += static_cast<char>(0xf0 | (code >> 18));
+            out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            out += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    std::string ParseString()
+    {
+        pos++;
+        std::string out;
+        while (true)
+        {
+            if (pos >= text.size())
+                Fail("unterminated string.");
+            char c = text[pos++];
+            if (c == '"')
+                return out;
+            if (static_cast<unsigned char>(c) < 0x20)
+                Fail("control character in string.");
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+            if (pos >= text.size())
+                Fail("unterminated string.");
+            char escape = text[pos++];
+            switch (escape)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                out += escape;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u':
+            {
+                unsigned code = ReadHex4();
+                if (code >= 0xd800 && code < 0xdc00 && Consume("\\u"))
+                {
+                    unsigned low = ReadHex4();
+                    if (low < 0xdc00 || low >= 0xe000)
+                        Fail("bad surrogate pair.");
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                }
+                AppendUtf8(out, code);
+                break;
+            }
+            default:
+                Fail(std::string("bad escape \\") + escape + ".");
+            }
+        }
+    }
+
+    double ParseNumber()
+    {
+        std::size_t start = pos;
+        if (pos < text.size() && text[pos] == '-')
+            pos++;
+        while (pos < text.size() && (std::isdigit(static_cast<unsigned char>(text[pos])) || text[pos] == '.' || text[pos] == 'e' || text[pos] == 'E' || text[pos] == '+' || text[pos] == '-'))
+            pos++;
+        double value = 0.0;
+        auto [end, ec] = std::from_chars(text.data() + start, text.data() + pos, value);
+        if (ec != std::errc() || end != text.data() + pos || pos == start)
+        {
+            pos = start;
+            Fail("bad number.");
+        }
+        return value;
+    }
+
+    JsonValue ParseValue(int depth)
+    {
+        if (depth > MAX_DEPTH)
+            Fail("nested too deeply.");
+        SkipSpace();
+        if (pos >= text.size())
+            Fail("unexpected end of input.");
+
+        JsonValue value;
+        char c = text[pos];
+        if (c == '{')
+        {
+            value.type = JsonValue::Type::Object;
+            pos++;
+            SkipSpace();
+            if (pos < text.size() && text[pos] == '}')
+            {
+                pos++;
+                return value;
+            }
+            while (true)
+            {
+                SkipSpace();
+                if (pos >= text.size() || text[pos] != '"')
+                    Fail("expected a member name.");
+                std::string key = ParseString();
+                SkipSpace();
+                if (pos >= text.size() || text[pos] != ':')
+                    Fail("expected ':'.");
+                pos++;
+                value.members.emplace_back(std::move(key), ParseValue(depth + 1));
+                SkipSpace();
+                if (pos < text.size() && text[pos] == ',')
+                {
+                    pos++;
+                    continue;
+                }
+                if (pos < text.size() && text[pos] == '}')
+                {
+                    pos++;
+                    return value;
+                }
+                Fail("expected ',' or '}'.");
+            }
+        }
+        if (c == '[')
+        {
+            value.type = JsonValue::Type::Array;
+            pos++;
+            SkipSpace();
+            if (pos < text.size() && text[pos] == ']')
+            {
+                pos++;
+                return value;
+            }
+            while (true)
+            {
+                value.items.push_back(ParseValue(depth + 1));
+                SkipSpace();
+                if (pos < text.size() && text[pos] == ',')
+                {
+                    pos++;
+                    continue;
+                }
+                if (pos < text.size() && text[pos] == ']')
+                {
+                    pos++;
+                    return value;
+                }
+                Fail("expected ',' or ']'.");
+            }
+        }
+        if (c == '"')
+        {
+            value.type = JsonValue::Type::String;
+            value.text = ParseString();
+            return value;
+        }
+        if (Consume("true"))
+        {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = true;
+            return value;
+        }
+        if (Consume("false"))
+        {
+            value.type = JsonValue::Type::Bool;
+            return value;
+        }
+        if (Consume("null"))
+            return value;
+
+        value.type = JsonValue::Type::Number;
+        value.number = ParseNumber();
+        return value;
+    }
+
+public:
+    static JsonValue Parse(std::string_view json)
+    {
+        JsonReader reader;
+        reader.text = json;
+        JsonValue value = reader.ParseValue(0);
+        reader.SkipSpace();
+        if (reader.pos != json.size())
+            reader.Fail("trailing characters.");
+        return value;
+    }
+};
+
+// Builds one JSON object as a single line. Non-finite numbers are written as null since JSON has no
+// spelling for them
+class JsonWriter
+{
+private:
+    std::string out = "{";
+    bool first = true;
+
+    void Key(std::string_view key)
+    {
+        if (!first)
+            out += ',';
+        first = false;
+        AppendString(out, key);
+        out += ':';
+    }
+
+public:
+    static void AppendString(std::string &dest, std::string_view value)
+    {
+        static const char *HEX = "0123456789abcdef";
+        dest += '"';
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                dest += "\\\"";
+                break;
+            case '\\':
+                dest += "\\\\";
+                break;
+            case '\n':
+                dest += "\\n";
+                break;
+            case '\r':
+                dest += "\\r";
+                break;
+            case '\t':
+                dest += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    dest += "\\u00";
+                    dest += HEX[(c >> 4) & 0xf];
+                    dest += HEX[c & 0xf];
+                }
+                else
+                {
+                    dest += c;
+                }
+            }
+        }
+        dest += '"';
+    }
+
+    // shortest text that reads back to the same double
+    static void AppendNumber(std::string &dest, double value)
+    {
+        if (!std::isfinite(value))
+        {
+            dest += "null";
+            return;
+        }
+        char buf[32];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        dest.append(buf, end);
+    }
+
+    static void AppendValue(std::string &dest, const JsonValue &value)
+    {
+        switch (value.type)
+        {
+        case JsonValue::Type::Null:
+            dest += "null";
+            break;
+        case JsonValue::Type::Bool:
+            dest += value.boolean ? "true" : "false";
+            break;
+        case JsonValue::Type::Number:
+            AppendNumber(dest, value.number);
+            break;
+        case JsonValue::Type::String:
+            AppendString(dest, value.text);
+            break;
+        case JsonValue::Type::Array:
+            dest += '[';
+            for (std::size_t i = 0; i < value.items.size(); i++)
+            {
+                if (i > 0)
+                    dest += ',';
+                AppendValue(dest, value.items[i]);
+            }
+            dest += ']';
+            break;
+        case JsonValue::Type::Object:
+            dest += '{';
+            for (std::size_t i = 0; i < value.members.size(); i++)
+            {
+                if (i > 0)
+                    dest += ',';
+                AppendString(dest, value.members[i].first);
+                dest += ':';
+                AppendValue(dest, value.members[i].second);
+            }
+            dest += '}';
+            break;
+        }
+    }
+
+    void Field(std::string_view key, std::string_view value)
+    {
+        Key(key);
+        AppendString(out, value);
+    }
+
+    void Field(std::string_view key, const char *value) { Field(key, std::string_view(value)); }
+
+    void Field(std::string_view key, double value)
+    {
+        Key(key);
+        AppendNumber(out, value);
+    }
+
+    void Field(std::string_view key, bool value)
+    {
+        Key(key);
+        out += value ? "true" : "false";
+    }
+
+    void Field(std::string_view key, const JsonValue &value)
+    {
+        Key(key);
+        AppendValue(out, value);
+    }
+
+    template <typename T>
+    static void AppendArray(std::string &dest, const std::vector<T> &values)
+    {
+        dest += '[';
+        for (std::size_t i = 0; i < values.size(); i++)
+        {
+            if (i > 0)
+                dest += ',';
+            if constexpr (std::is_same_v<T, std::string>)
+                AppendString(dest, values[i]);
+            else if constexpr (std::is_arithmetic_v<T>)
+                AppendNumber(dest, static_cast<double>(values[i]));
+            else
+                AppendArray(dest, values[i]);
+        }
+        dest += ']';
+    }
+
+    template <typename T>
+    void Field(std::string_view key, const std::vector<T> &values)
+    {
+        Key(key);
+        AppendArray(out, values);
+    }
+
+    std::string Finish()
+    {
+        out += '}';
+        return std::move(out);
+    }
+};
@@ -8,11 +8,14 @@
 #include <numeric>
 #include <algorithm>
 #include "dual_simplex.hpp"
+#include "batch_solver.hpp"
 
 class DEASolver
 {
 private:
     DualSimplex dual;
+    bool batchSolve = false;
+    BatchSolver batchSolver;
     bool isConsoleOutput;
     int testInputSelected;
     int amtOfItems;
@@ -37,6 +40,7 @@ public:
     DEASolver(bool consoleOutput = false) : isConsoleOutput(consoleOutput)
     {
         dual = DualSimplex();
+        dual.SetHistoryMode(TableauHistory::FinalOnly);
         testInputSelected = -1;
         amtOfItems = 1;
         amtOfOutputs = 1;
@@ -59,6 +63,15 @@ public:
         outputStream.clear(); // Ensure the stream is in a good state
     }
 
+    void SetSimplexEngine(SimplexEngine engine) { dual.SetEngine(engine); }
+
+    // solves every unit's LP up front on the batch pool; the output is the same as the serial run
+    void SetBatchSolve(bool enable, std::size_t threadCount = 0)
+    {
+        batchSolve = enable;
+        batchSolver.SetThreadCount(threadCount);
+    }
+
     std::pair<std::vector<std::vector<double>>, std::vector<std::vector<double>>>
     testInput(int testNum = -1)
     {
@@ -206,7 +219,11 @@ public:
 
     SolveResult solveTable(const std::vector<std::vector<double>> &table, const std::vector<double> &objfunc, const std::vector<std::vector<double>> &constraints, const std::vector<double> &conRow, bool isMin = false)
     {
-        auto result = dual.DoDualSimplex(objfunc, constraints, isMin);
+        return summarizeSolve(dual.DoDualSimplex(objfunc, constraints, isMin), objfunc, constraints, conRow);
+    }
+
+    SolveResult summarizeSolve(const DualSimplex::DoDualSimplexResult &result, const std::vector<double> &objfunc, const std::vector<std::vector<double>> &constraints, const std::vector<double> &conRow)
+    {
         auto changingVars = result.changingVars;
         double optimalSolution = result.optimalSolution;
 
@@ -304,11 +321,28 @@ public:
         std::vector<double> allInputTotals;
         std::vector<std::vector<double>> allChangingVars;
 
+        std::vector<BatchSolver::BatchSolveResult> batchResults;
+        if (batchSolve)
+        {
+            std::vector<BatchLP> problems;
+            for (int i = 0; i < LpInputs.size(); ++i)
+            {
+                auto tableResult = buildTable(LpInputs, LpOutputs, i);
+                problems.push_back({SparseLPModel::FromDense(tableResult.zRow, tableResult.constraints), isMin});
+            }
+            SimplexEngine engine = dual.GetEngine();
+            batchSolver.SetConfigure([engine](DualSimplex &solver)
+                                     { solver.SetEngine(engine); });
+            batchResults = batchSolver.SolveBatch(problems);
+        }
+
         for (int i = 0; i < LpInputs.size(); ++i)
         {
             auto tableResult = buildTable(LpInputs, LpOutputs, i);
-            auto solveResult = solveTable(tableResult.table, tableResult.zRow,
-                                          tableResult.constraints, tableResult.conRow, isMin);
+            auto solveResult = batchSolve
+                                   ? summarizeSolve(batchResults[i].result, tableResult.zRow, tableResult.constraints, tableResult.conRow)
+                                   : solveTable(tableResult.table, tableResult.zRow,
+                                                tableResult.constraints, tableResult.conRow, isMin);
 
             allRangesO.push_back(solveResult.outputRange);
             allRangesI.push_back(solveResult.inputRange);
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <cstddef>
+
+#include "lp_model.hpp"
+#include "dual_simplex.hpp"
+#include "thread_pool.hpp"
+
+struct BatchLP
+{
+    SparseLPModel model;
+    bool isMin = false;
+};
+
+// OverMemoryBudget solves were skipped because neither engine's estimate fit the budget
+enum class BatchSolveStatus
+{
+    Optimal,
+    NoSolution,
+    OverMemoryBudget,
+    Failed
+};
+
+// Solves independent LPs concurrently, each on its own DualSimplex. Items are split over a
+// work-stealing pool so a few large models do not hold up the small ones, and results come back
+// in input order. Solves default to FinalOnly history since nobody steps through a batch.
+class BatchSolver
+{
+private:
+    std::size_t threadCount = 0;
+    std::size_t memoryBudget = 0;
+    std::size_t grainSize = 1;
+    std::function<void(DualSimplex &)> configure;
+    std::unique_ptr<ThreadPool> pool;
+
+    ThreadPool &Pool()
+    {
+        if (threadCount == 0)
+            return ThreadPool::Shared();
+        if (!pool || pool->Size() != threadCount)
+            pool = std::make_unique<ThreadPool>(threadCount);
+        return *pool;
+    }
+
+public:
+    struct BatchSolveResult
+    {
+        BatchSolveStatus status = BatchSolveStatus::Failed;
+        DualSimplex::DoDualSimplexResult result;
+        std::string error;
+    };
+
+    // 0 uses the shared pool sized to the machine
+    void SetThreadCount(std::size_t count) { threadCount = count; }
+    std::size_t GetThreadCount() const { return threadCount; }
+
+    // bytes one solve may hold, 0 for no limit; see EstimateMemory
+    void SetMemoryBudget(std::size_t bytes) { memoryBudget = bytes; }
+    std::size_t GetMemoryBudget() const { return memoryBudget; }
+
+    // smallest run of models a thread takes at once; larger grains cut scheduling cost for tiny LPs
+    void SetGrainSize(std::size_t grain) { grainSize = grain; }
+
+    // called on every solver before its solve, e.g. to pick the engine or turn on presolve
+    void SetConfigure(std::function<void(DualSimplex &)> configureSolver) { configure = std::move(configureSolver); }
+
+    // rough peak bytes of one FinalOnly solve: the dense path holds the formulation, the working and
+    // previous tableaus and the returned copy, the revised path an LU sized basis plus the final
+    // tableau and its copy; the interior point path is counted the same, its normal matrix standing in
+    // for the LU. Full history keeps a tableau per pivot on top of this
+    static std::size_t EstimateMemory(const SparseLPModel &model, SimplexEngine engine)
+    {
+        std::size_t rows = static_cast<std::size_t>(model.numRows) + 1;
+        std::size_t cols = static_cast<std::size_t>(model.numCols + model.numRows) + 1;
+        std::size_t tableau = rows * cols * sizeof(double);
+        std::size_t modelBytes = model.values.size() * (sizeof(double) + sizeof(int)) + cols * sizeof(double);
+        if (engine == SimplexEngine::Dense)
+            return 4 * tableau + modelBytes;
+        std::size_t basis = static_cast<std::size_t>(model.numRows) * model.numRows * sizeof(double);
+        return 2 * tableau + 2 * basis + modelBytes;
+    }
+
+    std::vector<BatchSolveResult> SolveBatch(const std::vector<BatchLP> &problems)
+    {
+        std::vector<BatchSolveResult> results(problems.size());
+
+        Pool().ForEach(0, problems.size(), [&](std::size_t i)
+                       {
+                           BatchSolveResult &res = results[i];
+                           try
+                           {
+                               DualSimplex solver;
+                               solver.SetHistoryMode(TableauHistory::FinalOnly);
+                               if (configure)
+                                   configure(solver);
+
+                               // over budget on the dense path, the revised engine is tried before giving up
+                               if (memoryBudget != 0 && EstimateMemory(problems[i].model, solver.GetEngine()) > memoryBudget)
+                               {
+                                   if (EstimateMemory(problems[i].model, SimplexEngine::Revised) > memoryBudget)
+                                   {
+                                       res.status = BatchSolveStatus::OverMemoryBudget;
+                                       return;
+                                   }
+                                   solver.SetEngine(SimplexEngine::Revised);
+                               }
+
+                               res.result = solver.DoDualSimplex(problems[i].model, problems[i].isMin);
+                               res.status = std::isnan(res.result.optimalSolution) ? BatchSolveStatus::NoSolution : BatchSolveStatus::Optimal;
+                           }
+                           catch (const std::exception &e)
+                           {
+                               res.status = BatchSolveStatus::Failed;
+                               res.error = e.what();
+                           } },
+                       grainSize);
+
+        return results;
+    }
+
+    std::vector<BatchSolveResult> SolveBatch(const std::vector<SparseLPModel> &models, bool isMin)
+    {
+        std::vector<BatchLP> problems;
+        problems.reserve(models.size());
+        for (const auto &model : models)
+            problems.push_back({model, isMin});
+        return SolveBatch(problems);
+    }
+};
@@ -3,7 +3,6 @@
 
 #include <vector>
 #include <string>
-#include <stack>
 #include <map>
 #include <cmath>
 #include <iostream>
@@ -13,8 +12,16 @@
 #include <memory>
 #include <sstream>
 #include <fstream>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
 
 #include "dual_simplex.hpp"
+#include "node_queue.hpp"
+#include "thread_pool.hpp"
 
 class Logger
 {
@@ -37,6 +44,49 @@ enum class VariableSignType
     Unrestricted
 };
 
+// ConstraintRows adds a row and a slack for every branch; BoundChanges only tightens the bounds of
+// the branching variable, so every node LP keeps the size of the root LP
+enum class BranchingMode
+{
+    ConstraintRows,
+    BoundChanges
+};
+
+// How open nodes of the bound-change search keep their LP. FullTableau keeps each solved tableau,
+// BranchDiffs keeps only the bound change against the parent plus the solved basis and rebuilds the
+// tableau from the root one when the node is processed, trading one refactorization per node for memory
+enum class NodeStorage
+{
+    FullTableau,
+    BranchDiffs
+};
+
+// why a branch and bound search ended; anything but Completed leaves open nodes unexplored
+enum class SearchStop
+{
+    Completed,
+    NodeLimit,
+    TimeLimit,
+    GapLimit,
+    FirstIncumbent
+};
+
+// Which node tableaus a search keeps for its tree. Full keeps the unfixed, fixed, intermediate and
+// final tableau of every node, FinalOnly just the final one and None none of them
+enum class TableauRendering
+{
+    None,
+    FinalOnly,
+    Full
+};
+
+// numeric copy of a tableau shown for a node; it is only turned into text when the tree is written out
+struct TableauSnapshot
+{
+    std::string title;
+    std::vector<std::vector<double>> values;
+};
+
 struct TreeNode
 {
     std::string name;
@@ -47,22 +97,55 @@ struct TreeNode
     bool pruned = false;
     std::vector<std::string> constraintsPath;
     std::vector<std::unique_ptr<TreeNode>> children;
-    std::string unfixedTabStr = "";
-    std::string fixedTabStr = "";
-    std::string finalTableauStr = "";
-    std::vector<std::string> intermediateTableausStr = {};
+    TableauSnapshot unfixedTab;
+    TableauSnapshot fixedTab;
+    TableauSnapshot finalTableau;
+    std::vector<TableauSnapshot> intermediateTableaus = {};
     std::vector<int> pivotCols = {};
     std::vector<int> pivotRows = {};
 };
 
-class BranchAndBound
+// Scalar is what the dense node relaxations are pivoted in, as for BasicDualSimplex. Node tableaus
+// are kept and rounded in double; bound-change branching reoptimizes double bounded tableaus, so it
+// needs the double solver
+template <typename Scalar>
+class BasicBranchAndBound
 {
+public:
+    // 0 turns a limit off. The node limit counts processed nodes and keeps the old cap of 100 by
+    // default; the gaps compare the incumbent with the best bound left among the open nodes
+    struct SearchLimits
+    {
+        int nodeLimit = 100;
+        double timeLimit = 0.0; // seconds
+        double absoluteGap = 0.0;
+        double relativeGap = 0.0; // fraction of the incumbent objective
+        bool stopAtFirstIncumbent = false;
+    };
+
+    // bestBound is the best objective any integer solution can still have; it equals the incumbent
+    // once the search is complete
+    struct SearchResult
+    {
+        SearchStop stop = SearchStop::Completed;
+        std::optional<double> incumbent;
+        double bestBound = 0.0;
+        double gap = 0.0;
+        int nodes = 0;
+        double seconds = 0.0;
+    };
+
 private:
     bool isConsoleOutput = false;
     int precision = 4;
     double tolerance = 1e-6;
+    // tableaus are rounded to precision decimals after every step, so an integral value can drift a few
+    // units in the last place; branching on that drift loses the integer point
+    double integralityTolerance = 1e-3;
+
+    using Solver = BasicDualSimplex<Scalar>;
 
-    DualSimplex dual;
+    Solver dual;
     std::vector<double> objFunc = {0.0, 0.0};
     std::vector<std::vector<double>> constraints = {{0.0, 0.0, 0.0, 0.0}};
     std::vector<std::vector<std::vector<double>>> newTableaus;
@@ -74,11 +157,98 @@ private:
     int nodeCounter = 0;
     std::vector<std::pair<std::vector<double>, double>> allSolutions;
     bool enablePruning = false;
+    bool pruning = false;
+    BranchingMode branchingMode = BranchingMode::ConstraintRows;
+    NodeSelection nodeSelection = NodeSelection::DepthFirst;
+    NodeStorage nodeStorage = NodeStorage::FullTableau;
+    TableauRendering tableauRendering = TableauRendering::Full;
 
     std::string bestSolutionNodeNum;
     std::vector<std::vector<double>> bestSolutionTableau;
     std::vector<std::vector<std::vector<double>>> displayTableausMin;
 
+    SearchLimits limits;
+    SearchResult lastResult;
+    SearchStop searchStop = SearchStop::Completed;
+    std::chrono::steady_clock::time_point searchStart;
+
+    // parallel search; see SetThreadCount and SetDeterministic
+    std::size_t threadCount = 1;
+    bool deterministic = false;
+    std::size_t deterministicBatch = 32;
+    std::unique_ptr<ThreadPool> pool;
+
+    // searchMutex guards the incumbent and the shared lists; the atomics mirror the incumbent so
+    // workers can prune without taking the lock
+    std::mutex searchMutex;
+    std::atomic<bool> haveIncumbent{false};
+    std::atomic<double> incumbentObjective{0.0};
+
+    // the bound changes from the root to a node, shared between siblings
+    struct BoundStep
+    {
+        std::shared_ptr<const BoundStep> parent;
+        int variable;
+        double lower;
+        double upper;
+    };
+
+    // tabs only holds the node's final tableau, the helpers never look further back
+    struct DenseNode
+    {
+        std::vector<std::vector<std::vector<double>>> tabs;
+        int depth;
+        std::string nodeLabel;
+        std::vector<std::string> constraintsPath;
+        std::string parentLabel;
+        TreeNode *treeNode;
+    };
+
+    // with BranchDiffs state is empty until the node is processed; the queue keys are kept so an
+    // open node never needs its tableau
+    struct BoundedNode
+    {
+        BoundedTableau state;
+        int depth;
+        std::string nodeLabel;
+        std::vector<std::string> constraintsPath;
+        TreeNode *treeNode;
+        double bound;
+        double estimate;
+        std::shared_ptr<const BoundStep> path = nullptr;
+        std::vector<int> basis = {};
+        std::vector<char> atUpper = {};
+    };
+
+    // solved root LP the BranchDiffs nodes are rebuilt from
+    BoundedTableau boundedRoot;
+
+    // integer solution found by a node of a deterministic round, applied once the round is over
+    struct IncumbentCandidate
+    {
+        std::vector<double> solution;
+        double objective;
+        std::vector<std::vector<double>> tableau;
+        std::string nodeLabel;
+    };
+
+    // the shared pool can run a queued worker loop inside a nested ParallelFor wait, which would then
+    // wait on the node below it, so the search always gets a pool of its own
+    ThreadPool &Pool()
+    {
+        std::size_t size = searchThreads();
+        if (!pool || pool->Size() != size)
+            pool = std::make_unique<ThreadPool>(size);
+        return *pool;
+    }
+
+    std::size_t searchThreads() const
+    {
+        if (isConsoleOutput)
+            return 1;
+        return threadCount == 0 ? std::max<std::size_t>(1, std::thread::hardware_concurrency()) : threadCount;
+    }
+
     std::string escapeJson(const std::string &s) const
     {
         std::ostringstream o;
@@ -122,7 +292,7 @@ private:
     }
 
 public:
-    BranchAndBound(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput)
+    BasicBranchAndBound(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput)
     {
         objFunc = {0.0, 0.0};
         constraints = {{0.0, 0.0, 0.0, 0.0}};
@@ -130,7 +300,66 @@ public:
                               : -std::numeric_limits<double>::infinity();
     }
 
-    double roundValue(double value)
+    void SetSimplexEngine(SimplexEngine engine) { dual.SetEngine(engine); }
+
+    void SetBranchingMode(BranchingMode mode) { branchingMode = mode; }
+    BranchingMode GetBranchingMode() const { return branchingMode; }
+
+    // the selection rule only changes the tree when pruning is on; without it every node is explored
+    void SetNodeSelection(NodeSelection selection) { nodeSelection = selection; }
+    NodeSelection GetNodeSelection() const { return nodeSelection; }
+
+    // how open bound-change nodes keep their LP; the default keeps one solved tableau per node
+    void SetNodeStorage(NodeStorage storage) { nodeStorage = storage; }
+    NodeStorage GetNodeStorage() const { return nodeStorage; }
+
+    // how much of every node's tableaus the JSON tree shows; less skips copying them during the search
+    void SetTableauRendering(TableauRendering rendering) { tableauRendering = rendering; }
+    TableauRendering GetTableauRendering() const { return tableauRendering; }
+
+    // off by default so the whole tree is shown; on, nodes no better than the incumbent are cut
+    void SetPruning(bool enable) { pruning = enable; }
+    bool GetPruning() const { return pruning; }
+
+    // nodes processed at once, 1 by default; 0 uses every core. Console output always runs on one
+    // thread so the log stays readable. Without deterministic mode workers keep their own node queues
+    // and steal when theirs run dry, so which nodes get pruned can change from run to run
+    void SetThreadCount(std::size_t count) { threadCount = count; }
+    std::size_t GetThreadCount() const { return threadCount; }
+
+    // processes the tree in rounds of batchSize nodes taken in selection order, and only shares
+    // incumbents found in a round once it is over, so the tree is the same for any thread count
+    void SetDeterministic(bool enable, std::size_t batchSize = 32)
+    {
+        deterministic = enable;
+        deterministicBatch = std::max<std::size_t>(1, batchSize);
+    }
+    bool GetDeterministic() const { return deterministic; }
+
+    void SetLimits(const SearchLimits &searchLimits) { limits = searchLimits; }
+    const SearchLimits &GetLimits() const { return limits; }
+
+    // how the last RunBranchAndBound ended
+    const SearchResult &GetLastResult() const { return lastResult; }
+
+    static std::string SearchStopName(SearchStop stop)
+    {
+        switch (stop)
+        {
+        case SearchStop::NodeLimit:
+            return "node limit";
+        case SearchStop::TimeLimit:
+            return "time limit";
+        case SearchStop::GapLimit:
+            return "gap limit";
+        case SearchStop::FirstIncumbent:
+            return "first incumbent";
+        default:
+            return "completed search";
+        }
+    }
+
+    double roundValue(double value) const
     {
         try
         {
@@ -187,14 +416,25 @@ public:
         return roundedTableaus;
     }
 
+    void roundTableau(Tableau &tableau)
+    {
+        for (size_t i = 0; i < tableau.Rows(); ++i)
+        {
+            for (double &val : tableau.Row(i))
+            {
+                val = roundValue(val);
+            }
+        }
+    }
+
     bool isIntegerValue(double value)
     {
         double roundedVal = roundValue(value);
-        return std::abs(roundedVal - std::round(roundedVal)) <= tolerance;
+        return std::abs(roundedVal - std::round(roundedVal)) <= integralityTolerance;
     }
 
     std::string getTableauString(const std::vector<std::vector<double>> &tableau,
-                                 const std::string &title = "Tableau")
+                                 const std::string &title = "Tableau") const
     {
         std::ostringstream oss;
         std::vector<std::string> tempHeaderStr;
@@ -237,21 +477,33 @@ public:
         }
     }
 
+    // copies a tableau into a tree node when the rendering level shows that kind of tableau
+    void keepTableau(TableauSnapshot &slot, const std::vector<std::vector<double>> &tableau, const std::string &title)
+    {
+        if (tableauRendering == TableauRendering::Full)
+            slot = {title, tableau};
+    }
+
+    void keepIntermediateTableau(TreeNode &node, const std::vector<std::vector<double>> &tableau, const std::string &title)
+    {
+        if (tableauRendering == TableauRendering::Full)
+            node.intermediateTableaus.push_back({title, tableau});
+    }
+
+    void keepFinalTableau(TreeNode &node, const std::vector<std::vector<double>> &tableau, const std::string &title)
+    {
+        if (tableauRendering != TableauRendering::None)
+            node.finalTableau = {title, tableau};
+    }
+
     std::vector<int> getBasicVarSpots(const std::vector<std::vector<std::vector<double>>> &tableaus)
     {
         std::vector<int> basicVarSpots;
         const auto &lastTableau = tableaus[tableaus.size() - 1];
 
-        for (size_t k = 0; k < lastTableau[lastTableau.size() - 1].size(); ++k)
+        for (size_t k = 0; k + 1 < lastTableau[lastTableau.size() - 1].size(); ++k)
         {
-            std::vector<double> tCVars;
-            for (size_t i = 0; i < lastTableau.size(); ++i)
-            {
-                tCVars.push_back(roundValue(lastTableau[i][k]));
-            }
-
-            double sumVals = roundValue(std::accumulate(tCVars.begin(), tCVars.end(), 0.0));
-            if (std::abs(sumVals - 1.0) <= tolerance)
+            if (basicRow(lastTableau, k))
             {
                 basicVarSpots.push_back(k);
             }
@@ -315,16 +567,13 @@ public:
             return {{}, {}};
         }
 
-        auto newTab = changingTable;
+        Tableau newTab(changingTable, addedConstraints.size());
 
         for (size_t k = 0; k < addedConstraints.size(); ++k)
         {
-            for (auto &row : newTab)
-            {
-                row.insert(row.end() - 1, 0.0);
-            }
+            newTab.InsertColumnBeforeRhs(0.0);
 
-            std::vector<double> newCon(newTab[0].size(), 0.0);
+            std::vector<double> newCon(newTab.Cols(), 0.0);
             for (size_t i = 0; i < addedConstraints[k].size() - 2; ++i)
             {
                 newCon[i] = roundValue(addedConstraints[k][i]);
@@ -333,28 +582,28 @@ public:
             int slackSpot = (newCon.size() - addedConstraints.size()) - 1 + k;
             newCon[slackSpot] = addedConstraints[k][addedConstraints[k].size() - 1] == 1 ? -1.0 : 1.0;
 
-            newTab.push_back(newCon);
+            newTab.AppendRow(newCon);
         }
 
-        newTab = roundMatrix(newTab);
-        printTableau(newTab, "unfixed tab");
+        roundTableau(newTab);
+        printTableau(newTab.ToVectors(), "unfixed tab");
 
-        auto displayTab = newTab;
+        Tableau displayTab = newTab;
 
         for (size_t k = 0; k < addedConstraints.size(); ++k)
         {
-            size_t constraintRowIndex = newTab.size() - addedConstraints.size() + k;
+            size_t constraintRowIndex = newTab.Rows() - addedConstraints.size() + k;
 
             for (int colIndex : basicVarSpots)
             {
-                double coefficientInNewRow = roundValue(displayTab[constraintRowIndex][colIndex]);
+                double coefficientInNewRow = roundValue(displayTab(constraintRowIndex, colIndex));
 
                 if (std::abs(coefficientInNewRow) > tolerance)
                 {
                     std::optional<size_t> pivotRow;
-                    for (size_t rowIndex = 0; rowIndex < displayTab.size() - addedConstraints.size(); ++rowIndex)
+                    for (size_t rowIndex = 0; rowIndex < displayTab.Rows() - addedConstraints.size(); ++rowIndex)
                     {
-                        if (std::abs(roundValue(displayTab[rowIndex][colIndex]) - 1.0) <= tolerance)
+                        if (std::abs(roundValue(displayTab(rowIndex, colIndex)) - 1.0) <= tolerance)
                         {
                             pivotRow = rowIndex;
                             break;
@@ -364,50 +613,40 @@ public:
                     if (pivotRow)
                     {
                         bool autoReverse = addedConstraints[k][addedConstraints[k].size() - 1] == 1;
-                        for (size_t col = 0; col < displayTab[0].size(); ++col)
+                        auto basicRow = displayTab.Row(*pivotRow);
+                        auto constraintRow = displayTab.Row(constraintRowIndex);
+                        for (size_t col = 0; col < displayTab.Cols(); ++col)
                         {
-                            double pivotVal = roundValue(displayTab[*pivotRow][col]);
-                            double constraintVal = roundValue(displayTab[constraintRowIndex][col]);
+                            double pivotVal = roundValue(basicRow[col]);
+                            double constraintVal = roundValue(constraintRow[col]);
                             double newVal = autoReverse ? pivotVal - coefficientInNewRow * constraintVal
                                                         : constraintVal - coefficientInNewRow * pivotVal;
-                            displayTab[constraintRowIndex][col] = roundValue(newVal);
+                            constraintRow[col] = roundValue(newVal);
                         }
                     }
                 }
             }
         }
 
-        displayTab = roundMatrix(displayTab);
-        printTableau(displayTab, "fixed tab");
+        roundTableau(displayTab);
+        auto displayRows = displayTab.ToVectors();
+        printTableau(displayRows, "fixed tab");
 
-        return {displayTab, newTab};
+        return {displayRows, newTab.ToVectors()};
     }
 
     std::pair<std::optional<int>, std::optional<double>>
     testIfBasicVarIsInt(const std::vector<std::vector<std::vector<double>>> &tabs)
     {
-        std::vector<double> decisionVars;
-        const auto &lastTableau = tabs[tabs.size() - 1];
-
-        for (size_t i = 0; i < objFunc.size(); ++i)
-        {
-            bool found = false;
-            for (size_t j = 0; j < lastTableau.size(); ++j)
-            {
-                double val = roundValue(lastTableau[j][i]);
-                if (std::abs(val - 1.0) <= tolerance)
-                {
-                    decisionVars.push_back(roundValue(lastTableau[j][lastTableau[j].size() - 1]));
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-            {
-                decisionVars.push_back(0.0);
-            }
-        }
+        return pickBranchVar(getCurrentSolution(tabs));
+    }
 
+    // the fractional variable closest to .5 is branched on. When every value is within the integrality
+    // tolerance but the rounded point breaks a constraint, the drift was a real fraction and the value
+    // farthest from an integer is branched on instead
+    std::pair<std::optional<int>, std::optional<double>>
+    pickBranchVar(const std::vector<double> &decisionVars)
+    {
         int bestXSpot = -1;
         std::optional<double> bestRhsVal;
         double minDistanceToHalf = std::numeric_limits<double>::infinity();
@@ -427,6 +666,21 @@ public:
             }
         }
 
+        if (bestXSpot == -1 && !roundsFeasibly(decisionVars))
+        {
+            double maxDrift = 0.0;
+            for (size_t i = 0; i < decisionVars.size(); ++i)
+            {
+                double drift = std::abs(decisionVars[i] - std::round(decisionVars[i]));
+                if (drift > maxDrift)
+                {
+                    maxDrift = drift;
+                    bestXSpot = i;
+                    bestRhsVal = decisionVars[i];
+                }
+            }
+        }
+
         return bestXSpot == -1 ? std::make_pair(std::optional<int>(std::nullopt), std::optional<double>(std::nullopt))
                                : std::make_pair(bestXSpot, bestRhsVal);
     }
@@ -469,26 +723,59 @@ public:
         return roundValue(tabs[tabs.size() - 1][0][tabs[tabs.size() - 1][0].size() - 1]);
     }
 
+    // row a column is basic in: a 1 there and 0 in every other row, the objective row included. A
+    // nonbasic column can still hold a 1, so the first 1 alone is not enough
+    std::optional<size_t> basicRow(const std::vector<std::vector<double>> &tableau, size_t col)
+    {
+        std::optional<size_t> row;
+        for (size_t j = 0; j < tableau.size(); ++j)
+        {
+            double val = roundValue(tableau[j][col]);
+            if (std::abs(val - 1.0) <= tolerance && !row && j > 0)
+                row = j;
+            else if (std::abs(val) > tolerance)
+                return std::nullopt;
+        }
+        return row;
+    }
+
+    // identical columns are unit columns of the same row and stand for the same basis, so the first one
+    // takes the row's value and the others stay at zero
     std::vector<double> getCurrentSolution(const std::vector<std::vector<std::vector<double>>> &tabs)
     {
         std::vector<double> solution(objFunc.size(), 0.0);
         const auto &lastTableau = tabs[tabs.size() - 1];
+        std::vector<bool> rowTaken(lastTableau.size(), false);
 
         for (size_t i = 0; i < objFunc.size(); ++i)
         {
-            for (size_t j = 0; j < lastTableau.size(); ++j)
+            auto row = basicRow(lastTableau, i);
+            if (row && !rowTaken[*row])
             {
-                double val = roundValue(lastTableau[j][i]);
-                if (std::abs(val - 1.0) <= tolerance)
-                {
-                    solution[i] = roundValue(lastTableau[j][lastTableau[j].size() - 1]);
-                    break;
-                }
+                rowTaken[*row] = true;
+                solution[i] = roundValue(lastTableau[*row][lastTableau[*row].size() - 1]);
             }
         }
         return solution;
     }
 
+    // whether the solution rounded to the integers still satisfies the original constraints
+    bool roundsFeasibly(const std::vector<double> &solution) const
+    {
+        for (const auto &row : constraints)
+        {
+            double lhs = 0.0;
+            for (size_t i = 0; i < solution.size() && i + 2 < row.size(); ++i)
+                lhs += row[i] * std::round(solution[i]);
+            double rhs = row[row.size() - 2];
+            double slack = tolerance * (1.0 + std::abs(rhs));
+            int sense = static_cast<int>(row[row.size() - 1]);
+            if ((sense != 1 && lhs > rhs + slack) || (sense != 0 && lhs < rhs - slack))
+                return false;
+        }
+        return true;
+    }
+
     bool isIntegerSolution(const std::vector<double> &solution)
     {
         for (double val : solution)
@@ -498,30 +785,44 @@ public:
                 return false;
             }
         }
-        return true;
+        return roundsFeasibly(solution);
     }
 
     bool updateBestSolution(const std::vector<std::vector<std::vector<double>>> &tabs,
                             const std::string &nodeLabel = "")
     {
         auto objVal = getObjectiveValue(tabs);
-        auto solution = getCurrentSolution(tabs);
-
         if (!objVal)
             return false;
 
+        return updateBestSolution(getCurrentSolution(tabs), *objVal, tabs[tabs.size() - 1], nodeLabel);
+    }
+
+    // an integer solution is snapped to the integers and costed from the objective, so the rounding drift
+    // of its tableau does not end up in the incumbent
+    bool updateBestSolution(std::vector<double> solution, double objVal,
+                            const std::vector<std::vector<double>> &tableau, const std::string &nodeLabel)
+    {
         if (isIntegerSolution(solution))
         {
-            allSolutions.push_back({solution, *objVal});
+            objVal = 0.0;
+            for (size_t i = 0; i < solution.size(); ++i)
+            {
+                solution[i] = std::round(solution[i]) + 0.0;
+                objVal += objFunc[i] * solution[i];
+            }
+            allSolutions.push_back({solution, objVal});
 
-            bool isBetter = isMin ? *objVal < bestObjective : *objVal > bestObjective;
+            bool isBetter = isMin ? objVal < bestObjective : objVal > bestObjective;
 
             if (isBetter)
             {
-                bestObjective = *objVal;
+                bestObjective = objVal;
                 bestSolution = solution;
-                bestSolutionTableau = tabs[tabs.size() - 1];
+                bestSolutionTableau = tableau;
                 bestSolutionNodeNum = nodeLabel;
+                incumbentObjective.store(objVal);
+                haveIncumbent.store(true);
 
                 if (isConsoleOutput)
                 {
@@ -534,7 +835,7 @@ public:
                     }
                     solStr += "]";
                     Logger::writeLine("New best integer solution Candidate found: " +
-                                      solStr + " with objective " + std::to_string(*objVal));
+                                      solStr + " with objective " + std::to_string(objVal));
                 }
                 return true;
             }
@@ -549,454 +850,586 @@ public:
                 }
                 solStr += "]";
                 Logger::writeLine("Integer solution Candidate found: " + solStr +
-                                  " with objective " + std::to_string(*objVal) +
+                                  " with objective " + std::to_string(objVal) +
                                   " (not better than current best)");
             }
         }
         return false;
     }
 
-    bool shouldPrune(const std::vector<std::vector<std::vector<double>>> &tabs)
+    // with deferred set the solution waits for the end of the deterministic round, otherwise it is
+    // checked against the incumbent straight away
+    void offerIncumbent(const std::vector<double> &solution, double objVal,
+                        const std::vector<std::vector<double>> &tableau, const std::string &nodeLabel,
+                        std::vector<IncumbentCandidate> *deferred)
     {
-        if (!enablePruning)
-            return false;
+        if (!isIntegerSolution(solution))
+            return;
+
+        if (deferred)
+        {
+            deferred->push_back({solution, objVal, tableau, nodeLabel});
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(searchMutex);
+        updateBestSolution(solution, objVal, tableau, nodeLabel);
+    }
 
+    void offerIncumbent(const std::vector<std::vector<std::vector<double>>> &tabs, const std::string &nodeLabel,
+                        std::vector<IncumbentCandidate> *deferred)
+    {
         auto objVal = getObjectiveValue(tabs);
         if (!objVal)
-            return true;
+            return;
 
-        if (!bestSolution.empty())
-        {
-            return isMin ? *objVal >= bestObjective : *objVal <= bestObjective;
-        }
-        return false;
+        offerIncumbent(getCurrentSolution(tabs), *objVal, tabs[tabs.size() - 1], nodeLabel, deferred);
     }
 
-    std::string toJson(const TreeNode *node) const
+    void recordDisplayTableau(const std::vector<std::vector<double>> &tableau)
     {
-        std::string json = "{";
-        json += "\"name\":\"" + node->name + "\",";
-        json += "\"objective\":" + (node->objective.has_value() ? std::to_string((node->objective.value())) : "null") + ",";
-        json += "\"solution\":";
-        if (node->solution.empty() && node->infeasible)
+        std::lock_guard<std::mutex> lock(searchMutex);
+        displayTableausMin.push_back(tableau);
+    }
+
+    // queue keys of an open node; a node without an objective yet sorts as the best
+    double nodeBound(const TreeNode &node) const
+    {
+        if (!node.objective)
+            return isMin ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        return *node.objective;
+    }
+
+    // the LP objective worsened by every fractional variable's distance to an integer, weighted by its cost
+    double nodeEstimate(double bound, const std::vector<double> &solution) const
+    {
+        double degradation = 0.0;
+        for (size_t i = 0; i < solution.size() && i < objFunc.size(); ++i)
         {
-            json += "null,";
+            double fraction = solution[i] - std::floor(solution[i]);
+            degradation += std::min(fraction, 1.0 - fraction) * std::abs(objFunc[i]);
         }
-        else
+        return isMin ? bound + degradation : bound - degradation;
+    }
+
+    double nodeEstimate(const TreeNode &node) const { return nodeEstimate(nodeBound(node), node.solution); }
+
+    std::pair<double, double> nodeKeys(const DenseNode &node) const
+    {
+        return {nodeBound(*node.treeNode), nodeEstimate(*node.treeNode)};
+    }
+
+    std::pair<double, double> nodeKeys(const BoundedNode &node) const { return {node.bound, node.estimate}; }
+
+    static void swapRows(Tableau &tab, std::size_t a, std::size_t b)
+    {
+        if (a == b)
+            return;
+        auto rowA = tab.Row(a);
+        auto rowB = tab.Row(b);
+        std::swap_ranges(rowA.begin(), rowA.end(), rowB.begin());
+    }
+
+    static void pivotOn(Tableau &tab, std::size_t row, std::size_t col)
+    {
+        double pivot = tab(row, col);
+        for (double &val : tab.Row(row))
+            val /= pivot;
+        for (std::size_t i = 0; i < tab.Rows(); ++i)
         {
-            json += "[";
-            for (size_t i = 0; i < node->solution.size(); ++i)
-            {
-                json += std::to_string((node->solution[i]));
-                if (i < node->solution.size() - 1)
-                    json += ",";
-            }
-            json += "],";
+            double factor = tab(i, col);
+            if (i == row || factor == 0.0)
+                continue;
+            PivotKernel::RowUpdate(tab.Row(i).data(), tab.Row(i).data(), tab.Row(row).data(), factor, tab.Cols());
         }
-        json += "\"isInteger\":" + std::string(node->isInteger ? "true" : "false") + ",";
-        json += "\"infeasible\":" + std::string(node->infeasible ? "true" : "false") + ",";
-        json += "\"pruned\":" + std::string(node->pruned ? "true" : "false") + ",";
-        json += "\"constraintsPath\":[";
-        for (size_t i = 0; i < node->constraintsPath.size(); ++i)
+        tab.CleanNegativeZeros();
+    }
+
+    // the row among first..last with the largest entry in col, for a stable pivot
+    static std::size_t largestInColumn(const Tableau &tab, std::size_t col, std::size_t first)
+    {
+        std::size_t best = first;
+        for (std::size_t i = first + 1; i < tab.Rows(); ++i)
         {
-            if (i > 0)
-                json += ",";
-            json += "\"" + escapeJson(node->constraintsPath[i]) + "\"";
+            if (std::abs(tab(i, col)) > std::abs(tab(best, col)))
+                best = i;
         }
-        json += "],";
-        json += "\"unfixedTab\":\"" + escapeJson(node->unfixedTabStr) + "\",";
-        json += "\"fixedTab\":\"" + escapeJson(node->fixedTabStr) + "\",";
-        json += "\"finalTableau\":\"" + escapeJson(node->finalTableauStr) + "\",";
-        json += "\"intermediateTableaus\":[";
-        for (size_t i = 0; i < node->intermediateTableausStr.size(); ++i)
+        if (std::abs(tab(best, col)) <= 1e-12)
+            throw std::runtime_error("The stored basis of a node is singular.");
+        return best;
+    }
+
+    BoundedNode boundedChild(const BoundedNode &parent, BoundedTableau &&solved, int variable, const std::string &childLabel, TreeNode *treeNode)
+    {
+        double bound = roundValue(solved.tab.Rhs(0));
+        double estimate = nodeEstimate(bound, getBoundedSolution(solved));
+        BoundedNode child{{}, parent.depth + 1, childLabel, treeNode->constraintsPath, treeNode, bound, estimate};
+        if (nodeStorage == NodeStorage::BranchDiffs)
         {
-            if (i > 0)
-                json += ",";
-            json += "\"" + escapeJson(node->intermediateTableausStr[i]) + "\"";
+            child.path = std::make_shared<const BoundStep>(BoundStep{parent.path, variable, solved.lower[variable], solved.upper[variable]});
+            child.basis = solved.basicCol;
+            child.atUpper = solved.atUpper;
         }
-        json += "],";
-        json += "\"pivotCols\":[";
-        for (size_t i = 0; i < node->pivotCols.size(); ++i)
+        else
         {
-            if (i > 0)
-                json += ",";
-            json += std::to_string(node->pivotCols[i]);
+            child.state = std::move(solved);
         }
-        json += "],";
-        json += "\"pivotRows\":[";
-        for (size_t i = 0; i < node->pivotRows.size(); ++i)
+        return child;
+    }
+
+    // replays the path's bound changes on the root state, sets the same columns at their upper bounds
+    // and pivots the stored basis in
+    BoundedTableau rebuildState(const BoundedNode &node)
+    {
+        std::vector<const BoundStep *> steps;
+        for (const BoundStep *step = node.path.get(); step; step = step->parent.get())
+            steps.push_back(step);
+        std::reverse(steps.begin(), steps.end());
+
+        BoundedTableau state = boundedRoot;
+        for (const BoundStep *step : steps)
+            state.SetBounds(step->variable, step->lower, step->upper);
+        for (int j = 0; j < state.NumVars(); ++j)
         {
-            if (i > 0)
-                json += ",";
-            json += std::to_string(node->pivotRows[i]);
+            if (state.atUpper[j] != node.atUpper[j])
+                state.Complement(j);
         }
-        json += "],";
-        json += "\"children\":[";
-        for (size_t i = 0; i < node->children.size(); ++i)
+
+        for (std::size_t r = 1; r < state.tab.Rows(); ++r)
         {
-            if (i > 0)
-                json += ",";
-            json += toJson(node->children[i].get());
+            int col = node.basis[r];
+            std::size_t from = largestInColumn(state.tab, static_cast<std::size_t>(col), r);
+            if (from != r)
+            {
+                swapRows(state.tab, r, from);
+                std::swap(state.basicCol[r], state.basicCol[from]);
+                state.basicRowOf[state.basicCol[r]] = static_cast<int>(r);
+                state.basicRowOf[state.basicCol[from]] = static_cast<int>(from);
+            }
+            pivotOn(state.tab, r, static_cast<std::size_t>(col));
+            state.SetBasic(static_cast<int>(r), col);
         }
-        json += "]";
-        json += "}";
-        return json;
+        return state;
     }
 
-    std::pair<std::vector<double>, double>
-    doBranchAndBound(std::vector<std::vector<std::vector<double>>> initialTabs, bool enablePruning = false, const std::vector<int> &initialPivotCols = {}, const std::vector<int> &initialPivotRows = {})
+    // children are queued last first so a depth first search takes the MIN branch first
+    template <typename Node>
+    void queueChildren(NodeQueue<Node> &openNodes, std::vector<Node> &children)
     {
-        this->enablePruning = enablePruning;
-
-        if (isConsoleOutput)
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
         {
-            Logger::writeLine("Starting Branch and Bound Algorithm");
-            Logger::writeLine(enablePruning ? "Pruning: ENABLED (standard branch and bound)"
-                                            : "Pruning: DISABLED (complete tree exploration)");
-            Logger::writeLine(std::string(50, '='));
+            auto [bound, estimate] = nodeKeys(*it);
+            int depth = it->depth;
+            openNodes.Push(std::move(*it), bound, estimate, depth);
         }
+    }
 
-        initialTabs = roundTableaus(initialTabs);
-        bestSolution.clear();
-        bestObjective = isMin ? std::numeric_limits<double>::infinity()
-                              : -std::numeric_limits<double>::infinity();
-        nodeCounter = 0;
-        allSolutions.clear();
+    double elapsedSeconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - searchStart).count();
+    }
 
-        struct Node
-        {
-            std::vector<std::vector<std::vector<double>>> tabs;
-            int depth;
-            std::string nodeLabel;
-            std::vector<std::string> constraintsPath;
-            std::string parentLabel;
-            TreeNode *treeNode;
-        };
+    // limits checked before a node is taken; processed is the number of nodes taken so far
+    SearchStop limitBeforeNode(int processed) const
+    {
+        if (limits.nodeLimit > 0 && processed >= limits.nodeLimit)
+            return SearchStop::NodeLimit;
+        if (limits.timeLimit > 0 && elapsedSeconds() >= limits.timeLimit)
+            return SearchStop::TimeLimit;
+        return SearchStop::Completed;
+    }
 
-        auto root = std::make_unique<TreeNode>();
-        root->name = "0";
-        root->constraintsPath = {};
-        root->infeasible = false;
-        root->pruned = false;
-        root->finalTableauStr = getTableauString(initialTabs.back(), "Initial tableau solved");
-        for (size_t i = 0; i < initialTabs.size() - 1; ++i)
-        {
-            root->intermediateTableausStr.push_back(getTableauString(initialTabs[i], "Initial Tableau " + std::to_string(i + 1)));
-        }
-        root->pivotCols = initialPivotCols;
-        root->pivotRows = initialPivotRows;
+    bool gapLimited() const
+    {
+        return (limits.absoluteGap > 0 || limits.relativeGap > 0) && haveIncumbent.load();
+    }
+
+    bool gapReached(double openBound) const
+    {
+        double incumbent = incumbentObjective.load();
+        double bound = isMin ? std::min(openBound, incumbent) : std::max(openBound, incumbent);
+        double gap = std::abs(bound - incumbent);
+        if (limits.absoluteGap > 0 && gap <= limits.absoluteGap)
+            return true;
+        return limits.relativeGap > 0 && gap <= limits.relativeGap * (std::abs(incumbent) + 1e-10);
+    }
 
-        std::stack<Node> nodeStack;
-        nodeStack.push({initialTabs, 0, "0", {}, "", root.get()});
-        std::map<std::string, int> childCounters;
+    // limits checked once a node's children are queued
+    template <typename Node>
+    SearchStop limitAfterNode(const NodeQueue<Node> &openNodes) const
+    {
+        if (openNodes.Empty())
+            return SearchStop::Completed;
+        if (limits.stopAtFirstIncumbent && haveIncumbent.load())
+            return SearchStop::FirstIncumbent;
+        if (gapLimited() && gapReached(openNodes.BestBound()))
+            return SearchStop::GapLimit;
+        return SearchStop::Completed;
+    }
 
-        int ctr = 0;
-        while (!nodeStack.empty())
+    // runs the search from root, process handling one node and returning its children, and returns
+    // the best bound of the nodes left open. One thread gives the original search; the others are
+    // described at SetThreadCount and SetDeterministic
+    template <typename Node, typename Process>
+    std::optional<double> runSearch(Node root, Process process)
+    {
+        std::size_t workers = searchThreads();
+        if (workers <= 1 && !deterministic)
         {
-            if (++ctr > 100)
-            {
-                Logger::writeLine("Something is very wrong unless you need more than 100 nodes");
-                break;
-            }
+            NodeQueue<Node> openNodes(nodeSelection, isMin);
+            std::vector<Node> rootNode;
+            rootNode.push_back(std::move(root));
+            queueChildren(openNodes, rootNode);
 
-            auto current = nodeStack.top();
-            nodeStack.pop();
-            nodeCounter++;
+            while (!openNodes.Empty())
+            {
+                searchStop = limitBeforeNode(nodeCounter);
+                if (searchStop != SearchStop::Completed)
+                    break;
 
-            auto currentTreeNode = current.treeNode;
+                Node current = openNodes.Pop();
+                nodeCounter++;
 
-            current.tabs = roundTableaus(current.tabs);
+                auto children = process(current, dual, nullptr);
+                if (haveIncumbent.load())
+                    openNodes.IncumbentFound();
+                queueChildren(openNodes, children);
 
-            if (isConsoleOutput)
+                searchStop = limitAfterNode(openNodes);
+                if (searchStop != SearchStop::Completed)
+                    break;
+            }
+            return openNodes.Empty() ? std::nullopt : std::optional<double>(openNodes.BestBound());
+        }
+
+        if (deterministic)
+        {
+            NodeQueue<Node> openNodes(nodeSelection, isMin);
+            std::vector<Node> rootNode;
+            rootNode.push_back(std::move(root));
+            queueChildren(openNodes, rootNode);
+
+            while (!openNodes.Empty())
             {
-                Logger::writeLine("\n--- Processing Node " + current.nodeLabel + " (Depth " +
-                                  std::to_string(current.depth) + ") ---");
-                if (!current.parentLabel.empty())
+                std::vector<Node> batch;
+                while (!openNodes.Empty() && batch.size() < deterministicBatch)
                 {
-                    Logger::writeLine("Parent: " + current.parentLabel);
+                    searchStop = limitBeforeNode(nodeCounter);
+                    if (searchStop != SearchStop::Completed)
+                        break;
+                    batch.push_back(openNodes.Pop());
+                    nodeCounter++;
                 }
-                Logger::writeLine("Constraints path: [" +
-                                  (current.constraintsPath.empty() ? "" : std::accumulate(current.constraintsPath.begin() + 1, current.constraintsPath.end(), current.constraintsPath[0], [](const auto &a, const auto &b)
-                                                                                          { return a + ", " + b; })) +
-                                  "]");
-            }
 
-            auto sol = getCurrentSolution(current.tabs);
-            auto obj = getObjectiveValue(current.tabs);
-            currentTreeNode->solution = sol;
-            currentTreeNode->objective = obj;
-            bool isIntSol = isIntegerSolution(sol);
-            currentTreeNode->isInteger = isIntSol;
+                // the solver keeps state such as pricing weights between solves, so every node starts
+                // from a fresh copy of the configured one rather than whatever its thread solved last
+                std::vector<std::vector<Node>> children(batch.size());
+                std::vector<std::vector<IncumbentCandidate>> candidates(batch.size());
+                auto processBatchNode = [&](std::size_t i)
+                {
+                    Solver solver = dual;
+                    children[i] = process(batch[i], solver, &candidates[i]);
+                };
+                if (workers > 1)
+                    Pool().ForEach(0, batch.size(), processBatchNode);
+                else
+                    for (std::size_t i = 0; i < batch.size(); ++i)
+                        processBatchNode(i);
 
-            if (shouldPrune(current.tabs))
-            {
-                currentTreeNode->pruned = true;
-                if (isConsoleOutput)
+                for (auto &found : candidates)
                 {
-                    Logger::writeLine("Node " + current.nodeLabel + " pruned by bound");
+                    for (auto &candidate : found)
+                        updateBestSolution(candidate.solution, candidate.objective, candidate.tableau, candidate.nodeLabel);
                 }
-                continue;
+                if (haveIncumbent.load())
+                    openNodes.IncumbentFound();
+                for (auto &nodeChildren : children)
+                    queueChildren(openNodes, nodeChildren);
+
+                if (searchStop == SearchStop::Completed)
+                    searchStop = limitAfterNode(openNodes);
+                if (searchStop != SearchStop::Completed)
+                    break;
             }
+            return openNodes.Empty() ? std::nullopt : std::optional<double>(openNodes.BestBound());
+        }
 
-            updateBestSolution(current.tabs, current.nodeLabel);
+        // work stealing: every worker pops its own queue and steals from the others when it is empty.
+        // pending counts queued and running nodes, so the search is over once it reaches zero. A node
+        // being processed still counts towards the best bound, so its bound is kept in activeBounds
+        // until its children are queued; a gap check locks every queue to see a consistent picture
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            NodeQueue<Node> nodes;
+            WorkerQueue(NodeSelection selection, bool isMin) : nodes(selection, isMin) {}
+        };
+        ThreadPool &threads = Pool();
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        for (std::size_t w = 0; w < workers; ++w)
+            queues.push_back(std::make_unique<WorkerQueue>(nodeSelection, isMin));
+
+        std::vector<Node> rootNode;
+        rootNode.push_back(std::move(root));
+        queueChildren(queues[0]->nodes, rootNode);
+        std::vector<Solver> solvers(workers, dual);
+        std::vector<std::optional<double>> activeBounds(workers);
+
+        std::atomic<long> pending{1};
+        std::atomic<int> started{0};
+        std::atomic<bool> stop{false};
+        std::mutex stopMutex;
+
+        auto stopSearch = [&](SearchStop reason)
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            if (!stop.load())
+                searchStop = reason;
+            stop.store(true);
+        };
 
-            auto [newConMin, newConMax] = makeBranch(current.tabs);
-            if (newConMin.empty() && newConMax.empty())
+        // a node is only counted once there is one to take, so the node limit is exact
+        auto take = [&](std::size_t w) -> std::optional<Node>
+        {
+            for (std::size_t k = 0; k < workers; ++k)
             {
-                if (isConsoleOutput)
+                WorkerQueue &queue = *queues[(w + k) % workers];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (haveIncumbent.load())
+                    queue.nodes.IncumbentFound();
+                if (queue.nodes.Empty())
+                    continue;
+
+                int taken = started.fetch_add(1);
+                SearchStop reason = limitBeforeNode(taken);
+                if (reason != SearchStop::Completed)
                 {
-                    auto solution = getCurrentSolution(current.tabs);
-                    auto objVal = getObjectiveValue(current.tabs);
-                    std::string solStr = "[";
-                    for (size_t i = 0; i < solution.size(); ++i)
-                    {
-                        solStr += std::to_string(solution[i]);
-                        if (i < solution.size() - 1)
-                            solStr += ", ";
-                    }
-                    solStr += "]";
-                    Logger::writeLine("Node " + current.nodeLabel + ": Integer solution " +
-                                      solStr + " with objective " +
-                                      (objVal ? std::to_string(*objVal) : "null"));
+                    started.fetch_sub(1);
+                    stopSearch(reason);
+                    return std::nullopt;
                 }
-                continue;
+                activeBounds[w] = queue.nodes.TopBound();
+                return queue.nodes.Pop();
             }
+            return std::nullopt;
+        };
 
-            if (childCounters.find(current.nodeLabel) == childCounters.end())
+        auto openBound = [&](bool locked) -> std::optional<double>
+        {
+            std::vector<std::unique_lock<std::mutex>> locks;
+            if (!locked)
             {
-                childCounters[current.nodeLabel] = 0;
+                for (auto &queue : queues)
+                    locks.emplace_back(queue->mutex);
             }
-
-            std::vector<std::unique_ptr<TreeNode>> newChildren;
-            std::vector<Node> childNodes;
-
-            auto [xSpot, rhsVal] = testIfBasicVarIsInt(current.tabs);
-
-            // MIN branch
-            try
+            std::optional<double> best;
+            auto consider = [&](double bound)
             {
-                childCounters[current.nodeLabel]++;
-                std::string childLabel = current.nodeLabel == "0" ? "1" : current.nodeLabel + "." + std::to_string(childCounters[current.nodeLabel]);
-
-                if (isConsoleOutput)
-                {
-                    Logger::write("\nTrying MIN branch (Node " + childLabel + "): [");
-                    for (size_t i = 0; i < newConMin.size(); ++i)
-                    {
-                        if (i > 0)
-                            Logger::write(", ");
-                        Logger::write(std::to_string(newConMin[i]));
-                    }
-                    Logger::write("] ");
-                    for (size_t i = 0; i < newConMin.size() - 2; ++i)
-                    {
-                        if (newConMin[i] == 0.0)
-                            continue;
-                        Logger::write((newConMin[i] == 1.0 ? "" : std::to_string(newConMin[i]) + "*") +
-                                      "x" + std::to_string(i + 1) + " ");
-                    }
-                    Logger::write(newConMin[newConMin.size() - 1] == 0 ? "<= " : ">= ");
-                    Logger::writeLine(std::to_string(newConMin[newConMin.size() - 2]));
-                }
-
-                auto [displayTabMin, newTabMin] = doAddConstraint({newConMin}, current.tabs[current.tabs.size() - 1]);
-                auto [newTableausMin, changingVarsMin, optimalSolutionMin, pivotColsMin, pivotRowsMin, headerRowMin] =
-                    dual.DoDualSimplex({}, {}, isMin, &displayTabMin);
+                best = !best ? bound : (isMin ? std::min(*best, bound) : std::max(*best, bound));
+            };
+            for (auto &queue : queues)
+            {
+                if (!queue->nodes.Empty())
+                    consider(queue->nodes.BestBound());
+            }
+            for (auto &bound : activeBounds)
+            {
+                if (bound)
+                    consider(*bound);
+            }
+            return best;
+        };
 
-                bool minInfeasible = std::isnan(optimalSolutionMin);
-                if (minInfeasible)
+        threads.ForEach(0, workers, [&](std::size_t w)
+                        {
+            while (!stop.load() && pending.load() > 0)
+            {
+                std::optional<Node> node = take(w);
+                if (!node)
                 {
-                    if (!newTableausMin.empty())
-                    {
-                        printTableau(newTableausMin[0], "Node " + childLabel + ": Infeasible tableau");
-                    }
-                    newTableausMin.clear();
+                    std::this_thread::yield();
+                    continue;
                 }
 
-                auto childMin = std::make_unique<TreeNode>();
-                childMin->name = childLabel;
-                std::string constraintDesc = "x" + std::to_string(*xSpot + 1) + " <= " + std::to_string(static_cast<int>(std::floor(*rhsVal)));
-                auto newConstraintsPath = current.constraintsPath;
-                newConstraintsPath.push_back(constraintDesc);
-                childMin->constraintsPath = newConstraintsPath;
-                childMin->pruned = false;
-                childMin->unfixedTabStr = getTableauString(newTabMin, "unfixed tab");
-                childMin->fixedTabStr = getTableauString(displayTabMin, "fixed tab");
-                childMin->pivotCols = pivotColsMin;
-                childMin->pivotRows = pivotRowsMin;
-
-                if (newTableausMin.empty())
+                std::vector<Node> children;
+                try
                 {
-                    childMin->infeasible = true;
-                    childMin->isInteger = false;
-                    childMin->objective = std::nullopt;
-                    childMin->solution = {};
-                    if (isConsoleOutput)
-                        Logger::writeLine("MIN branch (Node " + childLabel + ") infeasible");
+                    children = process(*node, solvers[w], nullptr);
                 }
-                else
+                catch (...)
                 {
-                    childMin->infeasible = false;
-                    newTableausMin = roundTableaus(newTableausMin);
-                    auto childSol = getCurrentSolution(newTableausMin);
-                    auto childObj = getObjectiveValue(newTableausMin);
-                    childMin->solution = childSol;
-                    childMin->objective = childObj;
-                    childMin->isInteger = isIntegerSolution(childSol);
+                    stop.store(true);
+                    throw;
                 }
 
-                if (!newTableausMin.empty())
+                pending.fetch_add(static_cast<long>(children.size()));
                 {
-                    if (minInfeasible && !newTableausMin.empty())
-                    {
-                        childMin->finalTableauStr = getTableauString(newTableausMin[0], "Node " + childLabel + ": Infeasible tableau");
-                    }
-                    else
-                    {
-                        for (size_t i = 0; i < newTableausMin.size() - 1; ++i)
-                        {
-                            std::string title = "Node " + childLabel + " MIN branch Tableau " + std::to_string(i + 1);
-                            printTableau(newTableausMin[i], title);
-                            childMin->intermediateTableausStr.push_back(getTableauString(newTableausMin[i], title));
-                            displayTableausMin.push_back(newTableausMin[i]);
-                        }
-                        std::string finalTitle = "Node " + childLabel + " MIN branch final tableau";
-                        printTableau(newTableausMin[newTableausMin.size() - 1], finalTitle);
-                        childMin->finalTableauStr = getTableauString(newTableausMin[newTableausMin.size() - 1], finalTitle);
-                        displayTableausMin.push_back(newTableausMin[newTableausMin.size() - 1]);
-                    }
+                    std::lock_guard<std::mutex> lock(queues[w]->mutex);
+                    queueChildren(queues[w]->nodes, children);
+                    activeBounds[w].reset();
                 }
+                pending.fetch_sub(1);
 
-                newChildren.push_back(std::move(childMin));
-                if (!newTableausMin.empty())
+                if (limits.stopAtFirstIncumbent && haveIncumbent.load())
                 {
-                    childNodes.push_back({newTableausMin, current.depth + 1, childLabel, newChildren.back()->constraintsPath, current.nodeLabel, newChildren.back().get()});
+                    stopSearch(SearchStop::FirstIncumbent);
                 }
-            }
-            catch (const std::exception &e)
-            {
-                if (isConsoleOutput)
+                else if (gapLimited())
                 {
-                    Logger::writeLine("MIN branch failed: " + std::string(e.what()));
+                    std::optional<double> bound = openBound(false);
+                    if (bound && gapReached(*bound))
+                        stopSearch(SearchStop::GapLimit);
                 }
-            }
+            } });
 
-            // MAX branch
-            try
-            {
-                childCounters[current.nodeLabel]++;
-                std::string childLabel = current.nodeLabel == "0" ? "2" : current.nodeLabel + "." + std::to_string(childCounters[current.nodeLabel]);
+        nodeCounter = started.load();
+        std::optional<double> remaining = openBound(true);
+        if (!remaining)
+            searchStop = SearchStop::Completed;
+        return remaining;
+    }
 
-                if (isConsoleOutput)
-                {
-                    Logger::write("\nTrying MAX branch (Node " + childLabel + "): [");
-                    for (size_t i = 0; i < newConMax.size(); ++i)
-                    {
-                        if (i > 0)
-                            Logger::write(", ");
-                        Logger::write(std::to_string(newConMax[i]));
-                    }
-                    Logger::write("] ");
-                    for (size_t i = 0; i < newConMax.size() - 2; ++i)
-                    {
-                        if (newConMax[i] == 0.0)
-                            continue;
-                        Logger::write((newConMax[i] == 1.0 ? "" : std::to_string(newConMax[i]) + "*") +
-                                      "x" + std::to_string(i + 1) + " ");
-                    }
-                    Logger::write(newConMax[newConMax.size() - 1] == 0 ? "<= " : ">= ");
-                    Logger::writeLine(std::to_string(newConMax[newConMax.size() - 2]));
-                }
+    bool shouldPrune(const std::vector<std::vector<std::vector<double>>> &tabs)
+    {
+        if (!enablePruning)
+            return false;
 
-                auto [displayTabMax, newTabMax] = doAddConstraint({newConMax}, current.tabs[current.tabs.size() - 1]);
-                auto [newTableausMax, changingVarsMax, optimalSolutionMax, pivotColsMax, pivotRowsMax, headerRowMax] =
-                    dual.DoDualSimplex({}, {}, isMin, &displayTabMax);
+        return shouldPrune(getObjectiveValue(tabs));
+    }
 
-                bool maxInfeasible = std::isnan(optimalSolutionMax);
-                if (maxInfeasible)
-                {
-                    if (!newTableausMax.empty())
-                    {
-                        printTableau(newTableausMax[0], "Node " + childLabel + ": Infeasible tableau");
-                    }
-                    newTableausMax.clear();
-                }
+    bool shouldPrune(std::optional<double> objVal)
+    {
+        if (!enablePruning)
+            return false;
 
-                auto childMax = std::make_unique<TreeNode>();
-                childMax->name = childLabel;
-                std::string constraintDesc = "x" + std::to_string(*xSpot + 1) + " >= " + std::to_string(static_cast<int>(std::ceil(*rhsVal)));
-                auto newConstraintsPath = current.constraintsPath;
-                newConstraintsPath.push_back(constraintDesc);
-                childMax->constraintsPath = newConstraintsPath;
-                childMax->pruned = false;
-                childMax->unfixedTabStr = getTableauString(newTabMax, "unfixed tab");
-                childMax->fixedTabStr = getTableauString(displayTabMax, "fixed tab");
-                childMax->pivotCols = pivotColsMax;
-                childMax->pivotRows = pivotRowsMax;
-
-                if (newTableausMax.empty())
-                {
-                    childMax->infeasible = true;
-                    childMax->isInteger = false;
-                    childMax->objective = std::nullopt;
-                    childMax->solution = {};
-                    if (isConsoleOutput)
-                        Logger::writeLine("MAX branch (Node " + childLabel + ") infeasible");
-                }
-                else
-                {
-                    childMax->infeasible = false;
-                    newTableausMax = roundTableaus(newTableausMax);
-                    auto childSol = getCurrentSolution(newTableausMax);
-                    auto childObj = getObjectiveValue(newTableausMax);
-                    childMax->solution = childSol;
-                    childMax->objective = childObj;
-                    childMax->isInteger = isIntegerSolution(childSol);
-                }
+        if (!objVal)
+            return true;
 
-                if (!newTableausMax.empty())
-                {
-                    if (maxInfeasible && !newTableausMax.empty())
-                    {
-                        childMax->finalTableauStr = getTableauString(newTableausMax[0], "Node " + childLabel + ": Infeasible tableau");
-                    }
-                    else
-                    {
-                        for (size_t i = 0; i < newTableausMax.size() - 1; ++i)
-                        {
-                            std::string title = "Node " + childLabel + " MAX branch Tableau " + std::to_string(i + 1);
-                            printTableau(newTableausMax[i], title);
-                            childMax->intermediateTableausStr.push_back(getTableauString(newTableausMax[i], title));
-                        }
-                        std::string finalTitle = "Node " + childLabel + " MAX branch final tableau";
-                        printTableau(newTableausMax[newTableausMax.size() - 1], finalTitle);
-                        childMax->finalTableauStr = getTableauString(newTableausMax[newTableausMax.size() - 1], finalTitle);
-                    }
-                }
+        if (haveIncumbent.load())
+        {
+            double incumbent = incumbentObjective.load();
+            return isMin ? *objVal >= incumbent : *objVal <= incumbent;
+        }
+        return false;
+    }
 
-                newChildren.push_back(std::move(childMax));
-                if (!newTableausMax.empty())
-                {
-                    childNodes.push_back({newTableausMax, current.depth + 1, childLabel, newChildren.back()->constraintsPath, current.nodeLabel, newChildren.back().get()});
-                }
-            }
-            catch (const std::exception &e)
+    std::string toJson(const TreeNode *node) const
+    {
+        std::string json = "{";
+        json += "\"name\":\"" + node->name + "\",";
+        json += "\"objective\":" + (node->objective.has_value() ? std::to_string((node->objective.value())) : "null") + ",";
+        json += "\"solution\":";
+        if (node->solution.empty() && node->infeasible)
+        {
+            json += "null,";
+        }
+        else
+        {
+            json += "[";
+            for (size_t i = 0; i < node->solution.size(); ++i)
             {
-                if (isConsoleOutput)
-                {
-                    Logger::writeLine("MAX branch failed: " + std::string(e.what()));
-                }
+                json += std::to_string((node->solution[i]));
+                if (i < node->solution.size() - 1)
+                    json += ",";
             }
+            json += "],";
+        }
+        json += "\"isInteger\":" + std::string(node->isInteger ? "true" : "false") + ",";
+        json += "\"infeasible\":" + std::string(node->infeasible ? "true" : "false") + ",";
+        json += "\"pruned\":" + std::string(node->pruned ? "true" : "false") + ",";
+        json += "\"constraintsPath\":[";
+        for (size_t i = 0; i < node->constraintsPath.size(); ++i)
+        {
+            if (i > 0)
+                json += ",";
+            json += "\"" + escapeJson(node->constraintsPath[i]) + "\"";
+        }
+        json += "],";
+        json += "\"unfixedTab\":\"" + escapeJson(RenderTableau(node->unfixedTab)) + "\",";
+        json += "\"fixedTab\":\"" + escapeJson(RenderTableau(node->fixedTab)) + "\",";
+        json += "\"finalTableau\":\"" + escapeJson(RenderTableau(node->finalTableau)) + "\",";
+        json += "\"intermediateTableaus\":[";
+        for (size_t i = 0; i < node->intermediateTableaus.size(); ++i)
+        {
+            if (i > 0)
+                json += ",";
+            json += "\"" + escapeJson(RenderTableau(node->intermediateTableaus[i])) + "\"";
+        }
+        json += "],";
+        json += "\"pivotCols\":[";
+        for (size_t i = 0; i < node->pivotCols.size(); ++i)
+        {
+            if (i > 0)
+                json += ",";
+            json += std::to_string(node->pivotCols[i]);
+        }
+        json += "],";
+        json += "\"pivotRows\":[";
+        for (size_t i = 0; i < node->pivotRows.size(); ++i)
+        {
+            if (i > 0)
+                json += ",";
+            json += std::to_string(node->pivotRows[i]);
+        }
+        json += "],";
+        json += "\"children\":[";
+        for (size_t i = 0; i < node->children.size(); ++i)
+        {
+            if (i > 0)
+                json += ",";
+            json += toJson(node->children[i].get());
+        }
+        json += "]";
+        json += "}";
+        return json;
+    }
 
-            for (auto &ch : newChildren)
-            {
-                currentTreeNode->children.push_back(std::move(ch));
-            }
+    void beginSearch(bool enablePruning)
+    {
+        this->enablePruning = enablePruning;
 
-            for (auto it = childNodes.rbegin(); it != childNodes.rend(); ++it)
-            {
-                nodeStack.push(*it);
-            }
+        if (isConsoleOutput)
+        {
+            Logger::writeLine("Starting Branch and Bound Algorithm");
+            Logger::writeLine(enablePruning ? "Pruning: ENABLED (standard branch and bound)"
+                                            : "Pruning: DISABLED (complete tree exploration)");
+            Logger::writeLine(std::string(50, '='));
+        }
+
+        bestSolution.clear();
+        bestObjective = isMin ? std::numeric_limits<double>::infinity()
+                              : -std::numeric_limits<double>::infinity();
+        nodeCounter = 0;
+        allSolutions.clear();
+        haveIncumbent.store(false);
+        searchStop = SearchStop::Completed;
+        searchStart = std::chrono::steady_clock::now();
+    }
+
+    // openBound is the best bound of the nodes a limit left unexplored, none when the search finished
+    void finishSearch(std::unique_ptr<TreeNode> root, std::optional<double> openBound)
+    {
+        searchTree = std::move(root);
+        jsonOut.clear();
+
+        lastResult = SearchResult();
+        lastResult.stop = openBound ? searchStop : SearchStop::Completed;
+        lastResult.nodes = nodeCounter;
+        lastResult.seconds = elapsedSeconds();
+        if (!bestSolution.empty())
+            lastResult.incumbent = bestObjective;
+        if (openBound && lastResult.incumbent)
+            lastResult.bestBound = isMin ? std::min(*openBound, bestObjective) : std::max(*openBound, bestObjective);
+        else if (openBound)
+            lastResult.bestBound = *openBound;
+        else
+            lastResult.bestBound = bestObjective;
+        lastResult.gap = lastResult.incumbent ? std::abs(lastResult.bestBound - bestObjective)
+                                              : std::numeric_limits<double>::infinity();
+
+        if (isConsoleOutput && lastResult.stop != SearchStop::Completed)
+        {
+            Logger::writeLine("\nSearch stopped by the " + SearchStopName(lastResult.stop) + " with open nodes left");
         }
 
         if (isConsoleOutput)
@@ -1027,6 +1460,11 @@ public:
                 Logger::writeLine("No integer solution found");
             }
             Logger::writeLine("Total nodes processed: " + std::to_string(nodeCounter));
+            if (lastResult.stop != SearchStop::Completed)
+            {
+                Logger::writeLine("Best bound: " + std::to_string(lastResult.bestBound));
+                Logger::writeLine("Gap: " + std::to_string(lastResult.gap));
+            }
 
             if (!allSolutions.empty())
             {
@@ -1076,7 +1514,492 @@ public:
 
         this->solution += "\nTotal nodes processed: " + std::to_string(nodeCounter);
 
-        this->jsonOut = toJson(root.get());
+        if (lastResult.stop != SearchStop::Completed)
+        {
+            this->solution += "\nSearch stopped by the " + SearchStopName(lastResult.stop);
+            this->solution += "\nBest bound: " + std::to_string(lastResult.bestBound);
+            this->solution += "\nGap: " + std::to_string(lastResult.gap);
+        }
+
+    }
+
+    // one node of the constraint-row search: prune it or branch on it, solving both children, and hand
+    // the children back to the caller to queue. Only the node's own TreeNode is written
+    std::vector<DenseNode> processDenseNode(DenseNode &current, Solver &solver, std::vector<IncumbentCandidate> *deferred)
+    {
+        auto currentTreeNode = current.treeNode;
+
+        current.tabs = roundTableaus(current.tabs);
+
+        if (isConsoleOutput)
+        {
+            Logger::writeLine("\n--- Processing Node " + current.nodeLabel + " (Depth " +
+                              std::to_string(current.depth) + ") ---");
+            if (!current.parentLabel.empty())
+            {
+                Logger::writeLine("Parent: " + current.parentLabel);
+            }
+            Logger::writeLine("Constraints path: [" +
+                              (current.constraintsPath.empty() ? "" : std::accumulate(current.constraintsPath.begin() + 1, current.constraintsPath.end(), current.constraintsPath[0], [](const auto &a, const auto &b)
+                                                                                      { return a + ", " + b; })) +
+                              "]");
+        }
+
+        auto sol = getCurrentSolution(current.tabs);
+        auto obj = getObjectiveValue(current.tabs);
+        currentTreeNode->solution = sol;
+        currentTreeNode->objective = obj;
+        bool isIntSol = isIntegerSolution(sol);
+        currentTreeNode->isInteger = isIntSol;
+
+        if (shouldPrune(current.tabs))
+        {
+            currentTreeNode->pruned = true;
+            if (isConsoleOutput)
+            {
+                Logger::writeLine("Node " + current.nodeLabel + " pruned by bound");
+            }
+            return {};
+        }
+
+        offerIncumbent(current.tabs, current.nodeLabel, deferred);
+
+        auto [newConMin, newConMax] = makeBranch(current.tabs);
+        if (newConMin.empty() && newConMax.empty())
+        {
+            if (isConsoleOutput)
+            {
+                auto solution = getCurrentSolution(current.tabs);
+                auto objVal = getObjectiveValue(current.tabs);
+                std::string solStr = "[";
+                for (size_t i = 0; i < solution.size(); ++i)
+                {
+                    solStr += std::to_string(solution[i]);
+                    if (i < solution.size() - 1)
+                        solStr += ", ";
+                }
+                solStr += "]";
+                Logger::writeLine("Node " + current.nodeLabel + ": Integer solution " +
+                                  solStr + " with objective " +
+                                  (objVal ? std::to_string(*objVal) : "null"));
+            }
+            return {};
+        }
+
+        int childCounter = 0;
+
+        std::vector<std::unique_ptr<TreeNode>> newChildren;
+        std::vector<DenseNode> childNodes;
+
+        auto [xSpot, rhsVal] = testIfBasicVarIsInt(current.tabs);
+
+        // MIN branch
+        try
+        {
+            childCounter++;
+            std::string childLabel = current.nodeLabel == "0" ? "1" : current.nodeLabel + "." + std::to_string(childCounter);
+
+            if (isConsoleOutput)
+            {
+                Logger::write("\nTrying MIN branch (Node " + childLabel + "): [");
+                for (size_t i = 0; i < newConMin.size(); ++i)
+                {
+                    if (i > 0)
+                        Logger::write(", ");
+                    Logger::write(std::to_string(newConMin[i]));
+                }
+                Logger::write("] ");
+                for (size_t i = 0; i < newConMin.size() - 2; ++i)
+                {
+                    if (newConMin[i] == 0.0)
+                        return {};
+                    Logger::write((newConMin[i] == 1.0 ? "" : std::to_string(newConMin[i]) + "*") +
+                                  "x" + std::to_string(i + 1) + " ");
+                }
+                Logger::write(newConMin[newConMin.size() - 1] == 0 ? "<= " : ">= ");
+                Logger::writeLine(std::to_string(newConMin[newConMin.size() - 2]));
+            }
+
+            auto [displayTabMin, newTabMin] = doAddConstraint({newConMin}, current.tabs[current.tabs.size() - 1]);
+            auto [newTableausMin, changingVarsMin, optimalSolutionMin, pivotColsMin, pivotRowsMin, headerRowMin] =
+                solver.DoDualSimplex({}, {}, isMin, &displayTabMin);
+
+            bool minInfeasible = std::isnan(optimalSolutionMin);
+            if (minInfeasible)
+            {
+                if (!newTableausMin.empty())
+                {
+                    printTableau(newTableausMin[0], "Node " + childLabel + ": Infeasible tableau");
+                }
+                newTableausMin.clear();
+            }
+
+            auto childMin = std::make_unique<TreeNode>();
+            childMin->name = childLabel;
+            std::string constraintDesc = "x" + std::to_string(*xSpot + 1) + " <= " + std::to_string(static_cast<int>(std::floor(*rhsVal)));
+            auto newConstraintsPath = current.constraintsPath;
+            newConstraintsPath.push_back(constraintDesc);
+            childMin->constraintsPath = newConstraintsPath;
+            childMin->pruned = false;
+            keepTableau(childMin->unfixedTab, newTabMin, "unfixed tab");
+            keepTableau(childMin->fixedTab, displayTabMin, "fixed tab");
+            childMin->pivotCols = pivotColsMin;
+            childMin->pivotRows = pivotRowsMin;
+
+            if (newTableausMin.empty())
+            {
+                childMin->infeasible = true;
+                childMin->isInteger = false;
+                childMin->objective = std::nullopt;
+                childMin->solution = {};
+                if (isConsoleOutput)
+                    Logger::writeLine("MIN branch (Node " + childLabel + ") infeasible");
+            }
+            else
+            {
+                childMin->infeasible = false;
+                newTableausMin = roundTableaus(newTableausMin);
+                auto childSol = getCurrentSolution(newTableausMin);
+                auto childObj = getObjectiveValue(newTableausMin);
+                childMin->solution = childSol;
+                childMin->objective = childObj;
+                childMin->isInteger = isIntegerSolution(childSol);
+            }
+
+            if (!newTableausMin.empty())
+            {
+                if (minInfeasible && !newTableausMin.empty())
+                {
+                    keepFinalTableau(*childMin, newTableausMin[0], "Node " + childLabel + ": Infeasible tableau");
+                }
+                else
+                {
+                    for (size_t i = 0; i < newTableausMin.size() - 1; ++i)
+                    {
+                        std::string title = "Node " + childLabel + " MIN branch Tableau " + std::to_string(i + 1);
+                        printTableau(newTableausMin[i], title);
+                        keepIntermediateTableau(*childMin, newTableausMin[i], title);
+                        recordDisplayTableau(newTableausMin[i]);
+                    }
+                    std::string finalTitle = "Node " + childLabel + " MIN branch final tableau";
+                    printTableau(newTableausMin[newTableausMin.size() - 1], finalTitle);
+                    keepFinalTableau(*childMin, newTableausMin[newTableausMin.size() - 1], finalTitle);
+                    recordDisplayTableau(newTableausMin[newTableausMin.size() - 1]);
+                }
+            }
+
+            newChildren.push_back(std::move(childMin));
+            if (!newTableausMin.empty())
+            {
+                childNodes.push_back({{newTableausMin.back()}, current.depth + 1, childLabel, newChildren.back()->constraintsPath, current.nodeLabel, newChildren.back().get()});
+            }
+        }
+        catch (const std::exception &e)
+        {
+            if (isConsoleOutput)
+            {
+                Logger::writeLine("MIN branch failed: " + std::string(e.what()));
+            }
+        }
+
+        // MAX branch
+        try
+        {
+            childCounter++;
+            std::string childLabel = current.nodeLabel == "0" ? "2" : current.nodeLabel + "." + std::to_string(childCounter);
+
+            if (isConsoleOutput)
+            {
+                Logger::write("\nTrying MAX branch (Node " + childLabel + "): [");
+                for (size_t i = 0; i < newConMax.size(); ++i)
+                {
+                    if (i > 0)
+                        Logger::write(", ");
+                    Logger::write(std::to_string(newConMax[i]));
+                }
+                Logger::write("] ");
+                for (size_t i = 0; i < newConMax.size() - 2; ++i)
+                {
+                    if (newConMax[i] == 0.0)
+                        return {};
+                    Logger::write((newConMax[i] == 1.0 ? "" : std::to_string(newConMax[i]) + "*") +
+                                  "x" + std::to_string(i + 1) + " ");
+                }
+                Logger::write(newConMax[newConMax.size() - 1] == 0 ? "<= " : ">= ");
+                Logger::writeLine(std::to_string(newConMax[newConMax.size() - 2]));
+            }
+
+            auto [displayTabMax, newTabMax] = doAddConstraint({newConMax}, current.tabs[current.tabs.size() - 1]);
+            auto [newTableausMax, changingVarsMax, optimalSolutionMax, pivotColsMax, pivotRowsMax, headerRowMax] =
+                solver.DoDualSimplex({}, {}, isMin, &displayTabMax);
+
+            bool maxInfeasible = std::isnan(optimalSolutionMax);
+            if (maxInfeasible)
+            {
+                if (!newTableausMax.empty())
+                {
+                    printTableau(newTableausMax[0], "Node " + childLabel + ": Infeasible tableau");
+                }
+                newTableausMax.clear();
+            }
+
+            auto childMax = std::make_unique<TreeNode>();
+            childMax->name = childLabel;
+            std::string constraintDesc = "x" + std::to_string(*xSpot + 1) + " >= " + std::to_string(static_cast<int>(std::ceil(*rhsVal)));
+            auto newConstraintsPath = current.constraintsPath;
+            newConstraintsPath.push_back(constraintDesc);
+            childMax->constraintsPath = newConstraintsPath;
+            childMax->pruned = false;
+            keepTableau(childMax->unfixedTab, newTabMax, "unfixed tab");
+            keepTableau(childMax->fixedTab, displayTabMax, "fixed tab");
+            childMax->pivotCols = pivotColsMax;
+            childMax->pivotRows = pivotRowsMax;
+
+            if (newTableausMax.empty())
+            {
+                childMax->infeasible = true;
+                childMax->isInteger = false;
+                childMax->objective = std::nullopt;
+                childMax->solution = {};
+                if (isConsoleOutput)
+                    Logger::writeLine("MAX branch (Node " + childLabel + ") infeasible");
+            }
+            else
+            {
+                childMax->infeasible = false;
+                newTableausMax = roundTableaus(newTableausMax);
+                auto childSol = getCurrentSolution(newTableausMax);
+                auto childObj = getObjectiveValue(newTableausMax);
+                childMax->solution = childSol;
+                childMax->objective = childObj;
+                childMax->isInteger = isIntegerSolution(childSol);
+            }
+
+            if (!newTableausMax.empty())
+            {
+                if (maxInfeasible && !newTableausMax.empty())
+                {
+                    keepFinalTableau(*childMax, newTableausMax[0], "Node " + childLabel + ": Infeasible tableau");
+                }
+                else
+                {
+                    for (size_t i = 0; i < newTableausMax.size() - 1; ++i)
+                    {
+                        std::string title = "Node " + childLabel + " MAX branch Tableau " + std::to_string(i + 1);
+                        printTableau(newTableausMax[i], title);
+                        keepIntermediateTableau(*childMax, newTableausMax[i], title);
+                    }
+                    std::string finalTitle = "Node " + childLabel + " MAX branch final tableau";
+                    printTableau(newTableausMax[newTableausMax.size() - 1], finalTitle);
+                    keepFinalTableau(*childMax, newTableausMax[newTableausMax.size() - 1], finalTitle);
+                }
+            }
+
+            newChildren.push_back(std::move(childMax));
+            if (!newTableausMax.empty())
+            {
+                childNodes.push_back({{newTableausMax.back()}, current.depth + 1, childLabel, newChildren.back()->constraintsPath, current.nodeLabel, newChildren.back().get()});
+            }
+        }
+        catch (const std::exception &e)
+        {
+            if (isConsoleOutput)
+            {
+                Logger::writeLine("MAX branch failed: " + std::string(e.what()));
+            }
+        }
+
+        for (auto &ch : newChildren)
+        {
+            currentTreeNode->children.push_back(std::move(ch));
+        }
+
+        return childNodes;
+    }
+
+    std::pair<std::vector<double>, double>
+    doBranchAndBound(std::vector<std::vector<std::vector<double>>> initialTabs, bool enablePruning = false, const std::vector<int> &initialPivotCols = {}, const std::vector<int> &initialPivotRows = {})
+    {
+        beginSearch(enablePruning);
+        initialTabs = roundTableaus(initialTabs);
+
+        auto root = std::make_unique<TreeNode>();
+        root->name = "0";
+        root->constraintsPath = {};
+        root->infeasible = false;
+        root->pruned = false;
+        keepFinalTableau(*root, initialTabs.back(), "Initial tableau solved");
+        for (size_t i = 0; i < initialTabs.size() - 1; ++i)
+        {
+            keepIntermediateTableau(*root, initialTabs[i], "Initial Tableau " + std::to_string(i + 1));
+        }
+        root->pivotCols = initialPivotCols;
+        root->pivotRows = initialPivotRows;
+
+        auto openBound = runSearch(DenseNode{{initialTabs.back()}, 0, "0", {}, "", root.get()},
+                                   [this](DenseNode &node, Solver &solver, std::vector<IncumbentCandidate> *deferred)
+                                   { return processDenseNode(node, solver, deferred); });
+
+        finishSearch(std::move(root), openBound);
+
+        return {bestSolution, bestObjective};
+    }
+
+    std::vector<double> getBoundedSolution(const BoundedTableau &state)
+    {
+        std::vector<double> solution(objFunc.size(), 0.0);
+        for (size_t j = 0; j < objFunc.size(); ++j)
+        {
+            solution[j] = roundValue(state.Value(static_cast<int>(j)));
+        }
+        return solution;
+    }
+
+    // one node of the bound-change search, the counterpart of processDenseNode
+    std::vector<BoundedNode> processBoundedNode(BoundedNode &current, Solver &solver, std::vector<IncumbentCandidate> *deferred)
+    {
+        auto currentTreeNode = current.treeNode;
+
+        if (current.path)
+            current.state = rebuildState(current);
+
+        if (isConsoleOutput)
+        {
+            Logger::writeLine("\n--- Processing Node " + current.nodeLabel + " (Depth " +
+                              std::to_string(current.depth) + ") ---");
+        }
+
+        auto sol = getBoundedSolution(current.state);
+        double obj = roundValue(current.state.tab.Rhs(0));
+        currentTreeNode->solution = sol;
+        currentTreeNode->objective = obj;
+        currentTreeNode->isInteger = isIntegerSolution(sol);
+
+        if (shouldPrune(obj))
+        {
+            currentTreeNode->pruned = true;
+            if (isConsoleOutput)
+            {
+                Logger::writeLine("Node " + current.nodeLabel + " pruned by bound");
+            }
+            return {};
+        }
+
+        auto parentTab = roundMatrix(current.state.tab.ToVectors());
+        offerIncumbent(sol, obj, parentTab, current.nodeLabel, deferred);
+
+        auto [xSpot, rhsVal] = pickBranchVar(sol);
+        if (!xSpot || !rhsVal)
+        {
+            return {};
+        }
+
+        int j = *xSpot;
+        if (isConsoleOutput)
+        {
+            Logger::writeLine("Branching on x" + std::to_string(j + 1) + " = " + std::to_string(*rhsVal));
+        }
+
+        std::vector<BoundedNode> childNodes;
+        for (int side = 0; side < 2; ++side)
+        {
+            bool isMinBranch = side == 0;
+            std::string childLabel = current.nodeLabel == "0" ? std::to_string(side + 1) : current.nodeLabel + "." + std::to_string(side + 1);
+            std::string branchName = isMinBranch ? "MIN" : "MAX";
+
+            try
+            {
+                BoundedTableau child = current.state;
+                std::string constraintDesc;
+                if (isMinBranch)
+                {
+                    child.SetBounds(j, child.lower[j], std::floor(*rhsVal));
+                    constraintDesc = "x" + std::to_string(j + 1) + " <= " + std::to_string(static_cast<int>(std::floor(*rhsVal)));
+                }
+                else
+                {
+                    child.SetBounds(j, std::ceil(*rhsVal), child.upper[j]);
+                    constraintDesc = "x" + std::to_string(j + 1) + " >= " + std::to_string(static_cast<int>(std::ceil(*rhsVal)));
+                }
+
+                if (isConsoleOutput)
+                {
+                    Logger::writeLine("\nTrying " + branchName + " branch (Node " + childLabel + "): " + constraintDesc);
+                }
+
+                auto childTree = std::make_unique<TreeNode>();
+                childTree->name = childLabel;
+                childTree->constraintsPath = current.constraintsPath;
+                childTree->constraintsPath.push_back(constraintDesc);
+                keepTableau(childTree->unfixedTab, parentTab, "unfixed tab");
+                if (tableauRendering == TableauRendering::Full)
+                    childTree->fixedTab = {"fixed tab", child.tab.ToVectors()};
+
+                auto [childTabs, changingVars, optimalSolution, pivotCols, pivotRows, headerRow] =
+                    solver.DoBoundedDualSimplex(child, isMin);
+                childTree->pivotCols = pivotCols;
+                childTree->pivotRows = pivotRows;
+
+                if (std::isnan(optimalSolution))
+                {
+                    childTree->infeasible = true;
+                    if (isConsoleOutput)
+                        Logger::writeLine(branchName + " branch (Node " + childLabel + ") infeasible");
+                }
+                else
+                {
+                    childTabs = roundTableaus(childTabs);
+                    for (size_t i = 0; i < childTabs.size() - 1; ++i)
+                    {
+                        std::string title = "Node " + childLabel + " " + branchName + " branch Tableau " + std::to_string(i + 1);
+                        printTableau(childTabs[i], title);
+                        keepIntermediateTableau(*childTree, childTabs[i], title);
+                    }
+                    std::string finalTitle = "Node " + childLabel + " " + branchName + " branch final tableau";
+                    printTableau(childTabs.back(), finalTitle);
+                    keepFinalTableau(*childTree, childTabs.back(), finalTitle);
+
+                    childNodes.push_back(boundedChild(current, std::move(child), j, childLabel, childTree.get()));
+                }
+
+                currentTreeNode->children.push_back(std::move(childTree));
+            }
+            catch (const std::exception &e)
+            {
+                if (isConsoleOutput)
+                {
+                    Logger::writeLine(branchName + " branch failed: " + std::string(e.what()));
+                }
+            }
+        }
+
+        return childNodes;
+    }
+
+    // same search as doBranchAndBound but every node owns a bounded tableau of the root size and a
+    // branch only moves one bound of the branching variable before the dual simplex reoptimizes
+    std::pair<std::vector<double>, double>
+    doBoundedBranchAndBound(const BoundedTableau &rootState, const std::vector<std::vector<std::vector<double>>> &initialTabs, bool enablePruning = false, const std::vector<int> &initialPivotCols = {}, const std::vector<int> &initialPivotRows = {})
+    {
+        beginSearch(enablePruning);
+
+        auto root = std::make_unique<TreeNode>();
+        root->name = "0";
+        keepFinalTableau(*root, initialTabs.back(), "Initial tableau solved");
+        for (size_t i = 0; i < initialTabs.size() - 1; ++i)
+        {
+            keepIntermediateTableau(*root, initialTabs[i], "Initial Tableau " + std::to_string(i + 1));
+        }
+        root->pivotCols = initialPivotCols;
+        root->pivotRows = initialPivotRows;
+
+        boundedRoot = rootState;
+        double rootBound = roundValue(rootState.tab.Rhs(0));
+        auto openBound = runSearch(BoundedNode{rootState, 0, "0", {}, root.get(), rootBound, nodeEstimate(rootBound, getBoundedSolution(rootState))},
+                                   [this](BoundedNode &node, Solver &solver, std::vector<IncumbentCandidate> *deferred)
+                                   { return processBoundedNode(node, solver, deferred); });
+
+        finishSearch(std::move(root), openBound);
 
         return {bestSolution, bestObjective};
     }
@@ -1115,12 +2038,12 @@ public:
                     column.push_back(tableau[row][col]);
                 }
 
-                int onesCount = std::count_if(column.begin(), column.end(),
-                                              [this](double x)
-                                              { return std::abs(x - 1.0) < tolerance; });
-                int zerosCount = std::count_if(column.begin(), column.end(),
-                                               [this](double x)
-                                               { return std::abs(x) < tolerance; });
+                std::size_t onesCount = std::count_if(column.begin(), column.end(),
+                                                      [this](double x)
+                                                      { return std::abs(x - 1.0) < tolerance; });
+                std::size_t zerosCount = std::count_if(column.begin(), column.end(),
+                                                       [this](double x)
+                                                       { return std::abs(x) < tolerance; });
 
                 if (onesCount == 1 && zerosCount == column.size() - 1)
                 {
@@ -1155,7 +2078,8 @@ public:
     RunBranchAndBound(const std::vector<double> &objFuncPassed, const std::vector<std::vector<double>> &constraintsPassed, bool isMin)
     {
         // std::cout << "running" << std::endl;
-        bool enablePruning = false;
+        bool enablePruning = pruning;
+        this->isMin = isMin;
 
         try
         {
@@ -1167,6 +2091,21 @@ public:
 
             try
             {
+                bool boundBranching = branchingMode == BranchingMode::BoundChanges;
+                if (boundBranching && !std::is_same_v<Scalar, double>)
+                {
+                    throw std::invalid_argument("Bound-change branching needs the double solver.");
+                }
+                if (boundBranching)
+                {
+                    dual.SetVariableBounds(std::vector<double>(objFunc.size(), 0.0),
+                                           std::vector<double>(objFunc.size(), std::numeric_limits<double>::infinity()));
+                }
+                else
+                {
+                    dual.ClearVariableBounds();
+                }
+
                 auto [newTableaus, changingVars, optimalSolution, pivotCols, pivotRows, headerRow] =
                     dual.DoDualSimplex(a, b, isMin);
 
@@ -1197,7 +2136,20 @@ public:
                                       (objVal ? std::to_string(*objVal) : "null"));
                 }
 
-                doBranchAndBound(this->newTableaus, enablePruning, pivotCols, pivotRows);
+                if (boundBranching)
+                {
+                    dual.ClearVariableBounds();
+                    if (std::isnan(optimalSolution))
+                    {
+                        throw std::runtime_error("The LP relaxation is infeasible.");
+                    }
+                    if constexpr (std::is_same_v<Scalar, double>)
+                        doBoundedBranchAndBound(dual.GetBoundedState(), this->newTableaus, enablePruning, pivotCols, pivotRows);
+                }
+                else
+                {
+                    doBranchAndBound(this->newTableaus, enablePruning, pivotCols, pivotRows);
+                }
             }
             catch (const std::exception &e)
             {
@@ -1215,11 +2167,24 @@ public:
         }
     }
 
+    // the tree is written out the first time it is asked for, not at the end of every search
     std::string getJSON() const
     {
+        if (jsonOut.empty() && searchTree)
+            jsonOut = toJson(searchTree.get());
         return this->jsonOut;
     }
 
+    // tree of the last search for callers that show nodes one at a time
+    const TreeNode *GetSearchTree() const { return searchTree.get(); }
+
+    std::string RenderTableau(const TableauSnapshot &snapshot) const
+    {
+        if (snapshot.values.empty())
+            return "";
+        return getTableauString(snapshot.values, snapshot.title);
+    }
+
     std::string getSolutionStr() const
     {
         return this->solution;
@@ -1238,6 +2203,9 @@ private:
         return copy;
     }
 
-    std::string jsonOut = "{}";
+    mutable std::string jsonOut = "{}";
+    std::unique_ptr<TreeNode> searchTree;
     std::string solution;
 };
+
+using BranchAndBound = BasicBranchAndBound<double>;
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// order in which the open nodes of a branch and bound search are processed
+enum class NodeSelection
+{
+    DepthFirst,   // newest node first, the original stack order
+    BestBound,    // best LP objective first
+    BestEstimate, // best estimated integer objective first
+    Hybrid        // depth first until there is an incumbent, then best bound
+};
+
+// Open node list of a branch and bound search. Every rule is a heap order, so depth first pops exactly
+// what a stack would and the hybrid rule only re-heaps once, when the first incumbent turns up. Ties
+// go to the deeper node and then to the newer one, which keeps best-first searches diving
+template <typename Node>
+class NodeQueue
+{
+private:
+    struct Entry
+    {
+        Node node;
+        double bound;
+        double estimate;
+        int depth;
+        std::uint64_t sequence;
+    };
+
+    std::vector<Entry> heap;
+    NodeSelection selection;
+    bool isMin;
+    bool haveIncumbent = false;
+    std::uint64_t nextSequence = 0;
+
+    NodeSelection ActiveRule() const
+    {
+        if (selection == NodeSelection::Hybrid)
+            return haveIncumbent ? NodeSelection::BestBound : NodeSelection::DepthFirst;
+        return selection;
+    }
+
+    // heap order: true when a is popped after b
+    bool Later(const Entry &a, const Entry &b) const
+    {
+        NodeSelection rule = ActiveRule();
+        if (rule != NodeSelection::DepthFirst)
+        {
+            double keyA = rule == NodeSelection::BestEstimate ? a.estimate : a.bound;
+            double keyB = rule == NodeSelection::BestEstimate ? b.estimate : b.bound;
+            if (keyA != keyB)
+                return isMin ? keyA > keyB : keyA < keyB;
+            if (a.depth != b.depth)
+                return a.depth < b.depth;
+        }
+        return a.sequence < b.sequence;
+    }
+
+    auto Order() const
+    {
+        return [this](const Entry &a, const Entry &b)
+        { return Later(a, b); };
+    }
+
+public:
+    NodeQueue(NodeSelection selection, bool isMin) : selection(selection), isMin(isMin) {}
+
+    bool Empty() const { return heap.empty(); }
+    std::size_t Size() const { return heap.size(); }
+
+    // bound is the node's LP objective, estimate the integer objective it is expected to lead to
+    void Push(Node node, double bound, double estimate, int depth)
+    {
+        heap.push_back({std::move(node), bound, estimate, depth, nextSequence++});
+        std::push_heap(heap.begin(), heap.end(), Order());
+    }
+
+    // bound of the node Pop returns next
+    double TopBound() const { return heap.front().bound; }
+
+    // best bound over every open node, the limit on what the rest of the search can still find
+    double BestBound() const
+    {
+        double best = heap.front().bound;
+        for (const Entry &entry : heap)
+            best = isMin ? std::min(best, entry.bound) : std::max(best, entry.bound);
+        return best;
+    }
+
+    Node Pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), Order());
+        Node node = std::move(heap.back().node);
+        heap.pop_back();
+        return node;
+    }
+
+    // the hybrid rule switches to best bound from here on
+    void IncumbentFound()
+    {
+        if (haveIncumbent)
+            return;
+        haveIncumbent = true;
+        if (selection == NodeSelection::Hybrid)
+            std::make_heap(heap.begin(), heap.end(), Order());
+    }
+};
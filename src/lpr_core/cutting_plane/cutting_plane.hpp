@@ -48,6 +48,8 @@ public:
         constraints = {{0.0, 0.0, 0.0, 0.0}};
     }
 
+    void SetSimplexEngine(SimplexEngine engine) { dual.SetEngine(engine); }
+
     std::string getCollectedOutput() const
     {
         return oss.str();
@@ -395,15 +397,14 @@ public:
             oss << "Adding new slack variable column...\n"
                 << std::endl;
 
-            for (auto &row : currentTableau)
-            {
-                row.insert(row.end() - 1, 0);
-            }
+            Tableau cutTableau(currentTableau, 1);
+            cutTableau.InsertColumnBeforeRhs(0.0);
+            cutTableau.AppendRow(newCon);
 
-            currentTableau.push_back(newCon);
+            currentTableau = cutTableau.ToVectors();
             printTableau(currentTableau, "Tableau with cutting plane constraint " + std::to_string(iteration));
 
-            auto result = dual.DoDualSimplex({}, {}, isMin, &currentTableau);
+            auto result = dual.DoDualSimplex({}, {}, isMin, cutTableau);
             auto finalTableaus = result.tableaus;
             auto headerStr = result.headerRow;
             auto pivotRow = result.pivotRows;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+// counts for the last solve; cleanupPivots are the pivots taken after the perturbation was removed
+struct DegeneracyStats
+{
+    int degeneratePivots = 0;
+    int perturbations = 0;
+    int cyclesDetected = 0;
+    int cleanupPivots = 0;
+};
+
+// splitmix64 of index; fixed so perturbed solves and basis hashes are reproducible
+inline std::uint64_t DegeneracyKey(int index)
+{
+    std::uint64_t z = static_cast<std::uint64_t>(index) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// value in [1, 2) per row or column, so no two perturbed entries tie
+inline double PerturbationFactor(int index)
+{
+    return 1.0 + static_cast<double>(DegeneracyKey(index) >> 11) * 0x1.0p-53;
+}
+
+// Remembers every basis a solve has been through. The hash is the XOR of one key per basic column, so a
+// pivot updates it in O(1) and a set of basic columns hashes the same whichever rows hold them. A repeat
+// means the pivot rule is cycling (or, very rarely, a hash collision)
+class BasisCycleDetector
+{
+private:
+    std::uint64_t hash = 0;
+    std::unordered_set<std::uint64_t> visited;
+
+public:
+    // -1 entries (rows without a known basic column) are skipped
+    void Reset(const std::vector<int> &basicCols)
+    {
+        hash = 0;
+        for (int col : basicCols)
+        {
+            if (col >= 0)
+                hash ^= DegeneracyKey(col);
+        }
+        visited.clear();
+        visited.insert(hash);
+    }
+
+    // true when the basis after the pivot was seen before
+    bool Pivot(int leavingCol, int enteringCol)
+    {
+        if (leavingCol >= 0)
+            hash ^= DegeneracyKey(leavingCol);
+        hash ^= DegeneracyKey(enteringCol);
+        return !visited.insert(hash).second;
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "tableau.hpp"
+
+// Tableau whose columns carry lower and upper bounds. Column j stores y = x - lower, or
+// y = upper - x once it has been complemented, so every column works on [0, upper - lower]
+// and the usual nonnegative tableau rules apply. Row 0 is the objective row.
+struct BoundedTableau
+{
+    Tableau tab;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<char> atUpper;
+    std::vector<int> basicCol;
+    std::vector<int> basicRowOf;
+    int lenObj = 0;
+
+    BoundedTableau() = default;
+
+    // basicCol[i] is the column that is basic in row i (row 0 has none); all bounds start at [0, inf)
+    BoundedTableau(Tableau startTab, const std::vector<int> &basicCol, int lenObj)
+        : tab(std::move(startTab)), basicCol(basicCol), lenObj(lenObj)
+    {
+        int n = NumVars();
+        lower.assign(n, 0.0);
+        upper.assign(n, std::numeric_limits<double>::infinity());
+        atUpper.assign(n, 0);
+        basicRowOf.assign(n, -1);
+        for (int i = 1; i < static_cast<int>(this->basicCol.size()); i++)
+        {
+            if (this->basicCol[i] >= 0)
+                basicRowOf[this->basicCol[i]] = i;
+        }
+    }
+
+    int NumVars() const { return static_cast<int>(tab.Cols()) - 1; }
+    double Range(int j) const { return upper[j] - lower[j]; }
+    bool IsBoxed(int j) const { return std::isfinite(Range(j)); }
+    bool IsBasic(int j) const { return basicRowOf[j] != -1; }
+
+    // swaps column j between measuring from its lower and from its upper bound
+    void Complement(int j)
+    {
+        double range = Range(j);
+        if (!std::isfinite(range))
+        {
+            throw std::logic_error("Cannot complement a variable without a finite range.");
+        }
+        for (std::size_t k = 0; k < tab.Rows(); k++)
+        {
+            double a = tab(k, j);
+            if (a == 0.0)
+                continue;
+            tab.Rhs(k) -= a * range;
+            tab(k, j) = -a;
+        }
+        atUpper[j] = !atUpper[j];
+
+        // a basic column keeps its unit entry
+        int row = basicRowOf[j];
+        if (row != -1)
+        {
+            for (double &val : tab.Row(row))
+                val = val == 0.0 ? 0.0 : -val;
+        }
+    }
+
+    // moves the bounds of column j and shifts the rhs so the tableau still describes the same point
+    void SetBounds(int j, double newLower, double newUpper)
+    {
+        if (!std::isfinite(newLower))
+        {
+            throw std::invalid_argument("Variable lower bounds must be finite.");
+        }
+        if (atUpper[j] && !std::isfinite(newUpper))
+        {
+            Complement(j);
+        }
+
+        double delta = atUpper[j] ? upper[j] - newUpper : newLower - lower[j];
+        if (delta != 0.0)
+        {
+            for (std::size_t k = 0; k < tab.Rows(); k++)
+            {
+                double a = tab(k, j);
+                if (a != 0.0)
+                    tab.Rhs(k) -= a * delta;
+            }
+        }
+        lower[j] = newLower;
+        upper[j] = newUpper;
+    }
+
+    double Value(int j) const
+    {
+        double y = basicRowOf[j] != -1 ? tab.Rhs(basicRowOf[j]) : 0.0;
+        return atUpper[j] ? upper[j] - y : lower[j] + y;
+    }
+
+    // negative when the basic variable of row i is below its lower bound, positive when above its upper
+    double RowInfeasibility(int i) const
+    {
+        double v = tab.Rhs(i);
+        if (v < 0.0)
+            return v;
+        double range = Range(basicCol[i]);
+        return v > range ? v - range : 0.0;
+    }
+
+    void SetBasic(int row, int j)
+    {
+        basicRowOf[basicCol[row]] = -1;
+        basicCol[row] = j;
+        basicRowOf[j] = row;
+    }
+
+    bool HasEmptyRange() const
+    {
+        for (int j = 0; j < NumVars(); j++)
+        {
+            if (Range(j) < 0.0)
+                return true;
+        }
+        return false;
+    }
+};
@@ -7,17 +7,97 @@
 #include <algorithm>
 #include <limits>
 #include <iomanip>
+#include <stdexcept>
+#include <type_traits>
+
+#include "tableau.hpp"
+#include "scalar_traits.hpp"
+#include "bounded_tableau.hpp"
+#include "pivot_kernel.hpp"
+#include "thread_pool.hpp"
+#include "lp_model.hpp"
+#include "revised_simplex.hpp"
+#include "presolve.hpp"
+#include "lp_scaling.hpp"
+#include "interior_point.hpp"
+#include "degeneracy.hpp"
+
+// Full keeps every intermediate tableau for step-by-step display, FinalOnly pivots one
+// working tableau in place and only returns the final one
+enum class TableauHistory
+{
+    Full,
+    FinalOnly
+};
+
+// Dense pivots the full tableau every iteration, Revised keeps an LU factored basis and only
+// builds the final tableau. InteriorPoint runs the Mehrotra solver and crosses over to the revised
+// engine from the basis its solution identifies; solves with variable bounds still take the bounded path
+enum class SimplexEngine
+{
+    Dense,
+    Revised,
+    InteriorPoint
+};
 
-class DualSimplex
+// leaving row rule for the dual pivot; MostNegativeRhs breaks ties on the smallest row index
+enum class DualPricingRule
+{
+    MostNegativeRhs,
+    Devex,
+    SteepestEdge
+};
+
+// Scalar is what the dense tableau is pivoted in: float for large screening solves, long double for
+// ill-conditioned models, Rational for exact results. Inputs and returned tableaus stay double. Bounds
+// and the revised engine are double only
+template <typename Scalar>
+class BasicDualSimplex
 {
 private:
+    using TableauType = BasicTableau<Scalar>;
+    using Traits = ScalarTraits<Scalar>;
+    static constexpr bool IsDouble = std::is_same_v<Scalar, double>;
+
     bool isConsoleOutput;
+    TableauHistory historyMode = TableauHistory::Full;
+    SimplexEngine engine = SimplexEngine::Dense;
+    PivotKernelMode pivotKernelMode = PivotKernelMode::Strict;
+    bool parallelPivot = false;
+    std::size_t parallelPivotMinRows = 256;
+    DualPricingRule dualPricing = DualPricingRule::MostNegativeRhs;
+    std::vector<double> dualWeights;
+    std::vector<double> boundLower;
+    std::vector<double> boundUpper;
+    bool boundFlipping = true;
+    BoundedTableau boundedState;
+    bool presolveEnabled = false;
+    PresolveStats presolveStats;
+    bool scalingEnabled = false;
+    const LPBasis *warmBasis = nullptr;
+    const std::vector<double> *warmPoint = nullptr;
+    LPBasis finalBasis;
+    InteriorPoint::InteriorPointResult interiorPointResult;
+    RevisedSimplexStatus revisedStatus = RevisedSimplexStatus::Optimal;
+    bool antiDegeneracy = true;
+    DegeneracyStats degeneracyStats;
     std::vector<int> IMPivotCols;
     std::vector<int> IMPivotRows;
     std::vector<std::string> IMHeaderRow;
     std::vector<int> phases;
 
     static constexpr double EPS = 1e-12;
+    // zero-step pivots in a row before the dense engine perturbs, and how often it may escalate
+    static constexpr int STALL_LIMIT = 50;
+    static constexpr int MAX_PERTURBATIONS = 3;
+
+    // how the bounded primal phase stops; only Optimal leaves an objective to report
+    enum class PrimalPhaseEnd
+    {
+        Optimal,
+        Unbounded,
+        IterationLimit
+    };
 
     struct LPRResult
     {
@@ -33,138 +113,313 @@ private:
     LPRResult result;
 
 public:
-    DualSimplex(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput) {}
+    BasicDualSimplex(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput) {}
+
+    void SetHistoryMode(TableauHistory mode) { historyMode = mode; }
+    TableauHistory GetHistoryMode() const { return historyMode; }
+
+    void SetEngine(SimplexEngine newEngine) { engine = newEngine; }
+    SimplexEngine GetEngine() const { return engine; }
+
+    void SetPivotKernelMode(PivotKernelMode mode) { pivotKernelMode = mode; }
+    PivotKernelMode GetPivotKernelMode() const { return pivotKernelMode; }
+
+    void SetDualPricingRule(DualPricingRule rule)
+    {
+        dualPricing = rule;
+        dualWeights.clear();
+    }
+    DualPricingRule GetDualPricingRule() const { return dualPricing; }
+
+    // bounds for the objective variables; solves with bounds run the bounded tableau path
+    void SetVariableBounds(const std::vector<double> &lower, const std::vector<double> &upper)
+    {
+        boundLower = lower;
+        boundUpper = upper;
+    }
+    void ClearVariableBounds()
+    {
+        boundLower.clear();
+        boundUpper.clear();
+    }
+    bool HasVariableBounds() const { return !boundLower.empty() || !boundUpper.empty(); }
+
+    // long-step ratio test: boxed columns whose breakpoint is passed flip bounds instead of entering
+    void SetBoundFlipping(bool enable) { boundFlipping = enable; }
+
+    const BoundedTableau &GetBoundedState() const { return boundedState; }
+
+    // presolved solves show the tableaus of the reduced model but report values for the original one
+    void SetPresolve(bool enable) { presolveEnabled = enable; }
+    const PresolveStats &GetPresolveStats() const { return presolveStats; }
+
+    // scaled solves show scaled tableaus; changingVars, bounds and the objective stay in the model's units
+    void SetScaling(bool enable) { scalingEnabled = enable; }
+
+    // basis of the last successful solve, in the order DoDualSimplex takes a start basis; empty after a failure
+    const LPBasis &GetFinalBasis() const { return finalBasis; }
+
+    // duals and iteration count of the last InteriorPoint engine solve, for the model the engine saw
+    // (after presolve and scaling when those are on)
+    const InteriorPoint::InteriorPointResult &GetInteriorPointResult() const { return interiorPointResult; }
+
+    // how the last Revised engine solve or InteriorPoint crossover ended; only Optimal carries an objective
+    RevisedSimplexStatus GetRevisedStatus() const { return revisedStatus; }
+
+    // dense solves perturb the rhs and costs after a long run of zero-step pivots or a revisited basis, then
+    // remove the perturbation and clean up from the basis it reached, so the result is for the model as given
+    void SetAntiDegeneracy(bool enable) { antiDegeneracy = enable; }
+    const DegeneracyStats &GetDegeneracyStats() const { return degeneracyStats; }
+
+    // tableaus with fewer than minRows rows always pivot on the calling thread
+    void SetParallelPivot(bool enable, std::size_t minRows = 256)
+    {
+        parallelPivot = enable;
+        parallelPivotMinRows = minRows;
+    }
+
+    // the rows other than pivotRow are independent, so large tableaus split them over the shared pool
+    void EliminatePivotColumn(TableauType &tab, int pivotRow, int pivotCol)
+    {
+        auto pivotMathRow = tab.Row(pivotRow);
+        auto updateRows = [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                if (static_cast<int>(i) == pivotRow)
+                    continue;
+                auto row = tab.Row(i);
+                PivotKernel::RowUpdate(row.data(), row.data(), pivotMathRow.data(), row[pivotCol], row.size(), pivotKernelMode);
+            }
+        };
+
+        if (parallelPivot && tab.Rows() >= parallelPivotMinRows)
+            ThreadPool::Shared().ParallelFor(0, tab.Rows(), updateRows, 16);
+        else
+            updateRows(0, tab.Rows());
+    }
+
+    std::vector<std::vector<double>> DoFormulationOperation(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints)
+    {
+        return DoFormulationOperation(SparseLPModel::FromDense(objFunc, constraints));
+    }
 
-    std::vector<std::vector<double>> DoFormulationOperation(const std::vector<double> &objFunc, std::vector<std::vector<double>> constraints)
+    // only the tableau itself is dense; >= rows are negated while scattering the columns
+    std::vector<std::vector<double>> DoFormulationOperation(const SparseLPModel &model)
     {
         int excessCount = 0;
         int slackCount = 0;
 
-        for (const auto &constraint : constraints)
+        for (int i = 0; i < model.numRows; i++)
         {
-            if (constraint.back() == 1)
+            if (model.IsGreaterEqual(i))
                 excessCount++;
             else
                 slackCount++;
         }
 
-        for (auto &constraint : constraints)
+        int tableSizeH = model.numRows + 1;
+        int imCtr = 1;
+        for (int j = 0; j < model.numCols; j++)
         {
-            if (constraint.back() == 1)
-            {
-                for (double &val : constraint)
-                {
-                    val *= -1;
-                }
-            }
+            IMHeaderRow.push_back("x" + std::to_string(imCtr++));
         }
 
-        for (auto &constraint : constraints)
+        imCtr = 1;
+        for (int i = 0; i < excessCount; i++)
         {
-            constraint.pop_back();
+            IMHeaderRow.push_back("e" + std::to_string(imCtr++));
         }
 
-        int tableSizeH = constraints.size() + 1;
-        int imCtr = 1;
-        for (size_t i = 0; i < objFunc.size(); i++)
+        for (int i = 0; i < slackCount; i++)
         {
-            IMHeaderRow.push_back("x" + std::to_string(imCtr++));
+            IMHeaderRow.push_back("s" + std::to_string(imCtr++));
         }
 
-        imCtr = 1;
-        if (excessCount > 0)
+        IMHeaderRow.push_back("rhs");
+
+        int tableSizeW = excessCount + slackCount + 1 + model.numCols;
+        std::vector<std::vector<double>> opTable(tableSizeH, std::vector<double>(tableSizeW, 0.0));
+
+        for (int j = 0; j < model.numCols; j++)
         {
-            for (int i = 0; i < excessCount; i++)
+            opTable[0][j] = -model.objective[j];
+            for (int k = model.ColBegin(j); k < model.ColEnd(j); k++)
             {
-                IMHeaderRow.push_back("e" + std::to_string(imCtr++));
+                int row = model.rowIndex[k];
+                opTable[row + 1][j] = model.IsGreaterEqual(row) ? -model.values[k] : model.values[k];
             }
         }
 
-        if (slackCount > 0)
+        for (int i = 0; i < model.numRows; i++)
         {
-            for (int i = 0; i < slackCount; i++)
-            {
-                IMHeaderRow.push_back("s" + std::to_string(imCtr++));
-            }
+            opTable[i + 1][tableSizeW - 1] = model.IsGreaterEqual(i) ? -model.rhs[i] : model.rhs[i];
+            opTable[i + 1][i + model.numCols] = 1;
         }
 
-        IMHeaderRow.push_back("rhs");
+        return opTable;
+    }
 
-        int tableSizeW = excessCount + slackCount + 1 + objFunc.size();
-        std::vector<std::vector<double>> opTable(tableSizeH, std::vector<double>(tableSizeW, 0.0));
+    // the columns just before the rhs hold B^-1 (up to row signs) for the constraint rows
+    static bool HasInverseBlock(const TableauType &tab)
+    {
+        return tab.Rows() > 1 && tab.Cols() >= tab.Rows();
+    }
 
-        for (size_t i = 0; i < objFunc.size(); i++)
-        {
-            opTable[0][i] = -objFunc[i];
-        }
+    // pricing weights are kept in double whatever the scalar
+    static double InverseRowDot(const TableauType &tab, int a, int b)
+    {
+        std::size_t start = tab.Cols() - tab.Rows();
+        auto rowA = tab.Row(a);
+        auto rowB = tab.Row(b);
+        double sum = 0.0;
+        for (std::size_t j = start; j + 1 < tab.Cols(); j++)
+            sum += Traits::ToDouble(rowA[j]) * Traits::ToDouble(rowB[j]);
+        return sum;
+    }
+
+    // steepest edge starts from the exact row norms of B^-1, Devex from a unit reference framework
+    void InitDualWeights(const TableauType &tab)
+    {
+        dualWeights.assign(tab.Rows(), 1.0);
+        if (dualPricing != DualPricingRule::SteepestEdge || !HasInverseBlock(tab))
+            return;
+        for (int i = 1; i < static_cast<int>(tab.Rows()); i++)
+            dualWeights[i] = std::max(InverseRowDot(tab, i, i), 1e-10);
+    }
+
+    // picks the constraint row with the largest rhs^2 / weight among the infeasible rows
+    int SelectWeightedDualRow(const TableauType &tab)
+    {
+        if (dualWeights.size() != tab.Rows())
+            InitDualWeights(tab);
 
-        for (size_t i = 0; i < constraints.size(); i++)
+        int pivotRow = -1;
+        double bestScore = 0.0;
+        for (int i = 1; i < static_cast<int>(tab.Rows()); ++i)
         {
-            for (size_t j = 0; j < constraints[i].size() - 1; j++)
+            if (tab.Rhs(i) >= -Traits::PivotTolerance())
+                continue;
+            double rhs = Traits::ToDouble(tab.Rhs(i));
+            double score = rhs * rhs / dualWeights[i];
+            if (score > bestScore)
             {
-                opTable[i + 1][j] = constraints[i][j];
+                bestScore = score;
+                pivotRow = i;
             }
-            opTable[i + 1][tableSizeW - 1] = constraints[i].back();
         }
+        return pivotRow;
+    }
+
+    // updates the weights for a pivot on (r, q) using the tableau before the pivot is applied
+    void UpdateDualWeights(const TableauType &tab, int r, int q)
+    {
+        int rows = static_cast<int>(tab.Rows());
+        double alphaR = Traits::ToDouble(tab(r, q));
+        bool exact = dualPricing == DualPricingRule::SteepestEdge && HasInverseBlock(tab);
+        double weightR = exact ? InverseRowDot(tab, r, r) : dualWeights[r];
 
-        for (size_t i = 1; i < opTable.size(); i++)
+        for (int i = 1; i < rows; i++)
         {
-            opTable[i][i + objFunc.size() - 1] = 1;
+            if (i == r)
+                continue;
+            double ratio = Traits::ToDouble(tab(i, q)) / alphaR;
+            if (ratio == 0.0)
+                continue;
+            if (exact)
+            {
+                double tau = InverseRowDot(tab, i, r);
+                dualWeights[i] = std::max(dualWeights[i] - 2.0 * ratio * tau + ratio * ratio * weightR, 1e-10);
+            }
+            else
+            {
+                dualWeights[i] = std::max(dualWeights[i], ratio * ratio * weightR);
+            }
         }
-
-        return opTable;
+        dualWeights[r] = exact ? std::max(weightR / (alphaR * alphaR), 1e-10) : std::max(weightR / (alphaR * alphaR), 1.0);
     }
 
-    std::pair<std::vector<std::vector<double>>, std::vector<double>> DoDualPivotOperation(const std::vector<std::vector<double>> &tab)
+    // pivots tab in place and returns the theta row, or an empty vector (tab untouched) when no pivot exists
+    std::vector<Scalar> DoDualPivotOperationInPlace(TableauType &tab)
     {
-        std::vector<double> thetaRow;
-        std::vector<double> rhs;
-        for (const auto &row : tab)
-            rhs.push_back(row.back());
+        const Scalar eps = Traits::PivotTolerance();
+        std::vector<Scalar> thetaRow;
+        int rows = static_cast<int>(tab.Rows());
+        bool weighted = dualPricing != DualPricingRule::MostNegativeRhs;
 
         // find the most negative RHS (choose smallest index in ties)
         int pivotRow = -1;
-        double minRhs = std::numeric_limits<double>::infinity();
-        for (size_t i = 0; i < rhs.size(); ++i)
+        if (weighted)
+        {
+            pivotRow = SelectWeightedDualRow(tab);
+        }
+        else
         {
-            if (rhs[i] < -EPS && (rhs[i] < minRhs - EPS || (std::abs(rhs[i] - minRhs) <= EPS && static_cast<int>(i) < pivotRow)))
+            Scalar minRhs = Traits::Infinity();
+            for (int i = 1; i < rows; ++i)
             {
-                minRhs = rhs[i];
-                pivotRow = static_cast<int>(i);
+                Scalar rhs = tab.Rhs(i);
+                if (rhs < -eps && (rhs < minRhs - eps || (Traits::Abs(rhs - minRhs) <= eps && i < pivotRow)))
+                {
+                    minRhs = rhs;
+                    pivotRow = i;
+                }
             }
         }
         if (pivotRow == -1)
-            return {tab, {}}; // no negative rhs -> done
+            return {}; // no negative rhs -> done
 
-        int m = static_cast<int>(tab[pivotRow].size()) - 1;
+        int m = static_cast<int>(tab.Cols()) - 1;
+        auto leavingRow = tab.Row(pivotRow);
 
         // find candidate pivot columns (tab[pivotRow][j] < 0)
         std::vector<int> candidates;
         for (int j = 0; j < m; ++j)
-            if (tab[pivotRow][j] < -EPS)
+            if (leavingRow[j] < -eps)
                 candidates.push_back(j);
         if (candidates.empty())
-            return {tab, {}}; // no eligible pivot column
+            return {}; // no eligible pivot column
 
         // compute dual pivot thetas and pick smallest positive theta; tie-break by smallest column index (Bland)
-        double bestTheta = std::numeric_limits<double>::infinity();
+        Scalar bestTheta = Traits::Infinity();
         int bestCol = -1;
-        thetaRow.assign(m, std::numeric_limits<double>::infinity());
+        thetaRow.assign(m, Traits::Infinity());
         for (int col : candidates)
         {
-            double denom = tab[pivotRow][col];
-            if (std::abs(denom) < EPS)
+            Scalar denom = leavingRow[col];
+            if (Traits::Abs(denom) < eps)
                 continue;
-            double theta = std::abs(tab[0][col] / denom);
+            Scalar theta = Traits::Abs(tab(0, col) / denom);
             thetaRow[col] = theta;
-            if (theta > EPS)
+            if (theta > eps)
+            {
+                if (theta < bestTheta - eps || (Traits::Abs(theta - bestTheta) <= eps && col < bestCol))
+                {
+                    bestTheta = theta;
+                    bestCol = col;
+                }
+            }
+        }
+
+        // the weighted rules keep the basis dual feasible: zero thetas count, ties go to the larger pivot
+        if (weighted)
+        {
+            bestTheta = Traits::Infinity();
+            bestCol = -1;
+            for (int col : candidates)
             {
-                if (theta < bestTheta - EPS || (std::abs(theta - bestTheta) <= EPS && col < bestCol))
+                Scalar theta = thetaRow[col];
+                if (theta == Traits::Infinity())
+                    continue;
+                if (bestCol == -1 || theta < bestTheta - eps ||
+                    (theta <= bestTheta + eps && Traits::Abs(leavingRow[col]) > Traits::Abs(leavingRow[bestCol])))
                 {
                     bestTheta = theta;
                     bestCol = col;
                 }
             }
+            if (bestCol == -1)
+                return {};
         }
 
         // if no positive theta found, but zeros exist, prefer smallest column index with theta == 0
@@ -172,44 +427,35 @@ public:
         {
             for (int col : candidates)
             {
-                if (std::abs(thetaRow[col]) <= EPS)
+                if (Traits::Abs(thetaRow[col]) <= eps)
                 {
                     bestCol = col;
                     break;
                 }
             }
             if (bestCol == -1)
-                return {tab, {}}; // nothing usable
+                return {}; // nothing usable
         }
 
         int rowIndex = pivotRow;
         int colIndex = bestCol;
 
-        std::vector<std::vector<double>> newTab = tab;
-        double divNumber = tab[rowIndex][colIndex];
-        if (std::abs(divNumber) < EPS)
-            return {tab, {}};
+        Scalar divNumber = tab(rowIndex, colIndex);
+        if (Traits::Abs(divNumber) < eps)
+            return {};
 
-        for (size_t j = 0; j < newTab[rowIndex].size(); j++)
-        {
-            newTab[rowIndex][j] = newTab[rowIndex][j] / divNumber;
-            if (newTab[rowIndex][j] == -0.0)
-                newTab[rowIndex][j] = 0.0;
-        }
+        if (weighted)
+            UpdateDualWeights(tab, rowIndex, colIndex);
 
-        std::vector<double> pivotMathRow = newTab[rowIndex];
-        for (size_t i = 0; i < newTab.size(); i++)
+        auto pivotMathRow = tab.Row(rowIndex);
+        for (Scalar &val : pivotMathRow)
         {
-            if (i == static_cast<size_t>(rowIndex))
-                continue;
-            double factor = tab[i][colIndex];
-            for (size_t j = 0; j < newTab[i].size(); j++)
-            {
-                newTab[i][j] -= factor * newTab[rowIndex][j];
-            }
+            val = val / divNumber;
+            if (val == Scalar(0))
+                val = Scalar(0);
         }
 
-        newTab[rowIndex] = pivotMathRow;
+        EliminatePivotColumn(tab, rowIndex, colIndex);
 
         if (isConsoleOutput)
         {
@@ -219,24 +465,39 @@ public:
         IMPivotCols.push_back(colIndex);
         IMPivotRows.push_back(rowIndex);
 
-        return {newTab, thetaRow};
+        return thetaRow;
     }
 
-    std::pair<std::vector<std::vector<double>>, std::vector<double>> DoPrimalPivotOperation(
-        const std::vector<std::vector<double>> &tab, bool isMin)
+    std::pair<TableauType, std::vector<Scalar>> DoDualPivotOperation(const TableauType &tab)
+    {
+        TableauType newTab = tab;
+        auto thetaRow = DoDualPivotOperationInPlace(newTab);
+        return {std::move(newTab), thetaRow};
+    }
+
+    std::pair<std::vector<std::vector<double>>, std::vector<Scalar>> DoDualPivotOperation(const std::vector<std::vector<double>> &tab)
+    {
+        auto [newTab, thetaRow] = DoDualPivotOperation(TableauType(tab));
+        return {newTab.ToVectors(), thetaRow};
+    }
+
+    // pivots tab in place and returns the theta column, or an empty vector (tab untouched) when no pivot exists
+    std::vector<Scalar> DoPrimalPivotOperationInPlace(TableauType &tab, bool isMin)
     {
 
-        std::vector<double> thetasCol;
-        std::vector<double> testRow(tab[0].begin(), tab[0].end() - 1);
+        std::vector<Scalar> thetasCol;
+        auto testRow = tab.Row(0).first(tab.Cols() - 1);
 
-        double largestNegativeNumber;
+        Scalar largestNegativeNumber = 0;
         bool foundNumber = false;
 
+        // reduced costs within the pivot tolerance are rounding left by earlier pivots, not improving columns
+        const Scalar eps = Traits::PivotTolerance();
         if (isMin)
         {
-            for (double num : testRow)
+            for (Scalar num : testRow)
             {
-                if (num > 0 && num != 0)
+                if (num > eps)
                 {
                     if (!foundNumber || num < largestNegativeNumber)
                     {
@@ -248,9 +509,9 @@ public:
         }
         else
         {
-            for (double num : testRow)
+            for (Scalar num : testRow)
             {
-                if (num < 0 && num != 0)
+                if (num < -eps)
                 {
                     if (!foundNumber || num < largestNegativeNumber)
                     {
@@ -263,158 +524,61 @@ public:
 
         if (!foundNumber)
         {
-            return {std::vector<std::vector<double>>(), std::vector<double>()};
+            return {};
         }
 
         int colIndex = -1;
-        for (int i = 0; i < tab[0].size(); i++)
+        for (int i = 0; i < static_cast<int>(tab.Cols()); i++)
         {
-            if (tab[0][i] == largestNegativeNumber)
+            if (tab(0, i) == largestNegativeNumber)
             {
                 colIndex = i;
                 break;
             }
         }
 
-        std::vector<double> thetas;
-        for (int i = 1; i < tab.size(); i++)
+        // only rows with a positive entry bound the step; a zero ratio is a degenerate pivot and is taken
+        // like any other, since stepping past it drives that row's rhs negative
+        std::vector<Scalar> thetas;
+        int rowIndex = -1;
+        Scalar minTheta = Traits::Infinity();
+        for (int i = 1; i < static_cast<int>(tab.Rows()); i++)
         {
-            if (tab[i][colIndex] != 0)
-            {
-                thetas.push_back(tab[i].back() / tab[i][colIndex]);
-            }
-            else
+            Scalar entry = tab(i, colIndex);
+            thetas.push_back(entry != 0 ? tab.Rhs(i) / entry : Traits::Infinity());
+            if (entry <= eps)
+                continue;
+            Scalar theta = tab.Rhs(i) > 0 ? tab.Rhs(i) / entry : Scalar(0);
+            if (rowIndex == -1 || theta < minTheta)
             {
-                thetas.push_back(std::numeric_limits<double>::infinity());
+                minTheta = theta;
+                rowIndex = i;
             }
         }
 
         thetasCol = thetas;
 
-        bool allNegativeThetas = true;
-        for (double num : thetas)
-        {
-            if (num >= 0)
-            {
-                allNegativeThetas = false;
-                break;
-            }
-        }
-
-        if (allNegativeThetas)
-        {
-            return {std::vector<std::vector<double>>(), std::vector<double>()};
-        }
-
-        bool hasPositiveNonInf = false;
-        for (double num : thetas)
-        {
-            if (num > 0 && num != std::numeric_limits<double>::infinity() && num != 0)
-            {
-                hasPositiveNonInf = true;
-                break;
-            }
-        }
-
-        double minTheta;
-        if (!hasPositiveNonInf)
-        {
-            bool hasZero = false;
-            for (double num : thetas)
-            {
-                if (num == 0)
-                {
-                    hasZero = true;
-                    break;
-                }
-            }
-            if (hasZero)
-            {
-                minTheta = 0.0;
-            }
-            else
-            {
-                return {std::vector<std::vector<double>>(), std::vector<double>()};
-            }
-        }
-        else
-        {
-            minTheta = std::numeric_limits<double>::infinity();
-            for (double x : thetas)
-            {
-                if (x > 0 && x != std::numeric_limits<double>::infinity())
-                {
-                    minTheta = std::min(minTheta, x);
-                }
-            }
-        }
-
-        if (minTheta == std::numeric_limits<double>::infinity())
-        {
-            bool hasZero = false;
-            for (double num : thetas)
-            {
-                if (num == 0)
-                {
-                    hasZero = true;
-                    break;
-                }
-            }
-            if (hasZero)
-            {
-                minTheta = 0;
-            }
-            else
-            {
-                return {std::vector<std::vector<double>>(), std::vector<double>()};
-            }
-        }
-
-        int rowIndex = -1;
-        for (int i = 0; i < thetas.size(); i++)
-        {
-            if (thetas[i] == minTheta)
-            {
-                rowIndex = i + 1;
-                break;
-            }
-        }
-
-        double divNumber = tab[rowIndex][colIndex];
-        if (divNumber == 0)
+        if (rowIndex == -1)
         {
-            return {std::vector<std::vector<double>>(), std::vector<double>()};
+            return {};
         }
 
-        std::vector<std::vector<double>> operationTab(tab.size());
-        for (int i = 0; i < tab.size(); i++)
-        {
-            operationTab[i].resize(tab[i].size(), 0.0);
-        }
+        Scalar divNumber = tab(rowIndex, colIndex);
 
         // Divide pivot row
-        for (int j = 0; j < tab[rowIndex].size(); j++)
+        auto pivotMathRow = tab.Row(rowIndex);
+        for (Scalar &val : pivotMathRow)
         {
-            operationTab[rowIndex][j] = tab[rowIndex][j] / divNumber;
-            if (operationTab[rowIndex][j] == -0.0)
+            val = val / divNumber;
+            if (val == Scalar(0))
             {
-                operationTab[rowIndex][j] = 0.0;
+                val = Scalar(0);
             }
         }
 
         // Apply pivot operation to other rows
-        for (int i = 0; i < tab.size(); i++)
-        {
-            if (i == rowIndex)
-            {
-                continue;
-            }
-            for (int j = 0; j < tab[i].size(); j++)
-            {
-                double mathItem = tab[i][j] - (tab[i][colIndex] * operationTab[rowIndex][j]);
-                operationTab[i][j] = mathItem;
-            }
-        }
+        EliminatePivotColumn(tab, rowIndex, colIndex);
+        dualWeights.clear();
 
         // Optional console output (uncomment if needed)
         // std::cout << "the pivot col in primal is " << (colIndex + 1)
@@ -423,7 +587,23 @@ public:
         IMPivotCols.push_back(colIndex);
         IMPivotRows.push_back(rowIndex);
 
-        return {operationTab, thetasCol};
+        return thetasCol;
+    }
+
+    std::pair<TableauType, std::vector<Scalar>> DoPrimalPivotOperation(const TableauType &tab, bool isMin)
+    {
+        TableauType newTab = tab;
+        auto thetasCol = DoPrimalPivotOperationInPlace(newTab, isMin);
+        if (thetasCol.empty())
+            return {TableauType(), std::vector<Scalar>()};
+        return {std::move(newTab), thetasCol};
+    }
+
+    std::pair<std::vector<std::vector<double>>, std::vector<Scalar>> DoPrimalPivotOperation(
+        const std::vector<std::vector<double>> &tab, bool isMin)
+    {
+        auto [newTab, thetasCol] = DoPrimalPivotOperation(TableauType(tab), isMin);
+        return {newTab.ToVectors(), thetasCol};
     }
 
     struct GetInputResult
@@ -436,17 +616,22 @@ public:
     };
 
     GetInputResult GetInput(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
+    {
+        return GetInput(SparseLPModel::FromDense(objFunc, constraints), isMin);
+    }
+
+    GetInputResult GetInput(const SparseLPModel &model, bool isMin)
     {
         int amtOfE = 0, amtOfS = 0;
-        for (const auto &c : constraints)
+        for (int sense : model.senses)
         {
-            if (c.back() == 1 || c.back() == 2)
+            if (sense == 1 || sense == 2)
                 amtOfE++;
             else
                 amtOfS++;
         }
-        auto tab = DoFormulationOperation(objFunc, constraints);
-        return {tab, isMin, amtOfE, amtOfS, static_cast<int>(objFunc.size())};
+        auto tab = DoFormulationOperation(model);
+        return {tab, isMin, amtOfE, amtOfS, model.numCols};
     }
 
     struct DoDualSimplexResult
@@ -461,134 +646,943 @@ public:
 
     DoDualSimplexResult DoDualSimplex(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin, const std::vector<std::vector<double>> *tabOverride = nullptr)
     {
-        std::vector<std::vector<double>> thetaCols;
-        std::vector<std::vector<std::vector<double>>> tableaus;
-        auto [tab, isMinLocal, amtOfE, amtOfS, lenObj] = GetInput(objFunc, constraints, isMin);
-
+        auto model = SparseLPModel::FromDense(objFunc, constraints);
         if (tabOverride)
         {
-            tab = *tabOverride;
-            IMPivotCols.clear();
-            IMPivotRows.clear();
-            IMHeaderRow.pop_back();
+            TableauType startTab(*tabOverride);
+            return SolveTableau(model, isMin, &startTab);
         }
+        return SolveModel(model, isMin);
+    }
 
-        tableaus.push_back(tab);
+    DoDualSimplexResult DoDualSimplex(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin, const TableauType &tabOverride)
+    {
+        return SolveTableau(SparseLPModel::FromDense(objFunc, constraints), isMin, &tabOverride);
+    }
 
-        while (true)
-        {
-            for (auto &items : tableaus.back())
-            {
-                for (double &val : items)
-                {
-                    if (val == -0.0)
-                        val = 0.0;
-                }
-            }
+    DoDualSimplexResult DoDualSimplex(const SparseLPModel &model, bool isMin)
+    {
+        return SolveModel(model, isMin);
+    }
 
-            std::vector<double> rhsTest;
-            for (const auto &row : tableaus.back())
-            {
-                rhsTest.push_back(row.back());
-            }
-            const double epsilon = 1e-9;
-            bool allRhsPositive = std::all_of(rhsTest.begin(), rhsTest.end(), [epsilon](double num)
-                                              { return num >= -epsilon; });
+    DoDualSimplexResult DoDualSimplex(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin, const LPBasis &startBasis)
+    {
+        return DoDualSimplex(SparseLPModel::FromDense(objFunc, constraints), isMin, startBasis);
+    }
 
-            if (allRhsPositive)
-                break;
+    // warm start: the formulation is pivoted onto the basic columns of startBasis and boxed columns marked
+    // AtUpper start at their upper bound. Presolve is skipped since the basis describes the model as given
+    DoDualSimplexResult DoDualSimplex(const SparseLPModel &model, bool isMin, const LPBasis &startBasis)
+    {
+        warmBasis = &startBasis;
+        try
+        {
+            auto res = SolveScaled(model, isMin);
+            warmBasis = nullptr;
+            return res;
+        }
+        catch (...)
+        {
+            warmBasis = nullptr;
+            throw;
+        }
+    }
 
-            auto [newTab, thetaRow] = DoDualPivotOperation(tableaus.back());
-            if (thetaRow.empty())
-            {
-                if (!tabOverride && isConsoleOutput)
-                {
-                    std::cout << "\nNo Optimal Solution Found" << std::endl;
-                }
-                return {tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
-            }
+    // pivots a slack-basis formulation onto the basic columns of basis; rows no basic column can claim keep
+    // their slack, so a short, long or singular basis still gives a valid start. Returns the basic column of each row
+    std::vector<int> PivotOntoBasis(TableauType &tab, int lenObj, const LPBasis &basis)
+    {
+        int m = static_cast<int>(tab.Rows()) - 1;
+        std::vector<int> basicCol(m + 1, -1);
+        for (int i = 0; i < m && i < static_cast<int>(basis.rowStatus.size()); i++)
+        {
+            if (basis.rowStatus[i] == BasisStatus::Basic)
+                basicCol[i + 1] = lenObj + i;
+        }
+
+        // the slack of a row that is never pivoted on keeps its unit column
+        for (int j = 0; j < lenObj && j < static_cast<int>(basis.colStatus.size()); j++)
+        {
+            if (basis.colStatus[j] != BasisStatus::Basic)
+                continue;
 
-            for (auto &items : newTab)
+            int pivotRow = -1;
+            Scalar best = Traits::FeasibilityTolerance();
+            for (int i = 1; i <= m; i++)
             {
-                for (double &val : items)
+                if (basicCol[i] == -1 && Traits::Abs(tab(i, j)) > best)
                 {
-                    if (val == -0.0)
-                        val = 0.0;
+                    best = Traits::Abs(tab(i, j));
+                    pivotRow = i;
                 }
             }
+            if (pivotRow == -1)
+                continue;
 
-            tableaus.push_back(newTab);
-            phases.push_back(0);
+            Scalar pivot = tab(pivotRow, j);
+            for (Scalar &val : tab.Row(pivotRow))
+                val /= pivot;
+            EliminatePivotColumn(tab, pivotRow, j);
+            basicCol[pivotRow] = j;
         }
 
-        std::vector<double> objFuncTest(tableaus.back()[0].begin(), tableaus.back()[0].end() - 1);
-        bool allObjFuncPositive = isMinLocal
-                                      ? std::all_of(objFuncTest.begin(), objFuncTest.end(), [](double num)
-                                                    { return num <= 0; })
-                                      : std::all_of(objFuncTest.begin(), objFuncTest.end(), [](double num)
-                                                    { return num >= 0; });
-
-        if (!allObjFuncPositive)
+        for (int i = 1; i <= m; i++)
         {
-            while (true)
-            {
-                for (auto &items : tableaus.back())
-                {
-                    for (double &val : items)
-                    {
-                        if (val == -0.0)
-                            val = 0.0;
-                    }
-                }
+            if (basicCol[i] == -1)
+                basicCol[i] = lenObj + i - 1;
+        }
+        tab.CleanNegativeZeros();
+        return basicCol;
+    }
 
-                if (tableaus.back().empty())
-                {
-                    if (isConsoleOutput)
-                        std::cout << "\nNo Optimal Solution Found" << std::endl;
-                    break;
-                }
+    std::vector<int> GetPhases()
+    {
+        return phases;
+    }
 
-                objFuncTest = std::vector<double>(tableaus.back()[0].begin(), tableaus.back()[0].end() - 1);
-                allObjFuncPositive = isMinLocal
-                                         ? std::all_of(objFuncTest.begin(), objFuncTest.end(), [](double num)
-                                                       { return num <= 0; })
-                                         : std::all_of(objFuncTest.begin(), objFuncTest.end(), [](double num)
-                                                       { return num >= 0; });
+    LPRResult GetResult()
+    {
+        return result;
+    }
 
-                if (allObjFuncPositive)
-                    break;
+    // reoptimizes a bounded tableau in place, e.g. after one of its bounds has been changed
+    DoDualSimplexResult DoBoundedDualSimplex(BoundedTableau &state, bool isMin)
+    {
+        IMPivotCols.clear();
+        IMPivotRows.clear();
+        dualWeights.clear();
+        return RunBounded(state, isMin);
+    }
 
-                auto [newTab, thetaCol] = DoPrimalPivotOperation(tableaus.back(), isMinLocal);
-                if (thetaCol.empty() && newTab.empty())
-                    break;
+private:
+    // the rhs of feasible rows grows and the reduced costs already on the optimal side move away from zero, by a
+    // different small amount per row and column so the ratio tests stop tying at zero. Each level is 10x larger
+    void Perturb(TableauType &tab, const std::vector<int> &basicCol, bool isMin, int level)
+    {
+        Scalar scale = Traits::IsExact ? Traits::FromDouble(1e-7) : Traits::FeasibilityTolerance() * Scalar(100);
+        for (int k = 1; k < level; k++)
+            scale *= Scalar(10);
+
+        int rows = static_cast<int>(tab.Rows());
+        int cols = static_cast<int>(tab.Cols()) - 1;
+        std::vector<bool> isBasic(cols, false);
+        for (int i = 1; i < rows; i++)
+        {
+            if (basicCol[i] >= 0)
+                isBasic[basicCol[i]] = true;
+        }
+
+        for (int i = 1; i < rows; i++)
+        {
+            if (tab.Rhs(i) >= Scalar(0))
+                tab.Rhs(i) += scale * Traits::FromDouble(PerturbationFactor(i)) * (Scalar(1) + Traits::Abs(tab.Rhs(i)));
+        }
+        for (int j = 0; j < cols; j++)
+        {
+            Scalar d = tab(0, j);
+            if (isBasic[j] || (isMin ? d > Scalar(0) : d < Scalar(0)))
+                continue;
+            Scalar delta = scale * Traits::FromDouble(PerturbationFactor(rows + j)) * (Scalar(1) + Traits::Abs(d));
+            tab(0, j) = isMin ? d - delta : d + delta;
+        }
+    }
+
+    // refactors the unperturbed formulation onto the basis the perturbed pivots reached
+    void RemovePerturbation(TableauType &tab, const std::vector<std::vector<double>> &formulation, int lenObj, std::vector<int> &basicCol)
+    {
+        int m = static_cast<int>(tab.Rows()) - 1;
+        LPBasis basis = BasisFromColumns(std::vector<int>(basicCol.begin() + 1, basicCol.end()), lenObj, m);
+        tab.Assign(formulation);
+        basicCol = PivotOntoBasis(tab, lenObj, basis);
+        dualWeights.clear();
+    }
+
+    // basicCols holds the basic column of each constraint row, -1 where none was found (that row's slack is used)
+    static LPBasis BasisFromColumns(const std::vector<int> &basicCols, int lenObj, int numRows)
+    {
+        LPBasis basis;
+        basis.colStatus.assign(lenObj, BasisStatus::AtLower);
+        basis.rowStatus.assign(numRows, BasisStatus::AtLower);
+        for (int i = 0; i < static_cast<int>(basicCols.size()); i++)
+        {
+            int j = basicCols[i] == -1 ? lenObj + i : basicCols[i];
+            if (j < lenObj)
+                basis.colStatus[j] = BasisStatus::Basic;
+            else if (j - lenObj < numRows)
+                basis.rowStatus[j - lenObj] = BasisStatus::Basic;
+        }
+        return basis;
+    }
+
+    // basic columns in RevisedSimplex numbering: model columns first, then the slack of each row
+    static std::vector<int> BasisColumns(const LPBasis &basis)
+    {
+        std::vector<int> columns;
+        int lenObj = static_cast<int>(basis.colStatus.size());
+        for (int j = 0; j < lenObj; j++)
+        {
+            if (basis.colStatus[j] == BasisStatus::Basic)
+                columns.push_back(j);
+        }
+        for (int i = 0; i < static_cast<int>(basis.rowStatus.size()); i++)
+        {
+            if (basis.rowStatus[i] == BasisStatus::Basic)
+                columns.push_back(lenObj + i);
+        }
+        return columns;
+    }
+
+    static LPBasis BasisFromBounded(const BoundedTableau &bt)
+    {
+        int numRows = static_cast<int>(bt.tab.Rows()) - 1;
+        LPBasis basis = BasisFromColumns(std::vector<int>(bt.basicCol.begin() + 1, bt.basicCol.end()), bt.lenObj, numRows);
+        for (int j = 0; j < bt.NumVars() && j < bt.lenObj + numRows; j++)
+        {
+            if (!bt.atUpper[j] || bt.IsBasic(j))
+                continue;
+            if (j < bt.lenObj)
+                basis.colStatus[j] = BasisStatus::AtUpper;
+            else
+                basis.rowStatus[j - bt.lenObj] = BasisStatus::AtUpper;
+        }
+        return basis;
+    }
+
+    static bool IsBoundedDualFeasible(const BoundedTableau &bt, bool isMin)
+    {
+        for (int j = 0; j < bt.NumVars(); j++)
+        {
+            if (bt.IsBasic(j))
+                continue;
+            double d = bt.tab(0, j);
+            if (isMin ? d > 1e-9 : d < -1e-9)
+                return false;
+        }
+        return true;
+    }
+
+    int SelectBoundedLeavingRow(const BoundedTableau &bt)
+    {
+        bool weighted = dualPricing != DualPricingRule::MostNegativeRhs;
+        if (weighted && dualWeights.size() != bt.tab.Rows())
+            InitDualWeights(bt.tab);
+
+        int pivotRow = -1;
+        double bestScore = 0.0;
+        for (int i = 1; i < static_cast<int>(bt.tab.Rows()); i++)
+        {
+            double infeasibility = std::abs(bt.RowInfeasibility(i));
+            if (infeasibility <= 1e-9)
+                continue;
+            double score = weighted ? infeasibility * infeasibility / dualWeights[i] : infeasibility;
+            if (score > bestScore + EPS)
+            {
+                bestScore = score;
+                pivotRow = i;
+            }
+        }
+        return pivotRow;
+    }
+
+    void PivotBounded(BoundedTableau &bt, int r, int q)
+    {
+        Tableau &tab = bt.tab;
+        double divNumber = tab(r, q);
+        for (double &val : tab.Row(r))
+        {
+            val = val / divNumber;
+            if (val == -0.0)
+                val = 0.0;
+        }
+        EliminatePivotColumn(tab, r, q);
+        tab.CleanNegativeZeros();
+        bt.SetBasic(r, q);
+
+        IMPivotCols.push_back(q);
+        IMPivotRows.push_back(r);
+    }
+
+    // dual simplex with a bound flipping ratio test; ignoreCosts treats every reduced cost as zero so it
+    // can restore primal feasibility from a start that is not dual feasible. Returns false when infeasible.
+    bool BoundedDualPhase(BoundedTableau &bt, bool ignoreCosts, std::vector<std::vector<std::vector<double>>> &tableaus, int &iterations, int maxIterations)
+    {
+        struct Breakpoint
+        {
+            double theta;
+            double alpha;
+            int col;
+        };
+
+        Tableau &tab = bt.tab;
+        bool keepHistory = historyMode == TableauHistory::Full;
+        std::vector<Breakpoint> points;
+
+        while (iterations++ < maxIterations)
+        {
+            int r = SelectBoundedLeavingRow(bt);
+            if (r == -1)
+                return true;
+
+            // a basic variable above its upper bound leaves at that bound, so measure it from there
+            if (bt.RowInfeasibility(r) > 0.0)
+                bt.Complement(bt.basicCol[r]);
+
+            points.clear();
+            for (int j = 0; j < bt.NumVars(); j++)
+            {
+                double a = tab(r, j);
+                if (bt.IsBasic(j) || a >= -EPS)
+                    continue;
+                double theta = ignoreCosts ? 0.0 : std::abs(tab(0, j)) / -a;
+                points.push_back({theta, -a, j});
+            }
+            std::sort(points.begin(), points.end(), [](const Breakpoint &a, const Breakpoint &b)
+                      {
+                          if (a.theta != b.theta)
+                              return a.theta < b.theta;
+                          if (a.alpha != b.alpha)
+                              return a.alpha > b.alpha;
+                          return a.col < b.col; });
+
+            // the dual objective keeps improving while the remaining infeasibility (slope) stays positive
+            double slope = -tab.Rhs(r);
+            int entering = -1;
+            std::vector<int> flips;
+            for (const auto &point : points)
+            {
+                if (boundFlipping && bt.IsBoxed(point.col))
+                {
+                    double after = slope - point.alpha * bt.Range(point.col);
+                    if (after > 1e-9)
+                    {
+                        flips.push_back(point.col);
+                        slope = after;
+                        continue;
+                    }
+                }
+                entering = point.col;
+                break;
+            }
+
+            if (entering == -1)
+                return false;
+
+            for (int j : flips)
+                bt.Complement(j);
+
+            if (dualPricing != DualPricingRule::MostNegativeRhs)
+                UpdateDualWeights(tab, r, entering);
+            PivotBounded(bt, r, entering);
+
+            if (isConsoleOutput)
+            {
+                std::cout << "the pivot col in Dual is " << entering + 1 << " and the pivot row is " << r + 1
+                          << " after " << flips.size() << " bound flips" << std::endl;
+            }
 
-                try
+            if (keepHistory)
+                tableaus.push_back(tab.ToVectors());
+            phases.push_back(0);
+        }
+        return true;
+    }
+
+    // primal simplex where the entering column may stop at its own upper bound or drive a basic
+    // variable to either of its bounds
+    PrimalPhaseEnd BoundedPrimalPhase(BoundedTableau &bt, bool isMin, std::vector<std::vector<std::vector<double>>> &tableaus, int &iterations, int maxIterations)
+    {
+        Tableau &tab = bt.tab;
+        bool keepHistory = historyMode == TableauHistory::Full;
+
+        while (iterations++ < maxIterations)
+        {
+            int q = -1;
+            double best = 1e-9;
+            for (int j = 0; j < bt.NumVars(); j++)
+            {
+                if (bt.IsBasic(j))
+                    continue;
+                double d = isMin ? tab(0, j) : -tab(0, j);
+                if (d > best)
                 {
-                    thetaCols.push_back(thetaCol);
+                    best = d;
+                    q = j;
                 }
-                catch (...)
+            }
+            if (q == -1)
+                return PrimalPhaseEnd::Optimal;
+
+            double bestTheta = bt.Range(q);
+            int leaveRow = -1;
+            bool leaveAtUpper = false;
+            double leaveAlpha = 0.0;
+            for (int i = 1; i < static_cast<int>(tab.Rows()); i++)
+            {
+                double a = tab(i, q);
+                double theta;
+                bool toUpper = false;
+                if (a > EPS)
                 {
+                    theta = std::max(tab.Rhs(i), 0.0) / a;
+                }
+                else if (a < -EPS && bt.IsBoxed(bt.basicCol[i]))
+                {
+                    theta = std::max(bt.Range(bt.basicCol[i]) - tab.Rhs(i), 0.0) / -a;
+                    toUpper = true;
+                }
+                else
+                {
+                    continue;
+                }
+                if (theta < bestTheta - EPS || (theta <= bestTheta + EPS && leaveRow != -1 && std::abs(a) > leaveAlpha))
+                {
+                    bestTheta = theta;
+                    leaveRow = i;
+                    leaveAtUpper = toUpper;
+                    leaveAlpha = std::abs(a);
+                }
+            }
+
+            // no bound of its own and no row stops the entering column
+            if (!std::isfinite(bestTheta))
+                return PrimalPhaseEnd::Unbounded;
+
+            if (leaveRow == -1)
+            {
+                bt.Complement(q);
+            }
+            else
+            {
+                if (leaveAtUpper)
+                    bt.Complement(bt.basicCol[leaveRow]);
+                PivotBounded(bt, leaveRow, q);
+            }
+            dualWeights.clear();
+
+            if (keepHistory)
+                tableaus.push_back(tab.ToVectors());
+            phases.push_back(1);
+        }
+        return PrimalPhaseEnd::IterationLimit;
+    }
+
+    DoDualSimplexResult RunBounded(BoundedTableau &bt, bool isMin)
+    {
+        std::vector<std::vector<std::vector<double>>> tableaus;
+        bool keepHistory = historyMode == TableauHistory::Full;
+        finalBasis = {};
+
+        bt.tab.CleanNegativeZeros();
+        if (keepHistory)
+            tableaus.push_back(bt.tab.ToVectors());
+
+        int iterations = 0;
+        int maxIterations = 50 * static_cast<int>(bt.tab.Rows() + bt.tab.Cols()) + 1000;
+
+        bool feasible = !bt.HasEmptyRange() &&
+                        BoundedDualPhase(bt, !IsBoundedDualFeasible(bt, isMin), tableaus, iterations, maxIterations);
+        PrimalPhaseEnd end = PrimalPhaseEnd::IterationLimit;
+        if (feasible)
+            end = BoundedPrimalPhase(bt, isMin, tableaus, iterations, maxIterations);
+        if (end != PrimalPhaseEnd::Optimal)
+        {
+            if (isConsoleOutput)
+                std::cout << (end == PrimalPhaseEnd::Unbounded ? "\nUnbounded" : "\nNo Optimal Solution Found") << std::endl;
+            if (!keepHistory)
+                tableaus.push_back(bt.tab.ToVectors());
+            return {tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
+        }
+
+        if (!keepHistory)
+            tableaus.push_back(bt.tab.ToVectors());
+
+        std::vector<double> changingVars(bt.lenObj);
+        for (int j = 0; j < bt.lenObj; j++)
+            changingVars[j] = bt.Value(j);
+        double optimalSolution = bt.tab.Rhs(0);
+        finalBasis = BasisFromBounded(bt);
+
+        result.tableaus = tableaus;
+        result.pivotCols = IMPivotCols;
+        result.pivotRows = IMPivotRows;
+        result.headerRow = IMHeaderRow;
+        result.phases = phases;
+        result.optimalSolution = optimalSolution;
+        result.changingVars = changingVars;
+
+        return {tableaus, changingVars, optimalSolution, IMPivotCols, IMPivotRows, IMHeaderRow};
+    }
+
+    DoDualSimplexResult SolveBounded(const SparseLPModel &model, bool isMin)
+    {
+        auto [tab, isMinLocal, amtOfE, amtOfS, lenObj] = GetInput(model, isMin);
+
+        // the formulation starts from the slack basis unless a warm start basis was given
+        Tableau start(tab);
+        std::vector<int> basicCol(tab.size(), -1);
+        if (warmBasis)
+        {
+            basicCol = PivotOntoBasis(start, lenObj, *warmBasis);
+        }
+        else
+        {
+            for (int i = 1; i < static_cast<int>(tab.size()); i++)
+                basicCol[i] = lenObj + i - 1;
+        }
+
+        boundedState = BoundedTableau(std::move(start), basicCol, lenObj);
+        for (int j = 0; j < lenObj; j++)
+        {
+            double lower = j < static_cast<int>(boundLower.size()) ? boundLower[j] : 0.0;
+            double upper = j < static_cast<int>(boundUpper.size()) ? boundUpper[j] : std::numeric_limits<double>::infinity();
+            boundedState.SetBounds(j, lower, upper);
+        }
+
+        if (warmBasis)
+        {
+            for (int j = 0; j < lenObj && j < static_cast<int>(warmBasis->colStatus.size()); j++)
+            {
+                if (warmBasis->colStatus[j] == BasisStatus::AtUpper && boundedState.IsBoxed(j) && !boundedState.IsBasic(j))
+                    boundedState.Complement(j);
+            }
+        }
+
+        dualWeights.clear();
+        return RunBounded(boundedState, isMinLocal);
+    }
+
+    // a start tableau without a unit column in every row has no basis to factor, so it stays on the dense path
+    DoDualSimplexResult SolveRevised(const SparseLPModel &model, bool isMin, const Tableau *tabOverride)
+    {
+        RevisedSimplex revised(isConsoleOutput);
+        RevisedSimplex::RevisedSimplexResult res;
+        if (tabOverride)
+        {
+            res = revised.DoRevisedSimplex(*tabOverride, isMin);
+            IMPivotCols.clear();
+            IMPivotRows.clear();
+        }
+        else if (warmBasis && BasisColumns(*warmBasis).size() == static_cast<std::size_t>(model.numRows))
+        {
+            // a complete basis is factored straight from the sparse model
+            res = warmPoint ? revised.DoRevisedSimplex(model, isMin, BasisColumns(*warmBasis), *warmPoint)
+                            : revised.DoRevisedSimplex(model, isMin, BasisColumns(*warmBasis));
+            IMHeaderRow.insert(IMHeaderRow.end(), res.headerRow.begin(), res.headerRow.end());
+        }
+        else if (warmBasis)
+        {
+            auto input = GetInput(model, isMin);
+            Tableau start(input.tab);
+            PivotOntoBasis(start, input.lenObj, *warmBasis);
+            res = revised.DoRevisedSimplex(start, isMin);
+        }
+        else
+        {
+            res = revised.DoRevisedSimplex(model, isMin);
+            IMHeaderRow.insert(IMHeaderRow.end(), res.headerRow.begin(), res.headerRow.end());
+        }
+
+        IMPivotCols.insert(IMPivotCols.end(), res.pivotCols.begin(), res.pivotCols.end());
+        IMPivotRows.insert(IMPivotRows.end(), res.pivotRows.begin(), res.pivotRows.end());
+        phases.insert(phases.end(), revised.GetPhases().begin(), revised.GetPhases().end());
+
+        revisedStatus = revised.GetStatus();
+        if (revisedStatus != RevisedSimplexStatus::Optimal)
+        {
+            if (!tabOverride && isConsoleOutput)
+            {
+                std::cout << "\nNo Optimal Solution Found" << std::endl;
+            }
+            return {res.tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
+        }
+
+        res.changingVars.resize(model.numCols, 0.0);
+        if (!tabOverride)
+            finalBasis = BasisFromColumns(revised.GetBasis(), model.numCols, model.numRows);
+
+        result.tableaus = res.tableaus;
+        result.pivotCols = IMPivotCols;
+        result.pivotRows = IMPivotRows;
+        result.headerRow = IMHeaderRow;
+        result.phases = phases;
+        result.optimalSolution = res.optimalSolution;
+        result.changingVars = res.changingVars;
+
+        return {res.tableaus, res.changingVars, res.optimalSolution, IMPivotCols, IMPivotRows, IMHeaderRow};
+    }
+
+    // crossover: the revised engine pushes the interior solution to a vertex from the basis it points at,
+    // so the result carries an optimal tableau like any other solve
+    DoDualSimplexResult SolveInteriorPoint(const SparseLPModel &model, bool isMin)
+    {
+        InteriorPoint ipm(isConsoleOutput);
+        interiorPointResult = ipm.DoInteriorPoint(model, isMin);
+        LPBasis crossoverBasis = ipm.IdentifyBasis();
+        std::vector<double> crossoverPoint = ipm.CrossoverPoint();
+
+        warmBasis = &crossoverBasis;
+        if (interiorPointResult.status == InteriorPointStatus::Optimal)
+            warmPoint = &crossoverPoint;
+        try
+        {
+            auto res = SolveRevised(model, isMin, nullptr);
+            warmBasis = nullptr;
+            warmPoint = nullptr;
+            return res;
+        }
+        catch (...)
+        {
+            warmBasis = nullptr;
+            warmPoint = nullptr;
+            throw;
+        }
+    }
+
+    DoDualSimplexResult SolveModel(const SparseLPModel &model, bool isMin)
+    {
+        if (!presolveEnabled)
+        {
+            return SolveScaled(model, isMin);
+        }
+
+        // models presolve proves infeasible or unbounded are solved as given so the usual result comes back
+        Presolve presolve;
+        auto reduced = presolve.DoPresolve(model, isMin, boundLower, boundUpper);
+        presolveStats = reduced.stats;
+        if (reduced.status != PresolveStatus::Reduced)
+        {
+            return SolveTableau(model, isMin, nullptr);
+        }
+
+        // the reduced model numbers its columns afresh, so its bounds are swapped in for the solve
+        auto lower = boundLower;
+        auto upper = boundUpper;
+        if (HasVariableBounds())
+        {
+            boundLower = reduced.colLower;
+            boundUpper = reduced.colUpper;
+        }
+        auto res = SolveScaled(reduced.model, isMin);
+        boundLower = lower;
+        boundUpper = upper;
+
+        if (std::isnan(res.optimalSolution))
+        {
+            return res;
+        }
+
+        auto post = presolve.DoPostsolve(res.changingVars, res.optimalSolution);
+        finalBasis = presolve.PostsolveBasis(finalBasis);
+        res.changingVars = post.changingVars;
+        res.optimalSolution = post.optimalSolution;
+        result.changingVars = res.changingVars;
+        result.optimalSolution = res.optimalSolution;
+        return res;
+    }
+
+    DoDualSimplexResult SolveScaled(const SparseLPModel &model, bool isMin)
+    {
+        if (!scalingEnabled)
+        {
+            return SolveTableau(model, isMin, nullptr);
+        }
+
+        LPScaling scaling;
+        scaling.Compute(model);
+
+        // the bounded path reads the bounds of x' = x / colScale during the solve
+        auto lower = boundLower;
+        auto upper = boundUpper;
+        boundLower = scaling.ScaleBounds(lower);
+        boundUpper = scaling.ScaleBounds(upper);
+        auto res = SolveTableau(scaling.ScaleModel(model), isMin, nullptr);
+        boundLower = lower;
+        boundUpper = upper;
+
+        if (std::isnan(res.optimalSolution))
+        {
+            return res;
+        }
+
+        res.changingVars = scaling.UnscaleSolution(res.changingVars);
+        result.changingVars = res.changingVars;
+        return res;
+    }
+
+    DoDualSimplexResult SolveTableau(const SparseLPModel &model, bool isMin, const TableauType *tabOverride)
+    {
+        finalBasis = {};
+        if constexpr (IsDouble)
+        {
+            if (!tabOverride && HasVariableBounds())
+            {
+                return SolveBounded(model, isMin);
+            }
+
+            if (engine == SimplexEngine::InteriorPoint && !tabOverride)
+            {
+                return warmBasis ? SolveRevised(model, isMin, nullptr) : SolveInteriorPoint(model, isMin);
+            }
+
+            if (engine == SimplexEngine::Revised && (!tabOverride || RevisedSimplex::CanStartFrom(*tabOverride)))
+            {
+                return SolveRevised(model, isMin, tabOverride);
+            }
+        }
+        else if (HasVariableBounds() || engine != SimplexEngine::Dense)
+        {
+            throw std::invalid_argument("Variable bounds and the revised and interior point engines need the double solver.");
+        }
+
+        std::vector<std::vector<Scalar>> thetaCols;
+        std::vector<std::vector<std::vector<double>>> tableaus;
+        auto [tab, isMinLocal, amtOfE, amtOfS, lenObj] = GetInput(model, isMin);
+        dualWeights.clear();
+
+        TableauType current;
+        std::vector<int> warmStartCols;
+        if (tabOverride)
+        {
+            current = *tabOverride;
+            IMPivotCols.clear();
+            IMPivotRows.clear();
+            IMHeaderRow.pop_back();
+        }
+        else
+        {
+            current.Assign(tab);
+            if (warmBasis)
+                warmStartCols = PivotOntoBasis(current, lenObj, *warmBasis);
+        }
+
+        // in FinalOnly mode previous holds the tableau before the latest pivot so it can be restored
+        bool keepHistory = historyMode == TableauHistory::Full;
+        TableauType previous;
+
+        current.CleanNegativeZeros();
+        if (keepHistory)
+            tableaus.push_back(current.ToVectors());
+
+        // exact arithmetic has no rounding to knock the ratio tests off a cycle
+        int iterations = 0;
+        int maxIterations = 50 * static_cast<int>(current.Rows() + current.Cols()) + 1000;
+
+        // basic column of each row (row 0 unused), followed through the pivots for the cycle detector and the
+        // perturbation. Override tableaus only detect cycles, since removing a perturbation refactors the model
+        degeneracyStats = {};
+        std::vector<int> basicCol(current.Rows(), -1);
+        if (tabOverride)
+        {
+            std::vector<int> unitBasis;
+            if constexpr (IsDouble)
+                unitBasis = RevisedSimplex::FindUnitBasis(current);
+            else
+                unitBasis = RevisedSimplex::FindUnitBasis(Tableau(current.ToVectors()));
+            std::copy(unitBasis.begin(), unitBasis.end(), basicCol.begin() + 1);
+        }
+        else if (warmBasis)
+        {
+            basicCol = warmStartCols;
+        }
+        else
+        {
+            for (int i = 1; i < static_cast<int>(current.Rows()); i++)
+                basicCol[i] = lenObj + i - 1;
+        }
+        BasisCycleDetector cycleDetector;
+        cycleDetector.Reset(basicCol);
+        int stalledPivots = 0;
+        bool perturbed = false;
+        bool canPerturb = antiDegeneracy && !tabOverride;
+        std::size_t cleanupStart = 0;
+
+        auto recordPivot = [&](const Scalar &objectiveBefore)
+        {
+            int row = IMPivotRows.back();
+            bool cycled = cycleDetector.Pivot(basicCol[row], IMPivotCols.back());
+            basicCol[row] = IMPivotCols.back();
+
+            if (Traits::Abs(current.Rhs(0) - objectiveBefore) <= Traits::PivotTolerance() * (Scalar(1) + Traits::Abs(objectiveBefore)))
+            {
+                degeneracyStats.degeneratePivots++;
+                stalledPivots++;
+            }
+            else
+            {
+                stalledPivots = 0;
+            }
+            if (cycled)
+                degeneracyStats.cyclesDetected++;
+
+            if (canPerturb && (cycled || stalledPivots > STALL_LIMIT) && degeneracyStats.perturbations < MAX_PERTURBATIONS)
+            {
+                Perturb(current, basicCol, isMinLocal, ++degeneracyStats.perturbations);
+                perturbed = true;
+                stalledPivots = 0;
+                cycleDetector.Reset(basicCol);
+            }
+        };
+
+        auto isObjRowOptimal = [isMinLocal](const TableauType &t)
+        {
+            const Scalar eps = Traits::PivotTolerance();
+            auto objFuncTest = t.Row(0).first(t.Cols() - 1);
+            return isMinLocal
+                       ? std::all_of(objFuncTest.begin(), objFuncTest.end(), [&eps](const Scalar &num)
+                                     { return num <= eps; })
+                       : std::all_of(objFuncTest.begin(), objFuncTest.end(), [&eps](const Scalar &num)
+                                     { return num >= -eps; });
+        };
+
+        // a perturbed pass is followed by a clean-up pass on the unperturbed model, started from the same basis
+        while (true)
+        {
+            while (true)
+            {
+                // row 0 holds the objective, whose sign says nothing about feasibility
+                const Scalar epsilon = Traits::FeasibilityTolerance();
+                bool allRhsPositive = true;
+                for (size_t i = 1; i < current.Rows(); i++)
+                {
+                    if (current.Rhs(i) < -epsilon)
+                    {
+                        allRhsPositive = false;
+                        break;
+                    }
+                }
+
+                if (allRhsPositive)
                     break;
+
+                if (!keepHistory)
+                    previous.CopyFrom(current);
+
+                Scalar objectiveBefore = current.Rhs(0);
+                auto thetaRow = iterations++ < maxIterations ? DoDualPivotOperationInPlace(current) : std::vector<Scalar>();
+                if (thetaRow.empty())
+                {
+                    if (!tabOverride && isConsoleOutput)
+                    {
+                        std::cout << "\nNo Optimal Solution Found" << std::endl;
+                    }
+                    if (!keepHistory)
+                        tableaus.push_back(current.ToVectors());
+                    return {tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
                 }
-                tableaus.push_back(newTab);
-                phases.push_back(1);
+                recordPivot(objectiveBefore);
+
+                current.CleanNegativeZeros();
+                if (keepHistory)
+                    tableaus.push_back(current.ToVectors());
+                phases.push_back(0);
             }
 
-            std::vector<double> rhsTest;
-            for (const auto &row : tableaus.back())
+            bool primalNeeded = !isObjRowOptimal(current);
+            if (primalNeeded)
+            {
+                while (true)
+                {
+                    if (current.Empty())
+                    {
+                        if (isConsoleOutput)
+                            std::cout << "\nNo Optimal Solution Found" << std::endl;
+                        break;
+                    }
+
+                    if (isObjRowOptimal(current))
+                        break;
+
+                    if (!keepHistory)
+                        previous.CopyFrom(current);
+
+                    // hitting the cap means no optimum was reached, reported the same way as the dual loop
+                    if (iterations++ >= maxIterations)
+                    {
+                        if (!tabOverride && isConsoleOutput)
+                        {
+                            std::cout << "\nNo Optimal Solution Found" << std::endl;
+                        }
+                        if (!keepHistory)
+                            tableaus.push_back(current.ToVectors());
+                        return {tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
+                    }
+
+                    // the row is not optimal, so no pivot means no row bounds the entering column: unbounded
+                    Scalar objectiveBefore = current.Rhs(0);
+                    auto thetaCol = DoPrimalPivotOperationInPlace(current, isMinLocal);
+                    if (thetaCol.empty())
+                    {
+                        if (!tabOverride && isConsoleOutput)
+                        {
+                            std::cout << "\nNo Optimal Solution Found" << std::endl;
+                        }
+                        if (!keepHistory)
+                            tableaus.push_back(current.ToVectors());
+                        return {tableaus, {}, std::numeric_limits<double>::quiet_NaN(), {}, {}, {}};
+                    }
+                    recordPivot(objectiveBefore);
+
+                    try
+                    {
+                        thetaCols.push_back(thetaCol);
+                    }
+                    catch (...)
+                    {
+                        break;
+                    }
+                    current.CleanNegativeZeros();
+                    if (keepHistory)
+                        tableaus.push_back(current.ToVectors());
+                    phases.push_back(1);
+                }
+            }
+
+            if (perturbed)
             {
-                rhsTest.push_back(row.back());
+                // the last tableau shown becomes the unperturbed one for the same basis
+                RemovePerturbation(current, tab, lenObj, basicCol);
+                cycleDetector.Reset(basicCol);
+                perturbed = false;
+                canPerturb = false;
+                cleanupStart = IMPivotCols.size();
+                if (keepHistory)
+                    tableaus.back() = current.ToVectors();
+                continue;
             }
-            bool allRhsPositive = std::all_of(rhsTest.begin(), rhsTest.end(), [](double num)
-                                              { return num >= 0; });
 
-            if (!allRhsPositive)
+            if (primalNeeded)
             {
-                tableaus.pop_back();
-                IMPivotCols.pop_back();
-                IMPivotRows.pop_back();
+                bool allRhsPositive = true;
+                for (size_t i = 1; i < current.Rows(); i++)
+                {
+                    if (current.Rhs(i) < -Traits::FeasibilityTolerance())
+                    {
+                        allRhsPositive = false;
+                        break;
+                    }
+                }
+
+                if (!allRhsPositive)
+                {
+                    if (keepHistory)
+                    {
+                        tableaus.pop_back();
+                    }
+                    else if (!previous.Empty())
+                    {
+                        std::swap(current, previous);
+                    }
+                    IMPivotCols.pop_back();
+                    IMPivotRows.pop_back();
+                }
             }
+            break;
         }
+        if (degeneracyStats.perturbations > 0 && IMPivotCols.size() > cleanupStart)
+            degeneracyStats.cleanupPivots = static_cast<int>(IMPivotCols.size() - cleanupStart);
+
+        if (!keepHistory)
+            tableaus.push_back(current.ToVectors());
 
         if (isConsoleOutput)
         {
@@ -680,6 +1674,13 @@ public:
         }
 
         double optimalSolution = tableaus.back()[0].back();
+        if (!tabOverride)
+        {
+            if constexpr (IsDouble)
+                finalBasis = BasisFromColumns(RevisedSimplex::FindUnitBasis(current), lenObj, static_cast<int>(current.Rows()) - 1);
+            else
+                finalBasis = BasisFromColumns(RevisedSimplex::FindUnitBasis(Tableau(current.ToVectors())), lenObj, static_cast<int>(current.Rows()) - 1);
+        }
 
         result.tableaus = tableaus;
         result.pivotCols = IMPivotCols;
@@ -691,14 +1692,6 @@ public:
 
         return {tableaus, changingVars, optimalSolution, IMPivotCols, IMPivotRows, IMHeaderRow};
     }
+};
 
-    std::vector<int> GetPhases()
-    {
-        return phases;
-    }
-
-    LPRResult GetResult()
-    {
-        return result;
-    }
-};
\ No newline at end of file
+using DualSimplex = BasicDualSimplex<double>;
@@ -46,6 +46,7 @@ public:
     Duality(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput)
     {
         dual = new DualSimplex();
+        dual->SetHistoryMode(TableauHistory::FinalOnly);
 
         objFunc = {0.0, 0.0};
         optimalSolution = 0.0;
@@ -59,6 +60,8 @@ public:
         delete dual;
     }
 
+    void SetSimplexEngine(SimplexEngine engine) { dual->SetEngine(engine); }
+
     template <typename T>
     std::vector<std::vector<T>> TransposeMat(const std::vector<std::vector<T>> &matrix)
     {
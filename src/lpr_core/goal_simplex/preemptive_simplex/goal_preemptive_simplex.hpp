@@ -9,6 +9,9 @@
 #include <limits>
 #include <stdexcept>
 
+#include "pivot_kernel.hpp"
+#include "lp_scaling.hpp"
+
 class GoalPreemptiveSimplex
 {
 public:
@@ -443,11 +446,7 @@ public:
         {
             if (i == pivotRow)
                 continue;
-            double mult = oldTab[i][pivotCol];
-            for (int j = 0; j < C; ++j)
-            {
-                newTab[i][j] = oldTab[i][j] - mult * newTab[pivotRow][j];
-            }
+            PivotKernel::RowUpdate(newTab[i].data(), oldTab[i].data(), newTab[pivotRow].data(), oldTab[i][pivotCol], C, pivotKernelMode);
         }
 
         // Clean tiny values
@@ -492,6 +491,15 @@ public:
         // Deep copy equivalents
         auto a = goals;
         auto b = constraints;
+
+        // only the hard constraint rows are scaled; each keeps a unit slack, so the ratio tests and the
+        // goal rows that pick entering columns see the same values and the pivot sequence is unchanged
+        if (scalingEnabled && !b.empty())
+        {
+            LPScaling scaling;
+            scaling.Compute({&b}, static_cast<int>(a.back().size()) - 2, true, false);
+            b = scaling.ScaleRows(b);
+        }
         auto originalGoals = goals;
         std::vector<std::vector<std::vector<double>>> tableaus;
 
@@ -1069,6 +1077,9 @@ public:
         return {tableaus, goalMetStrings, opTable};
     }
 
+    void SetPivotKernelMode(PivotKernelMode mode) { pivotKernelMode = mode; }
+    void SetScaling(bool enable) { scalingEnabled = enable; }
+
     // Getters for accessing private members
     // const std::vector<std::string> &getGuiHeaderRow() const { return GuiHeaderRow; }
     // const std::vector<int> &getGuiPivotCols() const { return GuiPivotCols; }
@@ -1097,6 +1108,8 @@ public:
 
 private:
     bool isConsoleOutput;
+    PivotKernelMode pivotKernelMode = PivotKernelMode::Strict;
+    bool scalingEnabled = false;
 
     int testInputSelected;
 
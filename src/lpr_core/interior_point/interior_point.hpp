@@ -0,0 +1,469 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#include "lp_model.hpp"
+
+// Infeasible and Unbounded are read off a diverging iterate (dual or primal) and are not certificates;
+// the crossover simplex in DualSimplex confirms them
+enum class InteriorPointStatus
+{
+    Optimal,
+    Infeasible,
+    Unbounded,
+    IterationLimit
+};
+
+// Mehrotra predictor-corrector interior-point method on the same model input as the simplex engines.
+// Every row gets a slack or excess column so the LP becomes min c'z, Az = b, z >= 0, and each
+// iteration solves the normal equations A D A^T dy = r through a dense Cholesky factorization of the
+// m x m matrix, so the cost grows with the row count rather than the number of pivots.
+class InteriorPoint
+{
+private:
+    bool isConsoleOutput;
+    int maxIterations = 100;
+    double tolerance = 1e-8;
+    InteriorPointStatus status = InteriorPointStatus::IterationLimit;
+
+    static constexpr double STEP_FRACTION = 0.99;
+    static constexpr double DIVERGENCE_LIMIT = 1e12;
+
+    // standard form in compressed sparse column form, slack columns included
+    int numRows = 0;
+    int numCols = 0;
+    int lenObj = 0;
+    std::vector<int> colStart;
+    std::vector<int> rowIndex;
+    std::vector<double> values;
+    std::vector<double> rhs;
+    std::vector<double> cost;
+    bool isMin = false;
+
+    // primal iterate, row duals and dual slacks
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> s;
+
+    // Cholesky factor of A D A^T, lower triangle of a row-major numRows x numRows matrix
+    std::vector<double> factor;
+
+    void Load(const SparseLPModel &model, bool minimize)
+    {
+        isMin = minimize;
+        numRows = model.numRows;
+        lenObj = model.numCols;
+        numCols = lenObj + numRows;
+        colStart.assign(model.colStart.begin(), model.colStart.end());
+        rowIndex.assign(model.rowIndex.begin(), model.rowIndex.end());
+        values.assign(model.values.begin(), model.values.end());
+        for (int i = 0; i < numRows; i++)
+        {
+            rowIndex.push_back(i);
+            values.push_back(model.IsGreaterEqual(i) ? -1.0 : 1.0);
+            colStart.push_back(static_cast<int>(rowIndex.size()));
+        }
+        rhs = model.rhs;
+        cost.assign(numCols, 0.0);
+        for (int j = 0; j < lenObj; j++)
+            cost[j] = isMin ? model.objective[j] : -model.objective[j];
+    }
+
+    std::vector<double> MultiplyA(const std::vector<double> &v) const
+    {
+        std::vector<double> out(numRows, 0.0);
+        for (int j = 0; j < numCols; j++)
+        {
+            if (v[j] == 0.0)
+                continue;
+            for (int k = colStart[j]; k < colStart[j + 1]; k++)
+                out[rowIndex[k]] += values[k] * v[j];
+        }
+        return out;
+    }
+
+    std::vector<double> MultiplyAT(const std::vector<double> &w) const
+    {
+        std::vector<double> out(numCols, 0.0);
+        for (int j = 0; j < numCols; j++)
+        {
+            double sum = 0.0;
+            for (int k = colStart[j]; k < colStart[j + 1]; k++)
+                sum += values[k] * w[rowIndex[k]];
+            out[j] = sum;
+        }
+        return out;
+    }
+
+    // forms and factors A D A^T; only the lower triangle is filled. A pivot that collapses relative to
+    // the diagonal is replaced by a huge value, which zeroes that component of the solve instead of failing
+    void FactorNormalMatrix(const std::vector<double> &d)
+    {
+        int m = numRows;
+        factor.assign(static_cast<std::size_t>(m) * m, 0.0);
+        for (int j = 0; j < numCols; j++)
+        {
+            for (int k1 = colStart[j]; k1 < colStart[j + 1]; k1++)
+            {
+                double scaled = d[j] * values[k1];
+                for (int k2 = colStart[j]; k2 < colStart[j + 1]; k2++)
+                {
+                    if (rowIndex[k2] <= rowIndex[k1])
+                        factor[static_cast<std::size_t>(rowIndex[k1]) * m + rowIndex[k2]] += scaled * values[k2];
+                }
+            }
+        }
+
+        double maxDiag = 0.0;
+        for (int i = 0; i < m; i++)
+            maxDiag = std::max(maxDiag, factor[static_cast<std::size_t>(i) * m + i]);
+
+        for (int k = 0; k < m; k++)
+        {
+            double *rowK = &factor[static_cast<std::size_t>(k) * m];
+            double diag = rowK[k];
+            for (int p = 0; p < k; p++)
+                diag -= rowK[p] * rowK[p];
+            diag = diag <= 1e-30 * std::max(maxDiag, 1.0) ? 1e64 : std::sqrt(diag);
+            rowK[k] = diag;
+
+            for (int i = k + 1; i < m; i++)
+            {
+                double *rowI = &factor[static_cast<std::size_t>(i) * m];
+                double sum = rowI[k];
+                for (int p = 0; p < k; p++)
+                    sum -= rowI[p] * rowK[p];
+                rowI[k] = sum / diag;
+            }
+        }
+    }
+
+    std::vector<double> SolveNormal(std::vector<double> b) const
+    {
+        int m = numRows;
+        for (int i = 0; i < m; i++)
+        {
+            const double *rowI = &factor[static_cast<std::size_t>(i) * m];
+            for (int p = 0; p < i; p++)
+                b[i] -= rowI[p] * b[p];
+            b[i] /= rowI[i];
+        }
+        for (int i = m - 1; i >= 0; i--)
+        {
+            for (int p = i + 1; p < m; p++)
+                b[i] -= factor[static_cast<std::size_t>(p) * m + i] * b[p];
+            b[i] /= factor[static_cast<std::size_t>(i) * m + i];
+        }
+        return b;
+    }
+
+    // Newton step for A dx = -rb, A^T dy + ds = -rc, S dx + X ds = rxs, through the factored normal matrix
+    void SolveNewton(const std::vector<double> &d, const std::vector<double> &rb, const std::vector<double> &rc, const std::vector<double> &rxs,
+                     std::vector<double> &dx, std::vector<double> &dy, std::vector<double> &ds) const
+    {
+        std::vector<double> t(numCols);
+        for (int j = 0; j < numCols; j++)
+            t[j] = rxs[j] / s[j] + d[j] * rc[j];
+
+        std::vector<double> rhsNormal = MultiplyA(t);
+        for (int i = 0; i < numRows; i++)
+            rhsNormal[i] = -rb[i] - rhsNormal[i];
+        dy = SolveNormal(rhsNormal);
+
+        std::vector<double> aty = MultiplyAT(dy);
+        dx.resize(numCols);
+        ds.resize(numCols);
+        for (int j = 0; j < numCols; j++)
+        {
+            dx[j] = t[j] + d[j] * aty[j];
+            ds[j] = -rc[j] - aty[j];
+        }
+    }
+
+    static double MaxStep(const std::vector<double> &v, const std::vector<double> &dv)
+    {
+        double step = 1.0;
+        for (std::size_t j = 0; j < v.size(); j++)
+        {
+            if (dv[j] < 0.0)
+                step = std::min(step, -v[j] / dv[j]);
+        }
+        return step;
+    }
+
+    static double Norm(const std::vector<double> &v)
+    {
+        double sum = 0.0;
+        for (double val : v)
+            sum += val * val;
+        return std::sqrt(sum);
+    }
+
+    static double Dot(const std::vector<double> &a, const std::vector<double> &b)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < a.size(); i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    // Mehrotra's starting point: least-norm x and least-squares (y, s), shifted into the positive orthant
+    void StartingPoint()
+    {
+        FactorNormalMatrix(std::vector<double>(numCols, 1.0));
+        x = MultiplyAT(SolveNormal(rhs));
+        y = SolveNormal(MultiplyA(cost));
+        s = MultiplyAT(y);
+        for (int j = 0; j < numCols; j++)
+            s[j] = cost[j] - s[j];
+
+        double shiftX = std::max(-1.5 * *std::min_element(x.begin(), x.end()), 0.0);
+        double shiftS = std::max(-1.5 * *std::min_element(s.begin(), s.end()), 0.0);
+        for (int j = 0; j < numCols; j++)
+        {
+            x[j] += shiftX;
+            s[j] += shiftS;
+        }
+
+        double xs = Dot(x, s);
+        double sumX = std::accumulate(x.begin(), x.end(), 0.0);
+        double sumS = std::accumulate(s.begin(), s.end(), 0.0);
+        double centerX = sumS > 0.0 ? 0.5 * xs / sumS : 1.0;
+        double centerS = sumX > 0.0 ? 0.5 * xs / sumX : 1.0;
+        for (int j = 0; j < numCols; j++)
+        {
+            x[j] = std::max(x[j] + centerX, 1e-8);
+            s[j] = std::max(s[j] + centerS, 1e-8);
+        }
+    }
+
+    void Run(int &iterations)
+    {
+        status = InteriorPointStatus::IterationLimit;
+        double normB = Norm(rhs);
+        double normC = Norm(cost);
+        std::vector<double> d(numCols), rxs(numCols);
+        std::vector<double> dxAff, dyAff, dsAff, dx, dy, ds;
+
+        for (iterations = 0; iterations <= maxIterations; iterations++)
+        {
+            std::vector<double> rb = MultiplyA(x);
+            for (int i = 0; i < numRows; i++)
+                rb[i] -= rhs[i];
+            std::vector<double> rc = MultiplyAT(y);
+            for (int j = 0; j < numCols; j++)
+                rc[j] += s[j] - cost[j];
+
+            double primalObj = Dot(cost, x);
+            double dualObj = Dot(rhs, y);
+            double mu = Dot(x, s) / numCols;
+
+            if (isConsoleOutput)
+            {
+                std::cout << "ipm iteration " << iterations << " primal " << primalObj << " dual " << dualObj << " mu " << mu << std::endl;
+            }
+
+            if (Norm(rb) <= tolerance * (1.0 + normB) && Norm(rc) <= tolerance * (1.0 + normC) &&
+                std::abs(primalObj - dualObj) <= tolerance * (1.0 + std::abs(primalObj)))
+            {
+                status = InteriorPointStatus::Optimal;
+                return;
+            }
+            if (Norm(x) > DIVERGENCE_LIMIT)
+            {
+                status = InteriorPointStatus::Unbounded;
+                return;
+            }
+            if (Norm(y) > DIVERGENCE_LIMIT || Norm(s) > DIVERGENCE_LIMIT)
+            {
+                status = InteriorPointStatus::Infeasible;
+                return;
+            }
+            if (iterations == maxIterations)
+                return;
+
+            for (int j = 0; j < numCols; j++)
+                d[j] = x[j] / s[j];
+            FactorNormalMatrix(d);
+
+            // predictor: pure Newton direction towards complementarity
+            for (int j = 0; j < numCols; j++)
+                rxs[j] = -x[j] * s[j];
+            SolveNewton(d, rb, rc, rxs, dxAff, dyAff, dsAff);
+
+            double stepPrimal = MaxStep(x, dxAff);
+            double stepDual = MaxStep(s, dsAff);
+            double muAff = 0.0;
+            for (int j = 0; j < numCols; j++)
+                muAff += (x[j] + stepPrimal * dxAff[j]) * (s[j] + stepDual * dsAff[j]);
+            muAff /= numCols;
+            double sigma = std::pow(muAff / mu, 3.0);
+
+            // corrector: centering plus the second order term the predictor dropped, on the same factor
+            for (int j = 0; j < numCols; j++)
+                rxs[j] = -x[j] * s[j] - dxAff[j] * dsAff[j] + sigma * mu;
+            SolveNewton(d, rb, rc, rxs, dx, dy, ds);
+
+            stepPrimal = std::min(1.0, STEP_FRACTION * MaxStep(x, dx));
+            stepDual = std::min(1.0, STEP_FRACTION * MaxStep(s, ds));
+            for (int j = 0; j < numCols; j++)
+            {
+                x[j] += stepPrimal * dx[j];
+                s[j] += stepDual * ds[j];
+            }
+            for (int i = 0; i < numRows; i++)
+                y[i] += stepDual * dy[i];
+        }
+    }
+
+public:
+    struct InteriorPointResult
+    {
+        InteriorPointStatus status = InteriorPointStatus::IterationLimit;
+        std::vector<double> changingVars;
+        // one per row: the change in the objective per unit increase of its rhs
+        std::vector<double> duals;
+        double optimalSolution = std::numeric_limits<double>::quiet_NaN();
+        int iterations = 0;
+    };
+
+    InteriorPoint(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput) {}
+
+    void SetMaxIterations(int iterations) { maxIterations = iterations; }
+    void SetTolerance(double tol) { tolerance = tol; }
+
+    InteriorPointStatus GetStatus() const { return status; }
+    // last iterate over the model columns followed by each row's slack or excess, the RevisedSimplex
+    // numbering, with the columns whose dual slack outweighs their value set to zero. Near the optimum
+    // those are the nonbasic ones, so a crossover only has to push the few that are left
+    std::vector<double> CrossoverPoint() const
+    {
+        std::vector<double> point = x;
+        for (std::size_t j = 0; j < point.size(); j++)
+        {
+            if (point[j] < s[j])
+                point[j] = 0.0;
+        }
+        return point;
+    }
+
+    InteriorPointResult DoInteriorPoint(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
+    {
+        return DoInteriorPoint(SparseLPModel::FromDense(objFunc, constraints), isMin);
+    }
+
+    InteriorPointResult DoInteriorPoint(const SparseLPModel &model, bool minimize)
+    {
+        Load(model, minimize);
+
+        InteriorPointResult res;
+        if (numRows == 0)
+        {
+            // nothing to factor: every column sits at zero unless its cost makes the LP unbounded
+            x.assign(numCols, 0.0);
+            y.clear();
+            s = cost;
+            bool unbounded = std::any_of(cost.begin(), cost.end(), [](double c)
+                                         { return c < 0.0; });
+            status = unbounded ? InteriorPointStatus::Unbounded : InteriorPointStatus::Optimal;
+        }
+        else
+        {
+            StartingPoint();
+            Run(res.iterations);
+        }
+
+        res.status = status;
+        res.changingVars.assign(x.begin(), x.begin() + lenObj);
+        res.duals.resize(numRows);
+        for (int i = 0; i < numRows; i++)
+            res.duals[i] = isMin ? y[i] : -y[i];
+        if (status == InteriorPointStatus::Optimal)
+        {
+            double obj = Dot(cost, x);
+            res.optimalSolution = isMin ? obj : -obj;
+        }
+        return res;
+    }
+
+    // crossover basis guess from the last solve: columns are ranked by x_j / (x_j + s_j), which tends to 1
+    // on the basic columns of an optimal face and to 0 on the rest, and accepted while they stay linearly
+    // independent. Rows left without a column get their slack, so the basis is always complete and nonsingular
+    LPBasis IdentifyBasis() const
+    {
+        LPBasis basis;
+        basis.colStatus.assign(lenObj, BasisStatus::AtLower);
+        basis.rowStatus.assign(numRows, BasisStatus::AtLower);
+        if (x.size() != static_cast<std::size_t>(numCols))
+            return basis;
+
+        std::vector<double> score(numCols, 0.0);
+        for (int j = 0; j < numCols; j++)
+        {
+            double total = x[j] + s[j];
+            if (std::isfinite(total) && total > 0.0)
+                score[j] = x[j] / total;
+        }
+        std::vector<int> order(numCols);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b)
+                         { return score[a] > score[b]; });
+
+        // each accepted column is kept eliminated against the earlier ones, with a 1 in its own pivot row
+        std::vector<std::vector<double>> accepted;
+        std::vector<int> pivotRows;
+        std::vector<bool> rowTaken(numRows, false);
+        for (int j : order)
+        {
+            if (static_cast<int>(accepted.size()) == numRows)
+                break;
+
+            std::vector<double> col(numRows, 0.0);
+            for (int k = colStart[j]; k < colStart[j + 1]; k++)
+                col[rowIndex[k]] = values[k];
+            double scale = Norm(col);
+            for (std::size_t a = 0; a < accepted.size(); a++)
+            {
+                double f = col[pivotRows[a]];
+                if (f == 0.0)
+                    continue;
+                for (int i = 0; i < numRows; i++)
+                    col[i] -= f * accepted[a][i];
+            }
+
+            int pivotRow = -1;
+            for (int i = 0; i < numRows; i++)
+            {
+                if (!rowTaken[i] && (pivotRow == -1 || std::abs(col[i]) > std::abs(col[pivotRow])))
+                    pivotRow = i;
+            }
+            if (pivotRow == -1 || std::abs(col[pivotRow]) <= 1e-9 * (1.0 + scale))
+                continue;
+
+            double pivot = col[pivotRow];
+            for (double &val : col)
+                val /= pivot;
+            accepted.push_back(std::move(col));
+            pivotRows.push_back(pivotRow);
+            rowTaken[pivotRow] = true;
+
+            if (j < lenObj)
+                basis.colStatus[j] = BasisStatus::Basic;
+            else
+                basis.rowStatus[j - lenObj] = BasisStatus::Basic;
+        }
+
+        // the accepted columns are in echelon form on their pivot rows, so unit columns fill the rest
+        for (int i = 0; i < numRows; i++)
+        {
+            if (!rowTaken[i])
+                basis.rowStatus[i] = BasisStatus::Basic;
+        }
+        return basis;
+    }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <stdexcept>
+#include <algorithm>
+
+// LP stored column-wise in compressed sparse column form. Row senses use the same codes as the
+// dense constraint rows the solvers take: 1 is >=, anything else is <=.
+struct SparseLPModel
+{
+    int numRows = 0;
+    int numCols = 0;
+    std::vector<double> objective;
+    std::vector<int> colStart = {0};
+    std::vector<int> rowIndex;
+    std::vector<double> values;
+    std::vector<double> rhs;
+    std::vector<int> senses;
+
+    SparseLPModel() = default;
+
+    SparseLPModel(int numRows, const std::vector<double> &rhs, const std::vector<int> &senses)
+        : numRows(numRows), rhs(rhs), senses(senses)
+    {
+        if (static_cast<int>(rhs.size()) != numRows || static_cast<int>(senses.size()) != numRows)
+        {
+            throw std::invalid_argument("rhs and senses must have one entry per row.");
+        }
+    }
+
+    int NumNonZeros() const { return static_cast<int>(values.size()); }
+    int ColBegin(int j) const { return colStart[j]; }
+    int ColEnd(int j) const { return colStart[j + 1]; }
+
+    bool IsGreaterEqual(int i) const { return senses[i] == 1; }
+
+    // entries are (row, value) pairs; zeros are dropped
+    void AddColumn(double cost, const std::vector<std::pair<int, double>> &entries)
+    {
+        for (const auto &[row, val] : entries)
+        {
+            if (row < 0 || row >= numRows)
+            {
+                throw std::out_of_range("Column entry row index out of range.");
+            }
+            if (val != 0.0)
+            {
+                rowIndex.push_back(row);
+                values.push_back(val);
+            }
+        }
+        colStart.push_back(static_cast<int>(rowIndex.size()));
+        objective.push_back(cost);
+        numCols++;
+    }
+
+    double Coefficient(int i, int j) const
+    {
+        for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+        {
+            if (rowIndex[k] == i)
+                return values[k];
+        }
+        return 0.0;
+    }
+
+    // dense rows are coefficients, rhs, sign; coefficients past objFunc.size() are ignored
+    static SparseLPModel FromDense(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints)
+    {
+        SparseLPModel model;
+        model.numRows = static_cast<int>(constraints.size());
+        model.numCols = static_cast<int>(objFunc.size());
+        model.objective = objFunc;
+        model.rhs.resize(model.numRows);
+        model.senses.resize(model.numRows);
+
+        std::vector<int> colCount(model.numCols + 1, 0);
+        for (int i = 0; i < model.numRows; ++i)
+        {
+            const auto &row = constraints[i];
+            if (row.size() < 2)
+            {
+                throw std::invalid_argument("Constraint rows need at least a rhs and a sign.");
+            }
+            model.rhs[i] = row[row.size() - 2];
+            model.senses[i] = static_cast<int>(row.back());
+
+            int coeffs = std::min(static_cast<int>(row.size()) - 2, model.numCols);
+            for (int j = 0; j < coeffs; ++j)
+            {
+                if (row[j] != 0.0)
+                    colCount[j + 1]++;
+            }
+        }
+
+        model.colStart.assign(model.numCols + 1, 0);
+        for (int j = 0; j < model.numCols; ++j)
+            model.colStart[j + 1] = model.colStart[j] + colCount[j + 1];
+
+        model.rowIndex.resize(model.colStart.back());
+        model.values.resize(model.colStart.back());
+        std::vector<int> next(model.colStart.begin(), model.colStart.end() - 1);
+        for (int i = 0; i < model.numRows; ++i)
+        {
+            const auto &row = constraints[i];
+            int coeffs = std::min(static_cast<int>(row.size()) - 2, model.numCols);
+            for (int j = 0; j < coeffs; ++j)
+            {
+                if (row[j] != 0.0)
+                {
+                    model.rowIndex[next[j]] = i;
+                    model.values[next[j]] = row[j];
+                    next[j]++;
+                }
+            }
+        }
+        return model;
+    }
+
+    std::vector<std::vector<double>> ToDense() const
+    {
+        std::vector<std::vector<double>> constraints(numRows, std::vector<double>(numCols + 2, 0.0));
+        for (int j = 0; j < numCols; ++j)
+        {
+            for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+                constraints[rowIndex[k]][j] = values[k];
+        }
+        for (int i = 0; i < numRows; ++i)
+        {
+            constraints[i][numCols] = rhs[i];
+            constraints[i][numCols + 1] = senses[i];
+        }
+        return constraints;
+    }
+};
+
+// status of one column or one row's slack in a simplex basis; AtUpper only means something for boxed columns
+enum class BasisStatus
+{
+    Basic,
+    AtLower,
+    AtUpper
+};
+
+// colStatus has one entry per model column, rowStatus one per row (the status of its slack or excess column)
+struct LPBasis
+{
+    std::vector<BasisStatus> colStatus;
+    std::vector<BasisStatus> rowStatus;
+
+    bool Empty() const { return colStatus.empty() && rowStatus.empty(); }
+};
@@ -129,6 +129,9 @@ public:
         shouldReoptimize = false;
     }
 
+    // engine the optimal tableau is found with; only the final tableau is read, so InteriorPoint works too
+    void SetEngine(SimplexEngine engine) { dual->SetEngine(engine); }
+
     std::tuple<std::vector<double>, std::vector<std::vector<double>>, bool> testInput(int testNum = -1)
     {
         bool isMin = false;
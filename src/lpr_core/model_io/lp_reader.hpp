@@ -0,0 +1,571 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <initializer_list>
+#include <istream>
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "lp_model.hpp"
+#include "model_file.hpp"
+#include "model_input.hpp"
+
+// Streaming reader for the CPLEX LP format: the objective, Subject To, Bounds, General and Binary sections
+// and '\' comments. Constraints arrive a row at a time, so their entries are kept as flat (row, column,
+// value) triplets and turned into the model's CSC arrays by one counting sort at the end; repeated terms of
+// a row are summed there. Ranged, quadratic, indicator and semi-continuous constraints are not supported
+class LpReader
+{
+private:
+    using Parsing = ModelFileParsing;
+
+    static constexpr const char *FORMAT = "LP";
+    static constexpr double INFINITE_BOUND = 1e30;
+
+    enum class Section
+    {
+        None,
+        Minimize,
+        Maximize,
+        Constraints,
+        Bounds,
+        General,
+        Binary,
+        End
+    };
+
+    enum class TokenKind
+    {
+        Number,
+        Name,
+        Sign,
+        Less,
+        Greater,
+        Equal,
+        Colon,
+        Section,
+        EndOfInput
+    };
+
+    // a sign's number is +1 or -1
+    struct Token
+    {
+        TokenKind kind = TokenKind::EndOfInput;
+        double number = 0.0;
+        std::string text;
+        Section section = Section::None;
+        long line = 0;
+    };
+
+    ModelInput *input = nullptr;
+    std::deque<Token> pending;
+    std::vector<Token> lineTokens;
+    Token endToken;
+    long line = 0;
+
+    ModelFile result;
+    NameIndex colMap;
+    std::vector<int> entryRow;
+    std::vector<int> entryCol;
+    std::vector<double> entryValue;
+    std::vector<bool> isEquality;
+
+    [[noreturn]] void Fail(const std::string &message) const { throw Parsing::ParseError(FORMAT, line, message); }
+
+    static bool IsNameChar(char c)
+    {
+        return !std::isspace(static_cast<unsigned char>(c)) && c != '+' && c != '-' && c != '<' && c != '>' &&
+               c != '=' && c != ':' && c != '\\' && c != '[' && c != ']' && c != '*' && c != '^';
+    }
+
+    static bool IsComparison(TokenKind kind)
+    {
+        return kind == TokenKind::Less || kind == TokenKind::Greater || kind == TokenKind::Equal;
+    }
+
+    // a keyword only starts a section as the first word of a line and when no colon makes it a label
+    static Section SectionKeyword(const std::vector<Token> &tokens, int &used)
+    {
+        auto word = [&](std::size_t k) -> std::string_view
+        {
+            return k < tokens.size() && tokens[k].kind == TokenKind::Name ? std::string_view(tokens[k].text) : std::string_view();
+        };
+        auto is = [](std::string_view text, std::initializer_list<const char *> options)
+        {
+            for (const char *option : options)
+            {
+                if (Parsing::EqualsIgnoreCase(text, option))
+                    return true;
+            }
+            return false;
+        };
+
+        std::string_view a = word(0);
+        std::string_view b = word(1);
+        if (a.empty() || (tokens.size() > 1 && tokens[1].kind == TokenKind::Colon))
+            return Section::None;
+
+        used = 1;
+        if (is(a, {"minimize", "minimise", "minimum", "min"}))
+            return Section::Minimize;
+        if (is(a, {"maximize", "maximise", "maximum", "max"}))
+            return Section::Maximize;
+        if (is(a, {"st", "s.t.", "st.", "s.t"}))
+            return Section::Constraints;
+        if ((is(a, {"subject"}) && is(b, {"to"})) || (is(a, {"such"}) && is(b, {"that"})))
+        {
+            used = 2;
+            return Section::Constraints;
+        }
+        if (is(a, {"bounds", "bound"}))
+            return Section::Bounds;
+        if (is(a, {"general", "generals", "gen", "integer", "integers"}))
+            return Section::General;
+        if (is(a, {"binary", "binaries", "bin"}))
+            return Section::Binary;
+        if (is(a, {"end"}))
+            return Section::End;
+        used = 0;
+        return Section::None;
+    }
+
+    void Tokenize(std::string_view text)
+    {
+        std::vector<Token> &tokens = lineTokens;
+        tokens.clear();
+        std::size_t i = 0;
+        while (i < text.size())
+        {
+            char c = text[i];
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                i++;
+                continue;
+            }
+            if (c == '\\')
+                break;
+
+            Token token;
+            token.line = line;
+            if (c == '<' || c == '>' || c == '=')
+            {
+                // <, <=, =<, >, >=, => and =
+                char next = i + 1 < text.size() ? text[i + 1] : '\0';
+                if (c == '=')
+                    token.kind = next == '<' ? TokenKind::Less : next == '>' ? TokenKind::Greater : TokenKind::Equal;
+                else
+                    token.kind = c == '<' ? TokenKind::Less : TokenKind::Greater;
+                i += (next == '=' || (c == '=' && (next == '<' || next == '>'))) ? 2 : 1;
+            }
+            else if (c == '+' || c == '-')
+            {
+                token.kind = TokenKind::Sign;
+                token.number = c == '-' ? -1.0 : 1.0;
+                i++;
+            }
+            else if (c == ':')
+            {
+                token.kind = TokenKind::Colon;
+                i++;
+            }
+            else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                     (c == '.' && i + 1 < text.size() && std::isdigit(static_cast<unsigned char>(text[i + 1]))))
+            {
+                token.kind = TokenKind::Number;
+                auto [end, ec] = std::from_chars(text.data() + i, text.data() + text.size(), token.number);
+                if (ec != std::errc())
+                    Fail("malformed number.");
+                i = end - text.data();
+            }
+            else if (c == '[' || c == ']' || c == '*' || c == '^')
+            {
+                Fail("quadratic terms are not supported.");
+            }
+            else
+            {
+                std::size_t start = i;
+                while (i < text.size() && IsNameChar(text[i]))
+                    i++;
+                token.kind = TokenKind::Name;
+                token.text.assign(text.substr(start, i - start));
+            }
+            tokens.push_back(std::move(token));
+        }
+
+        int used = 0;
+        Section section = SectionKeyword(tokens, used);
+        if (section != Section::None)
+        {
+            Token token;
+            token.kind = TokenKind::Section;
+            token.section = section;
+            token.line = line;
+            pending.push_back(std::move(token));
+        }
+        for (std::size_t k = used; k < tokens.size(); k++)
+            pending.push_back(std::move(tokens[k]));
+    }
+
+    const Token &Peek(std::size_t ahead = 0)
+    {
+        std::string_view text;
+        while (pending.size() <= ahead && input->NextLine(text))
+        {
+            line = input->LineNumber();
+            Tokenize(text);
+        }
+        return ahead < pending.size() ? pending[ahead] : endToken;
+    }
+
+    Token Next()
+    {
+        Peek();
+        if (pending.empty())
+            return endToken;
+        Token token = std::move(pending.front());
+        pending.pop_front();
+        line = token.line;
+        return token;
+    }
+
+    int Column(const std::string &name)
+    {
+        int col = colMap.Find(name);
+        if (col == NameIndex::NOT_FOUND)
+        {
+            col = result.model.numCols;
+            colMap.Insert(name, col);
+            result.model.numCols++;
+            result.model.objective.push_back(0.0);
+            result.lower.push_back(0.0);
+            result.upper.push_back(std::numeric_limits<double>::infinity());
+            result.isInteger.push_back(false);
+            result.colNames.push_back(name);
+        }
+        return col;
+    }
+
+    // [sign] number or [sign] inf
+    double ReadValue()
+    {
+        double sign = 1.0;
+        while (Peek().kind == TokenKind::Sign)
+            sign *= Next().number;
+        Token token = Next();
+        if (token.kind == TokenKind::Number)
+            return sign * (token.number >= INFINITE_BOUND ? std::numeric_limits<double>::infinity() : token.number);
+        if (token.kind == TokenKind::Name && (Parsing::EqualsIgnoreCase(token.text, "inf") || Parsing::EqualsIgnoreCase(token.text, "infinity")))
+            return sign * std::numeric_limits<double>::infinity();
+        Fail("expected a number.");
+    }
+
+    void SkipLabel(std::string &label)
+    {
+        if (Peek().kind == TokenKind::Name && Peek(1).kind == TokenKind::Colon)
+        {
+            label = Next().text;
+            Next();
+        }
+    }
+
+    // terms go to row, or to the objective for row -1; constants are summed into constant
+    void ReadExpression(int row, double &constant)
+    {
+        while (true)
+        {
+            double sign = 1.0;
+            bool hasSign = false;
+            while (Peek().kind == TokenKind::Sign)
+            {
+                sign *= Next().number;
+                hasSign = true;
+            }
+
+            double coefficient = 1.0;
+            bool hasNumber = false;
+            if (Peek().kind == TokenKind::Number)
+            {
+                coefficient = Next().number;
+                hasNumber = true;
+            }
+
+            if (Peek().kind != TokenKind::Name)
+            {
+                if (hasNumber)
+                {
+                    constant += sign * coefficient;
+                    continue;
+                }
+                if (hasSign)
+                    Fail("a sign without a term.");
+                return;
+            }
+
+            int col = Column(Next().text);
+            double value = sign * coefficient;
+            if (row < 0)
+            {
+                result.model.objective[col] += value;
+            }
+            else
+            {
+                entryRow.push_back(row);
+                entryCol.push_back(col);
+                entryValue.push_back(value);
+            }
+        }
+    }
+
+    void ReadObjective()
+    {
+        std::string label;
+        SkipLabel(label);
+        double constant = 0.0;
+        ReadExpression(-1, constant);
+        result.objectiveOffset += constant;
+        if (Peek().kind != TokenKind::Section && Peek().kind != TokenKind::EndOfInput)
+            Fail("unexpected token in the objective.");
+    }
+
+    void ReadConstraint()
+    {
+        int row = static_cast<int>(result.model.rhs.size());
+        std::string label;
+        SkipLabel(label);
+
+        double constant = 0.0;
+        ReadExpression(row, constant);
+        Token op = Next();
+        if (!IsComparison(op.kind))
+            Fail("expected <=, >= or = in a constraint.");
+        double rhs = ReadValue() - constant;
+
+        result.rowNames.push_back(label.empty() ? "R" + std::to_string(row + 1) : label);
+        result.model.rhs.push_back(rhs);
+        result.model.senses.push_back(op.kind == TokenKind::Less ? 0 : 1);
+        isEquality.push_back(op.kind == TokenKind::Equal);
+    }
+
+    void ApplyBound(int col, TokenKind op, double value)
+    {
+        if (op != TokenKind::Greater)
+            result.upper[col] = value;
+        if (op != TokenKind::Less)
+            result.lower[col] = value;
+    }
+
+    // x free, x op value, value op x, or value op x op value
+    void ReadBound()
+    {
+        const Token &first = Peek();
+        bool valueFirst = first.kind != TokenKind::Name || Parsing::EqualsIgnoreCase(first.text, "inf") ||
+                          Parsing::EqualsIgnoreCase(first.text, "infinity");
+        if (!valueFirst)
+        {
+            int col = Column(Next().text);
+            if (Peek().kind == TokenKind::Name && Parsing::EqualsIgnoreCase(Peek().text, "free"))
+            {
+                Next();
+                result.lower[col] = -std::numeric_limits<double>::infinity();
+                result.upper[col] = std::numeric_limits<double>::infinity();
+                return;
+            }
+            Token op = Next();
+            if (!IsComparison(op.kind))
+                Fail("expected a comparison in a bound.");
+            ApplyBound(col, op.kind, ReadValue());
+            return;
+        }
+
+        double value = ReadValue();
+        Token op = Next();
+        Token name = Next();
+        if (!IsComparison(op.kind) || name.kind != TokenKind::Name)
+            Fail("expected a comparison and a column in a bound.");
+        int col = Column(name.text);
+        // value <= x is a lower bound, value >= x an upper one
+        TokenKind flipped = op.kind == TokenKind::Less ? TokenKind::Greater : op.kind == TokenKind::Greater ? TokenKind::Less : TokenKind::Equal;
+        ApplyBound(col, flipped, value);
+        if (IsComparison(Peek().kind))
+        {
+            TokenKind second = Next().kind;
+            ApplyBound(col, second, ReadValue());
+        }
+    }
+
+    void ReadIntegerColumn(bool binary)
+    {
+        Token name = Next();
+        if (name.kind != TokenKind::Name)
+            Fail("expected a column name.");
+        int col = Column(name.text);
+        result.isInteger[col] = true;
+        if (binary)
+        {
+            result.lower[col] = 0.0;
+            result.upper[col] = 1.0;
+        }
+    }
+
+    // = rows become a >= row and a <= twin after all the constraint rows; columns are filled in row order
+    // and the twins after, so repeated terms of a row sit next to each other and are summed in place
+    void BuildColumns()
+    {
+        SparseLPModel &model = result.model;
+        int rows = static_cast<int>(model.rhs.size());
+        std::vector<int> twin(rows, -1);
+        for (int i = 0; i < rows; i++)
+        {
+            if (!isEquality[i])
+                continue;
+            twin[i] = static_cast<int>(model.rhs.size());
+            result.rowNames.push_back(result.rowNames[i]);
+            model.rhs.push_back(model.rhs[i]);
+            model.senses.push_back(0);
+        }
+        model.numRows = static_cast<int>(model.rhs.size());
+
+        std::vector<int> count(model.numCols + 1, 0);
+        for (std::size_t k = 0; k < entryCol.size(); k++)
+            count[entryCol[k] + 1] += twin[entryRow[k]] == -1 ? 1 : 2;
+        model.colStart.assign(model.numCols + 1, 0);
+        for (int j = 0; j < model.numCols; j++)
+            model.colStart[j + 1] = model.colStart[j] + count[j + 1];
+
+        model.rowIndex.resize(model.colStart.back());
+        model.values.resize(model.colStart.back());
+        std::vector<int> next(model.colStart.begin(), model.colStart.end() - 1);
+        for (bool twins : {false, true})
+        {
+            for (std::size_t k = 0; k < entryCol.size(); k++)
+            {
+                int row = twins ? twin[entryRow[k]] : entryRow[k];
+                if (row == -1)
+                    continue;
+                int &slot = next[entryCol[k]];
+                model.rowIndex[slot] = row;
+                model.values[slot] = entryValue[k];
+                slot++;
+            }
+        }
+        entryRow = {};
+        entryCol = {};
+        entryValue = {};
+
+        // sum repeated rows and drop zeros, compacting in place
+        int out = 0;
+        for (int j = 0; j < model.numCols; j++)
+        {
+            int begin = out;
+            for (int k = model.colStart[j]; k < model.colStart[j + 1]; k++)
+            {
+                if (out > begin && model.rowIndex[out - 1] == model.rowIndex[k])
+                {
+                    model.values[out - 1] += model.values[k];
+                    continue;
+                }
+                model.rowIndex[out] = model.rowIndex[k];
+                model.values[out] = model.values[k];
+                out++;
+            }
+            int kept = begin;
+            for (int k = begin; k < out; k++)
+            {
+                if (model.values[k] == 0.0)
+                    continue;
+                model.rowIndex[kept] = model.rowIndex[k];
+                model.values[kept] = model.values[k];
+                kept++;
+            }
+            out = kept;
+            model.colStart[j] = begin;
+        }
+        model.colStart[model.numCols] = out;
+        model.rowIndex.resize(out);
+        model.values.resize(out);
+    }
+
+    void Reset(ModelInput &source)
+    {
+        input = &source;
+        pending.clear();
+        line = 0;
+        result = ModelFile();
+        colMap.Clear();
+        entryRow.clear();
+        entryCol.clear();
+        entryValue.clear();
+        isEquality.clear();
+    }
+
+public:
+    ModelFile Read(ModelInput &source)
+    {
+        Reset(source);
+        Section section = Section::None;
+        while (section != Section::End && Peek().kind != TokenKind::EndOfInput)
+        {
+            if (Peek().kind == TokenKind::Section)
+            {
+                section = Next().section;
+                if (section == Section::Minimize || section == Section::Maximize)
+                    result.isMin = section == Section::Minimize;
+                continue;
+            }
+
+            switch (section)
+            {
+            case Section::Minimize:
+            case Section::Maximize:
+                ReadObjective();
+                break;
+            case Section::Constraints:
+                ReadConstraint();
+                break;
+            case Section::Bounds:
+                ReadBound();
+                break;
+            case Section::General:
+                ReadIntegerColumn(false);
+                break;
+            case Section::Binary:
+                ReadIntegerColumn(true);
+                break;
+            default:
+                Next();
+                Fail("expected Minimize or Maximize.");
+            }
+        }
+
+        BuildColumns();
+        input = nullptr;
+        return std::move(result);
+    }
+
+    ModelFile ReadFile(const std::string &path)
+    {
+        ModelInput source;
+        source.OpenFile(path);
+        return Read(source);
+    }
+
+    ModelFile ReadStream(std::istream &in)
+    {
+        ModelInput source;
+        source.OpenStream(in);
+        return Read(source);
+    }
+
+    ModelFile ReadText(std::string_view text)
+    {
+        ModelInput source;
+        source.OpenText(text);
+        return Read(source);
+    }
+};
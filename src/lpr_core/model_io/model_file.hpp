@@ -0,0 +1,179 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <functional>
+#include <cstdint>
+#include <algorithm>
+
+#include "lp_model.hpp"
+
+// A model read from an MPS or LP file. Equality and ranged rows are stored as a >= row and a <= row, the
+// second one after all the file's own rows, both under the row's name. lower and upper are in the order
+// DualSimplex::SetVariableBounds takes them; a missing bound is +-infinity, and the solvers need a finite
+// lower bound, so free and minus-infinity columns have to be split by the caller
+struct ModelFile
+{
+    std::string name;
+    SparseLPModel model;
+    bool isMin = true;
+    double objectiveOffset = 0.0;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<bool> isInteger;
+    std::vector<std::string> colNames;
+    std::vector<std::string> rowNames;
+
+    // false when every column keeps the solvers' default bounds of 0 and +infinity
+    bool HasBounds() const
+    {
+        for (int j = 0; j < model.numCols; j++)
+        {
+            if (lower[j] != 0.0 || upper[j] != std::numeric_limits<double>::infinity())
+                return true;
+        }
+        return false;
+    }
+};
+
+// shared token helpers of the MPS and LP readers
+class ModelFileParsing
+{
+public:
+    static bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (std::size_t i = 0; i < a.size(); i++)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i])))
+                return false;
+        }
+        return true;
+    }
+
+    static std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front())))
+            text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back())))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    static std::runtime_error ParseError(const char *format, long line, const std::string &message)
+    {
+        return std::runtime_error(std::string(format) + " line " + std::to_string(line) + ": " + message);
+    }
+
+    // whole-token number; "inf" and "infinity" with an optional sign are accepted, anything else throws
+    static double ParseNumber(std::string_view token, const char *format, long line)
+    {
+        std::string_view digits = token;
+        double sign = 1.0;
+        if (!digits.empty() && (digits.front() == '+' || digits.front() == '-'))
+        {
+            sign = digits.front() == '-' ? -1.0 : 1.0;
+            digits.remove_prefix(1);
+        }
+        if (EqualsIgnoreCase(digits, "inf") || EqualsIgnoreCase(digits, "infinity"))
+            return sign * std::numeric_limits<double>::infinity();
+
+        double value = 0.0;
+        auto [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+        if (ec != std::errc() || end != digits.data() + digits.size() || digits.empty())
+            throw ParseError(format, line, "'" + std::string(token) + "' is not a number.");
+        return sign * value;
+    }
+};
+
+// Open-addressing name to value table for the readers. The names sit in one character arena and a slot
+// holds only a hash and an entry number, so a lookup is a hash, a short probe and usually one compare,
+// with no per-name allocation or node to chase. Lookups take the string_view of the current line as is
+class NameIndex
+{
+private:
+    struct Slot
+    {
+        std::uint64_t hash = 0;
+        int entry = -1;
+    };
+
+    std::vector<char> arena;
+    std::vector<std::size_t> nameStart = {0};
+    std::vector<int> values;
+    std::vector<Slot> slots;
+
+    static std::uint64_t Hash(std::string_view name) { return std::hash<std::string_view>()(name); }
+
+    std::string_view Name(int entry) const
+    {
+        return {arena.data() + nameStart[entry], nameStart[entry + 1] - nameStart[entry]};
+    }
+
+    // slot holding name, or the empty slot where it would go
+    std::size_t Probe(std::string_view name, std::uint64_t hash) const
+    {
+        std::size_t mask = slots.size() - 1;
+        std::size_t k = hash & mask;
+        while (slots[k].entry != -1 && (slots[k].hash != hash || Name(slots[k].entry) != name))
+            k = (k + 1) & mask;
+        return k;
+    }
+
+    void Grow()
+    {
+        std::vector<Slot> old = std::move(slots);
+        slots.assign(std::max<std::size_t>(64, old.size() * 2), Slot());
+        for (const Slot &slot : old)
+        {
+            if (slot.entry == -1)
+                continue;
+            std::size_t k = slot.hash & (slots.size() - 1);
+            while (slots[k].entry != -1)
+                k = (k + 1) & (slots.size() - 1);
+            slots[k] = slot;
+        }
+    }
+
+public:
+    static constexpr int NOT_FOUND = std::numeric_limits<int>::min();
+
+    int Find(std::string_view name) const
+    {
+        if (slots.empty())
+            return NOT_FOUND;
+        const Slot &slot = slots[Probe(name, Hash(name))];
+        return slot.entry == -1 ? NOT_FOUND : values[slot.entry];
+    }
+
+    // false, and nothing changes, when name is already in the table
+    bool Insert(std::string_view name, int value)
+    {
+        if (2 * (values.size() + 1) > slots.size())
+            Grow();
+        std::uint64_t hash = Hash(name);
+        std::size_t k = Probe(name, hash);
+        if (slots[k].entry != -1)
+            return false;
+        slots[k] = {hash, static_cast<int>(values.size())};
+        arena.insert(arena.end(), name.begin(), name.end());
+        nameStart.push_back(arena.size());
+        values.push_back(value);
+        return true;
+    }
+
+    void Clear()
+    {
+        arena.clear();
+        nameStart.assign(1, 0);
+        values.clear();
+        slots.clear();
+    }
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <istream>
+#include <fstream>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LPR_MODEL_INPUT_MMAP
+#endif
+
+#if defined(LPR_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+// Line source for the model readers. Plain files are memory mapped where the platform has mmap, so a line is
+// a view straight into the mapping; streams, gzip files (built with LPR_HAVE_ZLIB) and plain files elsewhere
+// are read in chunks. A line stays valid until the next NextLine call
+class ModelInput
+{
+private:
+    static constexpr std::size_t CHUNK_SIZE = 1 << 20;
+
+    // whole input in memory: a mapping or the caller's text
+    const char *data = nullptr;
+    std::size_t size = 0;
+    std::size_t pos = 0;
+
+    // chunked input; a line longer than the buffer grows it
+    std::function<std::size_t(char *, std::size_t)> readChunk;
+    std::vector<char> buffer;
+    std::size_t bufferBegin = 0;
+    std::size_t bufferEnd = 0;
+    bool streamDone = false;
+
+    void *mapping = nullptr;
+    std::size_t mappingSize = 0;
+    std::ifstream file;
+#if defined(LPR_HAVE_ZLIB)
+    gzFile gzipFile = nullptr;
+#endif
+    long lineNumber = 0;
+
+    void Close()
+    {
+#if defined(LPR_MODEL_INPUT_MMAP)
+        if (mapping)
+            munmap(mapping, mappingSize);
+#endif
+#if defined(LPR_HAVE_ZLIB)
+        if (gzipFile)
+            gzclose(gzipFile);
+        gzipFile = nullptr;
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+        if (file.is_open())
+            file.close();
+        data = nullptr;
+        size = pos = 0;
+        readChunk = nullptr;
+        buffer.clear();
+        bufferBegin = bufferEnd = 0;
+        streamDone = false;
+        lineNumber = 0;
+    }
+
+    static std::string_view StripCarriageReturn(const char *begin, std::size_t length)
+    {
+        if (length > 0 && begin[length - 1] == '\r')
+            length--;
+        return {begin, length};
+    }
+
+    bool NextChunkedLine(std::string_view &line)
+    {
+        while (true)
+        {
+            const char *begin = buffer.data() + bufferBegin;
+            const char *newline = static_cast<const char *>(std::memchr(begin, '\n', bufferEnd - bufferBegin));
+            if (newline)
+            {
+                line = StripCarriageReturn(begin, newline - begin);
+                bufferBegin += newline - begin + 1;
+                return true;
+            }
+            if (streamDone)
+            {
+                if (bufferBegin == bufferEnd)
+                    return false;
+                line = StripCarriageReturn(begin, bufferEnd - bufferBegin);
+                bufferBegin = bufferEnd;
+                return true;
+            }
+
+            // keep the partial line at the front and refill behind it
+            std::memmove(buffer.data(), begin, bufferEnd - bufferBegin);
+            bufferEnd -= bufferBegin;
+            bufferBegin = 0;
+            if (bufferEnd == buffer.size())
+                buffer.resize(buffer.size() * 2);
+            std::size_t got = readChunk(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+            bufferEnd += got;
+            if (got == 0)
+                streamDone = true;
+        }
+    }
+
+    void StartChunked(std::function<std::size_t(char *, std::size_t)> read)
+    {
+        readChunk = std::move(read);
+        buffer.resize(CHUNK_SIZE);
+    }
+
+public:
+    ModelInput() = default;
+    ModelInput(const ModelInput &) = delete;
+    ModelInput &operator=(const ModelInput &) = delete;
+    ~ModelInput() { Close(); }
+
+    // text must outlive the reads
+    void OpenText(std::string_view text)
+    {
+        Close();
+        data = text.data();
+        size = text.size();
+    }
+
+    void OpenStream(std::istream &in)
+    {
+        Close();
+        StartChunked([&in](char *out, std::size_t count)
+                     {
+                         in.read(out, static_cast<std::streamsize>(count));
+                         return static_cast<std::size_t>(in.gcount()); });
+    }
+
+    // gzip input is recognised by its magic bytes, not the file name
+    void OpenFile(const std::string &path)
+    {
+        Close();
+        file.open(path, std::ios::binary);
+        if (!file)
+            throw std::runtime_error("Cannot open model file " + path + ".");
+        unsigned char magic[2] = {0, 0};
+        file.read(reinterpret_cast<char *>(magic), 2);
+        bool isGzip = file.gcount() == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+        file.clear();
+        file.seekg(0);
+
+        if (isGzip)
+        {
+#if defined(LPR_HAVE_ZLIB)
+            file.close();
+            gzipFile = gzopen(path.c_str(), "rb");
+            if (!gzipFile)
+                throw std::runtime_error("Cannot open model file " + path + ".");
+            gzbuffer(gzipFile, CHUNK_SIZE);
+            StartChunked([this](char *out, std::size_t count)
+                         {
+                             int got = gzread(gzipFile, out, static_cast<unsigned>(count));
+                             if (got < 0)
+                                 throw std::runtime_error("Corrupt gzip model file.");
+                             return static_cast<std::size_t>(got); });
+            return;
+#else
+            throw std::runtime_error("Model file " + path + " is gzip compressed; build with LPR_HAVE_ZLIB to read it.");
+#endif
+        }
+
+#if defined(LPR_MODEL_INPUT_MMAP)
+        file.close();
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0)
+        {
+            if (fd >= 0)
+                ::close(fd);
+            throw std::runtime_error("Cannot open model file " + path + ".");
+        }
+        if (info.st_size > 0)
+        {
+            void *mapped = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Cannot map model file " + path + ".");
+            }
+            madvise(mapped, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+            mapping = mapped;
+            mappingSize = static_cast<std::size_t>(info.st_size);
+            data = static_cast<const char *>(mapped);
+            size = mappingSize;
+        }
+        ::close(fd);
+#else
+        StartChunked([this](char *out, std::size_t count)
+                     {
+                         file.read(out, static_cast<std::streamsize>(count));
+                         return static_cast<std::size_t>(file.gcount()); });
+#endif
+    }
+
+    bool NextLine(std::string_view &line)
+    {
+        bool found;
+        if (readChunk)
+        {
+            found = NextChunkedLine(line);
+        }
+        else
+        {
+            found = pos < size;
+            if (found)
+            {
+                const char *begin = data + pos;
+                const char *newline = static_cast<const char *>(std::memchr(begin, '\n', size - pos));
+                std::size_t length = newline ? static_cast<std::size_t>(newline - begin) : size - pos;
+                line = StripCarriageReturn(begin, length);
+                pos += length + 1;
+            }
+        }
+        if (found)
+            lineNumber++;
+        return found;
+    }
+
+    long LineNumber() const { return lineNumber; }
+};
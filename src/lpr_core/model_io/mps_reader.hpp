@@ -0,0 +1,535 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <array>
+#include <istream>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+#include "lp_model.hpp"
+#include "model_file.hpp"
+#include "model_input.hpp"
+
+// Fixed cuts the fields at their fixed columns, so names may hold spaces; Free splits on whitespace
+enum class MpsFormat
+{
+    Free,
+    Fixed
+};
+
+// Streaming MPS reader. COLUMNS lists the matrix a column at a time, so its entries are appended straight
+// onto the model's CSC arrays; only RANGES on L and G rows, which add rows after the fact, need a second
+// pass over them. Integer markers, OBJSENSE, the objective RHS (a constant) and all bound types except SC
+// are understood
+class MpsReader
+{
+private:
+    using Parsing = ModelFileParsing;
+
+    static constexpr const char *FORMAT = "MPS";
+    static constexpr int OBJECTIVE_ROW = -1;
+    static constexpr int FREE_ROW = -2;
+    // magnitudes from here on are infinite bounds, as most MPS writers use 1e30
+    static constexpr double INFINITE_BOUND = 1e30;
+
+    enum class Section
+    {
+        None,
+        ObjSense,
+        Rows,
+        Columns,
+        Rhs,
+        Ranges,
+        Bounds,
+        End
+    };
+
+    MpsFormat format = MpsFormat::Free;
+
+    ModelFile result;
+    long line = 0;
+    NameIndex rowMap;
+    NameIndex colMap;
+    std::vector<char> rowType;
+    std::vector<int> twinRow;
+    std::vector<std::pair<int, double>> ranges;
+    std::string currentCol;
+    bool columnsBegun = false;
+    bool columnOpen = false;
+    bool integerBlock = false;
+    bool objectiveFound = false;
+
+    std::array<std::string_view, 6> fields;
+    int fieldCount = 0;
+
+    [[noreturn]] void Fail(const std::string &message) const { throw Parsing::ParseError(FORMAT, line, message); }
+
+    double Number(std::string_view token) const { return Parsing::ParseNumber(token, FORMAT, line); }
+
+    void Reset()
+    {
+        result = ModelFile();
+        line = 0;
+        rowMap.Clear();
+        colMap.Clear();
+        rowType.clear();
+        twinRow.clear();
+        ranges.clear();
+        currentCol.clear();
+        columnsBegun = false;
+        columnOpen = false;
+        integerBlock = false;
+        objectiveFound = false;
+    }
+
+    // section headers always split on whitespace, data lines by the format
+    void Split(std::string_view text, bool fixedColumns)
+    {
+        fieldCount = 0;
+        if (fixedColumns)
+        {
+            static constexpr std::size_t starts[6] = {1, 4, 14, 24, 39, 49};
+            static constexpr std::size_t ends[6] = {3, 12, 22, 36, 47, 61};
+            for (int k = 0; k < 6 && starts[k] < text.size(); k++)
+            {
+                std::string_view field = Parsing::Trim(text.substr(starts[k], ends[k] - starts[k]));
+                if (!field.empty())
+                    fields[fieldCount++] = field;
+            }
+            return;
+        }
+
+        std::size_t i = 0;
+        while (true)
+        {
+            while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i])))
+                i++;
+            if (i == text.size())
+                return;
+            std::size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])))
+                i++;
+            if (fieldCount == 6)
+                Fail("too many fields.");
+            fields[fieldCount++] = text.substr(start, i - start);
+        }
+    }
+
+    int FindRow(std::string_view name) const
+    {
+        int row = rowMap.Find(name);
+        if (row == NameIndex::NOT_FOUND)
+            Fail("unknown row '" + std::string(name) + "'.");
+        return row;
+    }
+
+    int FindCol(std::string_view name) const
+    {
+        int col = colMap.Find(name);
+        if (col == NameIndex::NOT_FOUND)
+            Fail("unknown column '" + std::string(name) + "'.");
+        return col;
+    }
+
+    Section StartSection(std::string_view text)
+    {
+        Split(text, false);
+        std::string_view keyword = fields[0];
+        if (keyword == "NAME")
+        {
+            result.name = fieldCount > 1 ? std::string(Parsing::Trim(text.substr(4))) : std::string();
+            return Section::None;
+        }
+        if (keyword == "OBJSENSE" || keyword == "OBJSENCE")
+        {
+            if (fieldCount > 1)
+                ReadObjSense(fields[1]);
+            return Section::ObjSense;
+        }
+        if (keyword == "ROWS")
+        {
+            if (columnsBegun)
+                Fail("ROWS must come before COLUMNS.");
+            return Section::Rows;
+        }
+        if (keyword == "COLUMNS")
+        {
+            BeginColumns();
+            return Section::Columns;
+        }
+        if (keyword == "RHS" || keyword == "RANGES" || keyword == "BOUNDS" || keyword == "ENDATA")
+        {
+            BeginColumns();
+            EndColumns();
+            if (keyword == "RHS")
+                return Section::Rhs;
+            if (keyword == "RANGES")
+                return Section::Ranges;
+            return keyword == "BOUNDS" ? Section::Bounds : Section::End;
+        }
+        Fail("unsupported section '" + std::string(keyword) + "'.");
+    }
+
+    void ReadObjSense(std::string_view sense)
+    {
+        if (sense == "MAX" || sense == "MAXIMIZE")
+            result.isMin = false;
+        else if (sense == "MIN" || sense == "MINIMIZE")
+            result.isMin = true;
+        else
+            Fail("unknown objective sense '" + std::string(sense) + "'.");
+    }
+
+    void ReadRow()
+    {
+        if (fieldCount != 2)
+            Fail("a ROWS line needs a type and a name.");
+        std::string_view type = fields[0];
+        std::string_view name = fields[1];
+
+        int index;
+        if (type == "N")
+        {
+            index = objectiveFound ? FREE_ROW : OBJECTIVE_ROW;
+            objectiveFound = true;
+        }
+        else if (type == "L" || type == "G" || type == "E")
+        {
+            index = static_cast<int>(rowType.size());
+            rowType.push_back(type[0]);
+            result.rowNames.emplace_back(name);
+            result.model.rhs.push_back(0.0);
+            result.model.senses.push_back(type == "L" ? 0 : 1);
+        }
+        else
+        {
+            Fail("unknown row type '" + std::string(type) + "'.");
+        }
+        if (!rowMap.Insert(name, index))
+            Fail("row '" + std::string(name) + "' is declared twice.");
+    }
+
+    // an E row is a >= row plus a <= twin after all the declared rows
+    void BeginColumns()
+    {
+        if (columnsBegun)
+            return;
+        columnsBegun = true;
+        twinRow.assign(rowType.size(), -1);
+        for (int i = 0; i < static_cast<int>(rowType.size()); i++)
+        {
+            if (rowType[i] != 'E')
+                continue;
+            twinRow[i] = static_cast<int>(result.model.rhs.size());
+            result.rowNames.push_back(result.rowNames[i]);
+            result.model.rhs.push_back(0.0);
+            result.model.senses.push_back(0);
+        }
+    }
+
+    void EndColumns()
+    {
+        if (!columnOpen)
+            return;
+        result.model.colStart.push_back(static_cast<int>(result.model.rowIndex.size()));
+        result.model.numCols++;
+        columnOpen = false;
+    }
+
+    void ReadColumn()
+    {
+        if (fieldCount >= 3 && fields[1] == "'MARKER'")
+        {
+            if (fields[2] == "'INTORG'")
+                integerBlock = true;
+            else if (fields[2] == "'INTEND'")
+                integerBlock = false;
+            else
+                Fail("unknown marker " + std::string(fields[2]) + ".");
+            return;
+        }
+        if (fieldCount != 3 && fieldCount != 5)
+            Fail("a COLUMNS line needs a column and one or two row and value pairs.");
+
+        if (!columnOpen || fields[0] != currentCol)
+        {
+            EndColumns();
+            currentCol.assign(fields[0]);
+            if (!colMap.Insert(currentCol, result.model.numCols))
+                Fail("the entries of column '" + currentCol + "' are not in one block.");
+            result.model.objective.push_back(0.0);
+            result.lower.push_back(0.0);
+            result.upper.push_back(std::numeric_limits<double>::infinity());
+            result.isInteger.push_back(integerBlock);
+            result.colNames.push_back(currentCol);
+            columnOpen = true;
+        }
+
+        for (int k = 1; k + 1 < fieldCount; k += 2)
+        {
+            int row = FindRow(fields[k]);
+            double value = Number(fields[k + 1]);
+            if (row == OBJECTIVE_ROW)
+            {
+                result.model.objective.back() += value;
+                continue;
+            }
+            if (row == FREE_ROW || value == 0.0)
+                continue;
+            result.model.rowIndex.push_back(row);
+            result.model.values.push_back(value);
+            if (twinRow[row] != -1)
+            {
+                result.model.rowIndex.push_back(twinRow[row]);
+                result.model.values.push_back(value);
+            }
+        }
+    }
+
+    // RHS and RANGES lines carry an optional set name in front of their pairs
+    void ReadRowValues(bool isRange)
+    {
+        if (fieldCount < 2 || fieldCount > 5)
+            Fail("a RHS or RANGES line needs one or two row and value pairs.");
+        for (int k = fieldCount % 2; k + 1 < fieldCount; k += 2)
+        {
+            int row = FindRow(fields[k]);
+            double value = Number(fields[k + 1]);
+            if (row == FREE_ROW)
+                continue;
+            if (isRange)
+            {
+                if (row != OBJECTIVE_ROW)
+                    ranges.push_back({row, value});
+            }
+            else if (row == OBJECTIVE_ROW)
+            {
+                result.objectiveOffset = -value;
+            }
+            else
+            {
+                result.model.rhs[row] = value;
+                if (twinRow[row] != -1)
+                    result.model.rhs[twinRow[row]] = value;
+            }
+        }
+    }
+
+    void ReadBound()
+    {
+        if (fieldCount < 2)
+            Fail("a BOUNDS line needs a type and a column.");
+        std::string_view type = fields[0];
+        bool hasValue = type == "UP" || type == "LO" || type == "FX" || type == "LI" || type == "UI";
+        if (type == "SC")
+            Fail("semi-continuous bounds are not supported.");
+
+        // type [set] column [value]
+        std::string_view colName;
+        std::string_view valueText;
+        if (fieldCount == 4)
+        {
+            colName = fields[2];
+            valueText = fields[3];
+        }
+        else if (fieldCount == 3)
+        {
+            colName = hasValue ? fields[1] : fields[2];
+            valueText = hasValue ? fields[2] : std::string_view();
+        }
+        else if (fieldCount == 2 && !hasValue)
+        {
+            colName = fields[1];
+        }
+        else
+        {
+            Fail("malformed BOUNDS line.");
+        }
+
+        int j = FindCol(colName);
+        double value = valueText.empty() ? 0.0 : Number(valueText);
+        if (value >= INFINITE_BOUND)
+            value = std::numeric_limits<double>::infinity();
+        else if (value <= -INFINITE_BOUND)
+            value = -std::numeric_limits<double>::infinity();
+
+        const double inf = std::numeric_limits<double>::infinity();
+        if (type == "UP" || type == "UI")
+        {
+            // the old convention: a negative upper bound on a column still at its default lower bound frees it below
+            if (value < 0.0 && result.lower[j] == 0.0)
+                result.lower[j] = -inf;
+            result.upper[j] = value;
+        }
+        else if (type == "LO" || type == "LI")
+        {
+            result.lower[j] = value;
+        }
+        else if (type == "FX")
+        {
+            result.lower[j] = result.upper[j] = value;
+        }
+        else if (type == "FR")
+        {
+            result.lower[j] = -inf;
+            result.upper[j] = inf;
+        }
+        else if (type == "MI")
+        {
+            result.lower[j] = -inf;
+        }
+        else if (type == "PL")
+        {
+            result.upper[j] = inf;
+        }
+        else if (type == "BV")
+        {
+            result.lower[j] = 0.0;
+            result.upper[j] = 1.0;
+        }
+        else
+        {
+            Fail("unknown bound type '" + std::string(type) + "'.");
+        }
+        if (type == "LI" || type == "UI" || type == "BV")
+            result.isInteger[j] = true;
+    }
+
+    // a ranged row [lo, hi] is its own row for one side and a twin for the other
+    void ApplyRanges()
+    {
+        SparseLPModel &model = result.model;
+        std::vector<int> rangeTwin(rowType.size(), -1);
+        for (const auto &[row, range] : ranges)
+        {
+            double b = model.rhs[row];
+            if (rowType[row] == 'E')
+            {
+                if (range >= 0.0)
+                    model.rhs[twinRow[row]] = b + range;
+                else
+                    model.rhs[row] = b + range;
+                continue;
+            }
+            if (rangeTwin[row] == -1)
+            {
+                rangeTwin[row] = static_cast<int>(model.rhs.size());
+                result.rowNames.push_back(result.rowNames[row]);
+                model.rhs.push_back(0.0);
+                model.senses.push_back(rowType[row] == 'G' ? 0 : 1);
+            }
+            model.rhs[rangeTwin[row]] = rowType[row] == 'G' ? b + std::abs(range) : b - std::abs(range);
+        }
+
+        bool anyTwin = std::any_of(rangeTwin.begin(), rangeTwin.end(), [](int r)
+                                   { return r != -1; });
+        if (!anyTwin)
+            return;
+
+        std::vector<int> colStart(1, 0);
+        std::vector<int> rowIndex;
+        std::vector<double> values;
+        rowIndex.reserve(model.rowIndex.size());
+        values.reserve(model.values.size());
+        for (int j = 0; j < model.numCols; j++)
+        {
+            for (int k = model.colStart[j]; k < model.colStart[j + 1]; k++)
+            {
+                int row = model.rowIndex[k];
+                rowIndex.push_back(row);
+                values.push_back(model.values[k]);
+                if (row < static_cast<int>(rangeTwin.size()) && rangeTwin[row] != -1)
+                {
+                    rowIndex.push_back(rangeTwin[row]);
+                    values.push_back(model.values[k]);
+                }
+            }
+            colStart.push_back(static_cast<int>(rowIndex.size()));
+        }
+        model.colStart = std::move(colStart);
+        model.rowIndex = std::move(rowIndex);
+        model.values = std::move(values);
+    }
+
+public:
+    MpsReader(MpsFormat format = MpsFormat::Free) : format(format) {}
+
+    void SetFormat(MpsFormat newFormat) { format = newFormat; }
+    MpsFormat GetFormat() const { return format; }
+
+    ModelFile Read(ModelInput &input)
+    {
+        Reset();
+        Section section = Section::None;
+        std::string_view text;
+        while (section != Section::End && input.NextLine(text))
+        {
+            line = input.LineNumber();
+            if (text.empty() || text[0] == '*' || Parsing::Trim(text).empty())
+                continue;
+
+            if (!std::isspace(static_cast<unsigned char>(text[0])))
+            {
+                section = StartSection(text);
+                continue;
+            }
+
+            Split(text, format == MpsFormat::Fixed);
+            switch (section)
+            {
+            case Section::ObjSense:
+                ReadObjSense(fields[0]);
+                break;
+            case Section::Rows:
+                ReadRow();
+                break;
+            case Section::Columns:
+                ReadColumn();
+                break;
+            case Section::Rhs:
+                ReadRowValues(false);
+                break;
+            case Section::Ranges:
+                ReadRowValues(true);
+                break;
+            case Section::Bounds:
+                ReadBound();
+                break;
+            default:
+                Fail("data line outside a section.");
+            }
+        }
+        BeginColumns();
+        EndColumns();
+
+        ApplyRanges();
+        result.model.numRows = static_cast<int>(result.model.rhs.size());
+        return std::move(result);
+    }
+
+    ModelFile ReadFile(const std::string &path)
+    {
+        ModelInput input;
+        input.OpenFile(path);
+        return Read(input);
+    }
+
+    ModelFile ReadStream(std::istream &in)
+    {
+        ModelInput input;
+        input.OpenStream(in);
+        return Read(input);
+    }
+
+    ModelFile ReadText(std::string_view text)
+    {
+        ModelInput input;
+        input.OpenText(text);
+        return Read(input);
+    }
+};
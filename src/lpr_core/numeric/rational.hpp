@@ -0,0 +1,542 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <bit>
+#include <compare>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// Arbitrary precision signed integer on base 2^32 limbs, least significant first. Only what exact
+// rational simplex arithmetic needs: add, subtract, multiply, divide with remainder and gcd.
+class BigInt
+{
+private:
+    using Mag = std::vector<std::uint32_t>;
+
+    bool negative = false;
+    Mag mag;
+
+    void Trim()
+    {
+        while (!mag.empty() && mag.back() == 0)
+            mag.pop_back();
+        if (mag.empty())
+            negative = false;
+    }
+
+    static int CompareMag(const Mag &a, const Mag &b)
+    {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (std::size_t i = a.size(); i-- > 0;)
+        {
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static Mag AddMag(const Mag &a, const Mag &b)
+    {
+        const Mag &longer = a.size() >= b.size() ? a : b;
+        const Mag &shorter = a.size() >= b.size() ? b : a;
+        Mag out(longer.size() + 1, 0);
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < longer.size(); ++i)
+        {
+            std::uint64_t sum = static_cast<std::uint64_t>(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+            out[i] = static_cast<std::uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        out[longer.size()] = static_cast<std::uint32_t>(carry);
+        return out;
+    }
+
+    // requires |a| >= |b|
+    static Mag SubMag(const Mag &a, const Mag &b)
+    {
+        Mag out(a.size(), 0);
+        std::int64_t borrow = 0;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            std::int64_t diff = static_cast<std::int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+            borrow = diff < 0 ? 1 : 0;
+            out[i] = static_cast<std::uint32_t>(diff);
+        }
+        return out;
+    }
+
+    static Mag MulMag(const Mag &a, const Mag &b)
+    {
+        if (a.empty() || b.empty())
+            return {};
+        Mag out(a.size() + b.size(), 0);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < b.size(); ++j)
+            {
+                std::uint64_t cur = static_cast<std::uint64_t>(a[i]) * b[j] + out[i + j] + carry;
+                out[i + j] = static_cast<std::uint32_t>(cur);
+                carry = cur >> 32;
+            }
+            out[i + b.size()] = static_cast<std::uint32_t>(carry);
+        }
+        return out;
+    }
+
+    static Mag ShiftLeftMag(const Mag &a, int bits, std::size_t extraLimbs = 0)
+    {
+        int limbs = bits / 32;
+        bits %= 32;
+        Mag out(a.size() + limbs + 1 + extraLimbs, 0);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            std::uint64_t cur = static_cast<std::uint64_t>(a[i]) << bits;
+            out[i + limbs] |= static_cast<std::uint32_t>(cur);
+            out[i + limbs + 1] |= static_cast<std::uint32_t>(cur >> 32);
+        }
+        return out;
+    }
+
+    static Mag ShiftRightMag(const Mag &a, int bits)
+    {
+        std::size_t limbs = bits / 32;
+        bits %= 32;
+        if (limbs >= a.size())
+            return {};
+        Mag out(a.size() - limbs, 0);
+        for (std::size_t i = 0; i < out.size(); ++i)
+        {
+            std::uint64_t cur = a[i + limbs];
+            if (i + limbs + 1 < a.size())
+                cur |= static_cast<std::uint64_t>(a[i + limbs + 1]) << 32;
+            out[i] = static_cast<std::uint32_t>(cur >> bits);
+        }
+        return out;
+    }
+
+    // schoolbook long division (Knuth, algorithm D); v must be nonzero
+    static void DivModMag(const Mag &u, const Mag &v, Mag &q, Mag &r)
+    {
+        if (CompareMag(u, v) < 0)
+        {
+            q.clear();
+            r = u;
+            return;
+        }
+
+        const std::uint64_t base = 1ull << 32;
+        if (v.size() == 1)
+        {
+            q.assign(u.size(), 0);
+            std::uint64_t rem = 0;
+            for (std::size_t i = u.size(); i-- > 0;)
+            {
+                std::uint64_t cur = (rem << 32) | u[i];
+                q[i] = static_cast<std::uint32_t>(cur / v[0]);
+                rem = cur % v[0];
+            }
+            r = rem == 0 ? Mag{} : Mag{static_cast<std::uint32_t>(rem)};
+            return;
+        }
+
+        // shift so the divisor's top limb has its high bit set, which keeps qhat at most two too large
+        int s = std::countl_zero(v.back());
+        std::size_t n = v.size();
+        std::size_t m = u.size() - n;
+        Mag vn = ShiftLeftMag(v, s);
+        vn.resize(n);
+        Mag un = ShiftLeftMag(u, s);
+        un.resize(u.size() + 1);
+
+        q.assign(m + 1, 0);
+        for (std::size_t j = m + 1; j-- > 0;)
+        {
+            std::uint64_t num = (static_cast<std::uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+            std::uint64_t qhat = num / vn[n - 1];
+            std::uint64_t rhat = num % vn[n - 1];
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+            {
+                qhat--;
+                rhat += vn[n - 1];
+                if (rhat >= base)
+                    break;
+            }
+
+            std::int64_t borrow = 0;
+            std::uint64_t carry = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::uint64_t p = qhat * vn[i] + carry;
+                carry = p >> 32;
+                std::int64_t t = static_cast<std::int64_t>(un[i + j]) - static_cast<std::int64_t>(p & 0xffffffffull) - borrow;
+                un[i + j] = static_cast<std::uint32_t>(t);
+                borrow = t < 0 ? 1 : 0;
+            }
+            std::int64_t t = static_cast<std::int64_t>(un[j + n]) - static_cast<std::int64_t>(carry) - borrow;
+            un[j + n] = static_cast<std::uint32_t>(t);
+
+            q[j] = static_cast<std::uint32_t>(qhat);
+            if (t < 0)
+            {
+                // qhat was one too large: add the divisor back
+                q[j]--;
+                std::uint64_t c = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    std::uint64_t sum = static_cast<std::uint64_t>(un[i + j]) + vn[i] + c;
+                    un[i + j] = static_cast<std::uint32_t>(sum);
+                    c = sum >> 32;
+                }
+                un[j + n] = static_cast<std::uint32_t>(static_cast<std::uint64_t>(un[j + n]) + c);
+            }
+        }
+
+        un.resize(n);
+        r = ShiftRightMag(un, s);
+    }
+
+    static BigInt FromMag(Mag mag, bool negative)
+    {
+        BigInt out;
+        out.mag = std::move(mag);
+        out.negative = negative;
+        out.Trim();
+        return out;
+    }
+
+public:
+    BigInt() = default;
+
+    BigInt(long long value)
+    {
+        negative = value < 0;
+        unsigned long long m = negative ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+        while (m != 0)
+        {
+            mag.push_back(static_cast<std::uint32_t>(m));
+            m >>= 32;
+        }
+    }
+
+    bool IsZero() const { return mag.empty(); }
+    bool IsNegative() const { return negative; }
+    int Sign() const { return mag.empty() ? 0 : (negative ? -1 : 1); }
+    bool IsOne() const { return !negative && mag.size() == 1 && mag[0] == 1; }
+    std::size_t Limbs() const { return mag.size(); }
+
+    BigInt Abs() const { return FromMag(mag, false); }
+    BigInt operator-() const { return FromMag(mag, !negative); }
+
+    friend BigInt operator+(const BigInt &a, const BigInt &b)
+    {
+        if (a.negative == b.negative)
+            return FromMag(AddMag(a.mag, b.mag), a.negative);
+        if (CompareMag(a.mag, b.mag) >= 0)
+            return FromMag(SubMag(a.mag, b.mag), a.negative);
+        return FromMag(SubMag(b.mag, a.mag), b.negative);
+    }
+
+    friend BigInt operator-(const BigInt &a, const BigInt &b) { return a + (-b); }
+
+    friend BigInt operator*(const BigInt &a, const BigInt &b)
+    {
+        return FromMag(MulMag(a.mag, b.mag), a.negative != b.negative);
+    }
+
+    // truncating division, so the remainder takes the sign of the dividend
+    static void DivMod(const BigInt &a, const BigInt &b, BigInt &quotient, BigInt &remainder)
+    {
+        if (b.IsZero())
+        {
+            throw std::domain_error("BigInt division by zero.");
+        }
+        Mag q, r;
+        DivModMag(a.mag, b.mag, q, r);
+        quotient = FromMag(std::move(q), a.negative != b.negative);
+        remainder = FromMag(std::move(r), a.negative);
+    }
+
+    friend BigInt operator/(const BigInt &a, const BigInt &b)
+    {
+        BigInt q, r;
+        DivMod(a, b, q, r);
+        return q;
+    }
+
+    static BigInt Gcd(BigInt a, BigInt b)
+    {
+        a = a.Abs();
+        b = b.Abs();
+        while (!b.IsZero())
+        {
+            BigInt q, r;
+            DivMod(a, b, q, r);
+            a = std::move(b);
+            b = std::move(r);
+        }
+        return a;
+    }
+
+    BigInt ShiftLeft(int bits) const { return FromMag(ShiftLeftMag(mag, bits), negative); }
+
+    int BitLength() const
+    {
+        if (mag.empty())
+            return 0;
+        return static_cast<int>(mag.size() * 32) - std::countl_zero(mag.back());
+    }
+
+    // the top 64 bits as a double times 2^shift, so huge values keep their leading digits
+    double ToDouble(int &shift) const
+    {
+        int bits = BitLength();
+        shift = std::max(0, bits - 64);
+        Mag top = ShiftRightMag(mag, shift);
+        std::uint64_t v = 0;
+        for (std::size_t i = std::min<std::size_t>(top.size(), 2); i-- > 0;)
+            v = (v << 32) | top[i];
+        double d = static_cast<double>(v);
+        return negative ? -d : d;
+    }
+
+    double ToDouble() const
+    {
+        int shift = 0;
+        double d = ToDouble(shift);
+        return std::ldexp(d, shift);
+    }
+
+    std::string ToString() const
+    {
+        if (mag.empty())
+            return "0";
+        std::vector<std::uint32_t> chunks;
+        Mag cur = mag;
+        const Mag billion = {1000000000u};
+        while (!cur.empty())
+        {
+            Mag q, r;
+            DivModMag(cur, billion, q, r);
+            chunks.push_back(r.empty() ? 0 : r[0]);
+            while (!q.empty() && q.back() == 0)
+                q.pop_back();
+            cur = std::move(q);
+        }
+        std::string out = negative ? "-" : "";
+        out += std::to_string(chunks.back());
+        for (std::size_t i = chunks.size() - 1; i-- > 0;)
+        {
+            std::string part = std::to_string(chunks[i]);
+            out += std::string(9 - part.size(), '0') + part;
+        }
+        return out;
+    }
+
+    friend bool operator==(const BigInt &a, const BigInt &b) { return a.negative == b.negative && a.mag == b.mag; }
+
+    friend std::strong_ordering operator<=>(const BigInt &a, const BigInt &b)
+    {
+        if (a.Sign() != b.Sign())
+            return a.Sign() <=> b.Sign();
+        int cmp = CompareMag(a.mag, b.mag);
+        if (a.negative)
+            cmp = -cmp;
+        return cmp <=> 0;
+    }
+};
+
+// Exact rational num / den kept in lowest terms with a positive denominator. A zero denominator
+// marks +-infinity, the sentinel of the ratio tests: it compares, and adding a finite value leaves it
+// unchanged, but any other arithmetic on it throws.
+class Rational
+{
+private:
+    BigInt num;
+    BigInt den = 1;
+
+    void Normalize()
+    {
+        if (den.IsZero())
+        {
+            num = num.Sign() < 0 ? -1 : 1;
+            return;
+        }
+        if (den.IsNegative())
+        {
+            num = -num;
+            den = -den;
+        }
+        if (num.IsZero())
+        {
+            den = 1;
+            return;
+        }
+        if (den.IsOne())
+            return;
+        BigInt g = BigInt::Gcd(num, den);
+        if (!g.IsOne())
+        {
+            num = num / g;
+            den = den / g;
+        }
+    }
+
+    void RequireFinite(const Rational &other) const
+    {
+        if (IsInfinite() || other.IsInfinite())
+        {
+            throw std::domain_error("Arithmetic on an infinite Rational.");
+        }
+    }
+
+    // inf + finite stays inf; inf - inf has no value
+    static Rational AddInfinite(const Rational &a, const Rational &b)
+    {
+        if (a.IsInfinite() && b.IsInfinite() && a.num.Sign() != b.num.Sign())
+        {
+            throw std::domain_error("Infinite Rationals of opposite sign added.");
+        }
+        return a.IsInfinite() ? a : b;
+    }
+
+public:
+    Rational() = default;
+    Rational(int value) : num(value) {}
+    Rational(long long value) : num(value) {}
+    Rational(BigInt numerator, BigInt denominator) : num(std::move(numerator)), den(std::move(denominator))
+    {
+        if (den.IsZero() && num.IsZero())
+        {
+            throw std::domain_error("Rational 0/0.");
+        }
+        Normalize();
+    }
+
+    // exact: every finite double is a dyadic rational
+    explicit Rational(double value)
+    {
+        if (std::isinf(value))
+        {
+            num = value < 0 ? -1 : 1;
+            den = 0;
+            return;
+        }
+        if (std::isnan(value))
+        {
+            throw std::domain_error("Rational from NaN.");
+        }
+        int exp = 0;
+        double frac = std::frexp(value, &exp);
+        long long mantissa = static_cast<long long>(std::ldexp(frac, 53));
+        exp -= 53;
+        num = mantissa;
+        den = 1;
+        if (exp > 0)
+            num = num.ShiftLeft(exp);
+        else if (exp < 0)
+            den = den.ShiftLeft(-exp);
+        Normalize();
+    }
+
+    static Rational Infinity(bool negativeInf = false) { return Rational(BigInt(negativeInf ? -1 : 1), BigInt(0)); }
+
+    bool IsInfinite() const { return den.IsZero(); }
+    bool IsZero() const { return num.IsZero(); }
+    int Sign() const { return num.Sign(); }
+    const BigInt &Numerator() const { return num; }
+    const BigInt &Denominator() const { return den; }
+
+    double ToDouble() const
+    {
+        if (IsInfinite())
+            return num.Sign() < 0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+        int shiftNum = 0, shiftDen = 0;
+        double n = num.ToDouble(shiftNum);
+        double d = den.ToDouble(shiftDen);
+        return std::ldexp(n / d, shiftNum - shiftDen);
+    }
+
+    std::string ToString() const
+    {
+        if (IsInfinite())
+            return num.Sign() < 0 ? "-inf" : "inf";
+        return den.IsOne() ? num.ToString() : num.ToString() + "/" + den.ToString();
+    }
+
+    Rational operator-() const
+    {
+        Rational out = *this;
+        out.num = -out.num;
+        return out;
+    }
+
+    friend Rational operator+(const Rational &a, const Rational &b)
+    {
+        if (a.IsInfinite() || b.IsInfinite())
+            return AddInfinite(a, b);
+        if (a.den == b.den)
+            return Rational(a.num + b.num, a.den);
+        return Rational(a.num * b.den + b.num * a.den, a.den * b.den);
+    }
+
+    friend Rational operator-(const Rational &a, const Rational &b)
+    {
+        if (a.IsInfinite() || b.IsInfinite())
+            return AddInfinite(a, -b);
+        if (a.den == b.den)
+            return Rational(a.num - b.num, a.den);
+        return Rational(a.num * b.den - b.num * a.den, a.den * b.den);
+    }
+
+    friend Rational operator*(const Rational &a, const Rational &b)
+    {
+        a.RequireFinite(b);
+        if (a.IsZero() || b.IsZero())
+            return Rational();
+        return Rational(a.num * b.num, a.den * b.den);
+    }
+
+    friend Rational operator/(const Rational &a, const Rational &b)
+    {
+        a.RequireFinite(b);
+        if (b.IsZero())
+        {
+            throw std::domain_error("Rational division by zero.");
+        }
+        return Rational(a.num * b.den, a.den * b.num);
+    }
+
+    Rational &operator+=(const Rational &other) { return *this = *this + other; }
+    Rational &operator-=(const Rational &other) { return *this = *this - other; }
+    Rational &operator*=(const Rational &other) { return *this = *this * other; }
+    Rational &operator/=(const Rational &other) { return *this = *this / other; }
+
+    friend bool operator==(const Rational &a, const Rational &b) { return a.num == b.num && a.den == b.den; }
+
+    friend std::strong_ordering operator<=>(const Rational &a, const Rational &b)
+    {
+        if (a.IsInfinite() || b.IsInfinite())
+        {
+            int rankA = a.IsInfinite() ? a.num.Sign() : 0;
+            int rankB = b.IsInfinite() ? b.num.Sign() : 0;
+            if (rankA != rankB)
+                return rankA <=> rankB;
+            if (rankA != 0)
+                return std::strong_ordering::equal;
+        }
+        if (a.num.Sign() != b.num.Sign())
+            return a.num.Sign() <=> b.num.Sign();
+        if (a.den == b.den)
+            return a.num <=> b.num;
+        return a.num * b.den <=> b.num * a.den;
+    }
+
+    friend Rational abs(const Rational &value) { return value.Sign() < 0 ? -value : value; }
+};
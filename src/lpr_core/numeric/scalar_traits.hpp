@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "rational.hpp"
+
+// Compile-time tolerance policy for the scalar a tableau is stored in. PivotTolerance is the
+// smallest magnitude the ratio tests accept as a pivot, FeasibilityTolerance how far below zero a
+// rhs may sit and still count as feasible. The double values are the ones the solvers always used.
+template <typename Scalar>
+struct ScalarTraits;
+
+template <>
+struct ScalarTraits<double>
+{
+    static constexpr bool IsExact = false;
+    static double PivotTolerance() { return 1e-12; }
+    static double FeasibilityTolerance() { return 1e-9; }
+    static double Infinity() { return std::numeric_limits<double>::infinity(); }
+    static double Abs(double value) { return std::abs(value); }
+    static double FromDouble(double value) { return value; }
+    static double ToDouble(double value) { return value; }
+};
+
+// float halves the bytes every pivot streams, so its tolerances sit just above its epsilon
+template <>
+struct ScalarTraits<float>
+{
+    static constexpr bool IsExact = false;
+    static float PivotTolerance() { return 1e-6f; }
+    static float FeasibilityTolerance() { return 1e-5f; }
+    static float Infinity() { return std::numeric_limits<float>::infinity(); }
+    static float Abs(float value) { return std::abs(value); }
+    static float FromDouble(double value) { return static_cast<float>(value); }
+    static double ToDouble(float value) { return value; }
+};
+
+template <>
+struct ScalarTraits<long double>
+{
+    static constexpr bool IsExact = false;
+    static long double PivotTolerance() { return 1e-15L; }
+    static long double FeasibilityTolerance() { return 1e-12L; }
+    static long double Infinity() { return std::numeric_limits<long double>::infinity(); }
+    static long double Abs(long double value) { return std::abs(value); }
+    static long double FromDouble(double value) { return value; }
+    static double ToDouble(long double value) { return static_cast<double>(value); }
+};
+
+// exact arithmetic needs no slack: zero means zero
+template <>
+struct ScalarTraits<Rational>
+{
+    static constexpr bool IsExact = true;
+    static Rational PivotTolerance() { return Rational(); }
+    static Rational FeasibilityTolerance() { return Rational(); }
+    static Rational Infinity() { return Rational::Infinity(); }
+    static Rational Abs(const Rational &value) { return abs(value); }
+    static Rational FromDouble(double value) { return Rational(value); }
+    static double ToDouble(const Rational &value) { return value.ToDouble(); }
+};
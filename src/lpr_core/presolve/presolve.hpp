@@ -0,0 +1,580 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <algorithm>
+
+#include "lp_model.hpp"
+
+enum class PresolveStatus
+{
+    Reduced,
+    Infeasible,
+    Unbounded
+};
+
+// what the last presolve removed; a row or column is counted once, under the reduction that removed it
+struct PresolveStats
+{
+    int passes = 0;
+    int emptyRows = 0;
+    int singletonRows = 0;
+    int duplicateRows = 0;
+    int redundantRows = 0;
+    int forcingRows = 0;
+    int fixedCols = 0;
+    int emptyCols = 0;
+    int dominatedCols = 0;
+    int rowsBefore = 0;
+    int rowsAfter = 0;
+    int colsBefore = 0;
+    int colsAfter = 0;
+    int nonZerosBefore = 0;
+    int nonZerosAfter = 0;
+};
+
+// Removes empty, singleton, duplicate, redundant and forcing rows and fixed, empty and dominated
+// columns before a solve. Singleton rows are read as column bounds; the tightest one per bound
+// stays in the model unless it fixes the column. Declared column bounds take part in every test and
+// come back renumbered for the kept columns. DoPostsolve maps a solution of the reduced model
+// back to the original one. Duals are shadow prices, d = c - A^T y being the reduced costs.
+class Presolve
+{
+private:
+    static constexpr double EPS = 1e-9;
+
+    struct Entry
+    {
+        int index;
+        double value;
+    };
+
+    // replayed in reverse by postsolve to recover the duals of rows that carried a removed column
+    struct Reduction
+    {
+        enum class Kind
+        {
+            FixColumn,
+            ForcingRow
+        };
+        Kind kind;
+        int index;
+        std::vector<int> rows;
+        std::vector<int> cols;
+    };
+
+    SparseLPModel original;
+    bool isMin = false;
+
+    std::vector<std::vector<Entry>> rowEntries;
+    std::vector<double> rhs;
+    std::vector<char> rowActive;
+    std::vector<char> colActive;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<double> declaredLower;
+    std::vector<double> declaredUpper;
+    std::vector<int> lowerRow;
+    std::vector<int> upperRow;
+    std::vector<double> fixedValue;
+    double objectiveOffset = 0.0;
+
+    std::vector<Reduction> reductions;
+    std::vector<int> rowMap;
+    std::vector<int> colMap;
+    PresolveStats stats;
+
+    static constexpr double INF = std::numeric_limits<double>::infinity();
+
+    bool IsUpperBoundRow(int i, double a) const
+    {
+        return original.IsGreaterEqual(i) ? a < 0.0 : a > 0.0;
+    }
+
+    // +1 when the shadow price of row i is nonnegative at an optimum, -1 when nonpositive
+    double DualSign(int i) const
+    {
+        return original.IsGreaterEqual(i) == isMin ? 1.0 : -1.0;
+    }
+
+    int ActiveCount(int i, Entry *last = nullptr) const
+    {
+        int count = 0;
+        for (const auto &e : rowEntries[i])
+        {
+            if (!colActive[e.index])
+                continue;
+            count++;
+            if (last)
+                *last = e;
+        }
+        return count;
+    }
+
+    void RemoveRow(int i, int &counter)
+    {
+        rowActive[i] = false;
+        counter++;
+    }
+
+    void FixColumn(int j, double value, int &counter)
+    {
+        colActive[j] = false;
+        fixedValue[j] = value;
+        objectiveOffset += original.objective[j] * value;
+        for (int k = original.ColBegin(j); k < original.ColEnd(j); ++k)
+        {
+            rhs[original.rowIndex[k]] -= original.values[k] * value;
+        }
+
+        Reduction red{Reduction::Kind::FixColumn, j, {}, {}};
+        if (lowerRow[j] != -1)
+            red.rows.push_back(lowerRow[j]);
+        if (upperRow[j] != -1 && upperRow[j] != lowerRow[j])
+            red.rows.push_back(upperRow[j]);
+        reductions.push_back(red);
+        counter++;
+    }
+
+    bool IsFavorable(double cost) const
+    {
+        return isMin ? cost < 0.0 : cost > 0.0;
+    }
+
+    PresolveStatus RowPass(bool &changed)
+    {
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (!rowActive[i])
+                continue;
+
+            Entry last{-1, 0.0};
+            int count = ActiveCount(i, &last);
+            bool ge = original.IsGreaterEqual(i);
+
+            if (count == 0)
+            {
+                if (ge ? rhs[i] > EPS : rhs[i] < -EPS)
+                    return PresolveStatus::Infeasible;
+                RemoveRow(i, stats.emptyRows);
+                changed = true;
+                continue;
+            }
+
+            if (count != 1)
+                continue;
+
+            int j = last.index;
+            double bound = rhs[i] / last.value;
+            if (IsUpperBoundRow(i, last.value))
+            {
+                if (upperRow[j] == i)
+                    continue;
+                if (bound < upper[j] - EPS)
+                {
+                    if (upperRow[j] != -1)
+                        RemoveRow(upperRow[j], stats.singletonRows);
+                    upper[j] = bound;
+                    upperRow[j] = i;
+                }
+                else
+                {
+                    RemoveRow(i, stats.singletonRows);
+                }
+            }
+            else
+            {
+                if (lowerRow[j] == i)
+                    continue;
+                if (bound > lower[j] + EPS)
+                {
+                    if (lowerRow[j] != -1)
+                        RemoveRow(lowerRow[j], stats.singletonRows);
+                    lower[j] = bound;
+                    lowerRow[j] = i;
+                }
+                else
+                {
+                    RemoveRow(i, stats.singletonRows);
+                }
+            }
+            changed = true;
+
+            if (upper[j] < lower[j] - EPS)
+                return PresolveStatus::Infeasible;
+        }
+        return PresolveStatus::Reduced;
+    }
+
+    PresolveStatus ColumnPass(bool &changed)
+    {
+        for (int j = 0; j < original.numCols; ++j)
+        {
+            if (!colActive[j])
+                continue;
+
+            if (upper[j] - lower[j] <= EPS)
+            {
+                FixColumn(j, lower[j], stats.fixedCols);
+                changed = true;
+                continue;
+            }
+
+            // increasing a column that only tightens its rows and does not help the objective never pays
+            bool onlyTightens = true;
+            bool empty = true;
+            for (int k = original.ColBegin(j); k < original.ColEnd(j); ++k)
+            {
+                int i = original.rowIndex[k];
+                if (!rowActive[i])
+                    continue;
+                empty = false;
+                if (!IsUpperBoundRow(i, original.values[k]))
+                    onlyTightens = false;
+            }
+
+            double cost = original.objective[j];
+            if (empty)
+            {
+                if (IsFavorable(cost))
+                {
+                    if (!std::isfinite(upper[j]))
+                        return PresolveStatus::Unbounded;
+                    FixColumn(j, upper[j], stats.emptyCols);
+                }
+                else if (std::isfinite(lower[j]))
+                {
+                    FixColumn(j, lower[j], stats.emptyCols);
+                }
+                else
+                {
+                    continue;
+                }
+                changed = true;
+            }
+            else if (onlyTightens && !IsFavorable(cost) && std::isfinite(lower[j]))
+            {
+                FixColumn(j, lower[j], stats.dominatedCols);
+                changed = true;
+            }
+        }
+        return PresolveStatus::Reduced;
+    }
+
+    PresolveStatus ActivityPass(bool &changed)
+    {
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (!rowActive[i] || ActiveCount(i) < 2)
+                continue;
+
+            double minAct = 0.0, maxAct = 0.0;
+            for (const auto &e : rowEntries[i])
+            {
+                if (!colActive[e.index])
+                    continue;
+                int j = e.index;
+                minAct += e.value > 0.0 ? e.value * lower[j] : e.value * upper[j];
+                maxAct += e.value > 0.0 ? e.value * upper[j] : e.value * lower[j];
+            }
+
+            bool ge = original.IsGreaterEqual(i);
+            double scale = std::max(1.0, std::abs(rhs[i]));
+            // the side of the activity range that can violate the row, and the side that can keep it
+            double tight = ge ? maxAct : minAct;
+            double loose = ge ? minAct : maxAct;
+
+            if (ge ? loose >= rhs[i] - EPS * scale : loose <= rhs[i] + EPS * scale)
+            {
+                RemoveRow(i, stats.redundantRows);
+                changed = true;
+            }
+            else if (ge ? tight < rhs[i] - EPS * scale : tight > rhs[i] + EPS * scale)
+            {
+                return PresolveStatus::Infeasible;
+            }
+            else if (std::isfinite(tight) && std::abs(tight - rhs[i]) <= EPS * scale)
+            {
+                // every column has to sit at the bound that produces the tight activity
+                Reduction red{Reduction::Kind::ForcingRow, i, {}, {}};
+                std::vector<std::pair<int, double>> forced;
+                for (const auto &e : rowEntries[i])
+                {
+                    if (!colActive[e.index])
+                        continue;
+                    bool atUpper = ge ? e.value > 0.0 : e.value < 0.0;
+                    forced.push_back({e.index, atUpper ? upper[e.index] : lower[e.index]});
+                }
+                for (const auto &[j, value] : forced)
+                {
+                    FixColumn(j, value, stats.fixedCols);
+                    red.cols.push_back(j);
+                }
+                reductions.push_back(red);
+                RemoveRow(i, stats.forcingRows);
+                changed = true;
+            }
+        }
+        return PresolveStatus::Reduced;
+    }
+
+    PresolveStatus DuplicatePass(bool &changed)
+    {
+        // rows are compared after dividing by their first coefficient, which flips the sense when it is negative
+        std::map<std::vector<std::pair<int, long long>>, std::vector<int>> groups;
+        std::vector<double> pivot(original.numRows, 0.0);
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (!rowActive[i] || ActiveCount(i) < 2)
+                continue;
+
+            std::vector<std::pair<int, long long>> key;
+            for (const auto &e : rowEntries[i])
+            {
+                if (!colActive[e.index])
+                    continue;
+                if (pivot[i] == 0.0)
+                    pivot[i] = e.value;
+                key.push_back({e.index, std::llround(e.value / pivot[i] * 1e9)});
+            }
+            groups[key].push_back(i);
+        }
+
+        for (const auto &[key, rows] : groups)
+        {
+            int keepUpper = -1, keepLower = -1;
+            double upperRhs = INF, lowerRhs = -INF;
+            for (int i : rows)
+            {
+                double normRhs = rhs[i] / pivot[i];
+                bool isUpper = original.IsGreaterEqual(i) == (pivot[i] < 0.0);
+                int &keep = isUpper ? keepUpper : keepLower;
+                bool tighter = isUpper ? normRhs < upperRhs : normRhs > lowerRhs;
+                if (keep != -1)
+                {
+                    RemoveRow(tighter ? keep : i, stats.duplicateRows);
+                    changed = true;
+                }
+                if (keep == -1 || tighter)
+                {
+                    keep = i;
+                    (isUpper ? upperRhs : lowerRhs) = normRhs;
+                }
+            }
+            if (lowerRhs > upperRhs + EPS * std::max(1.0, std::abs(upperRhs)))
+                return PresolveStatus::Infeasible;
+        }
+        return PresolveStatus::Reduced;
+    }
+
+    SparseLPModel BuildReducedModel(std::vector<double> &reducedLower, std::vector<double> &reducedUpper)
+    {
+        rowMap.assign(original.numRows, -1);
+        colMap.assign(original.numCols, -1);
+        reducedLower.clear();
+        reducedUpper.clear();
+
+        std::vector<double> newRhs;
+        std::vector<int> newSenses;
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (!rowActive[i])
+                continue;
+            rowMap[i] = static_cast<int>(newRhs.size());
+            newRhs.push_back(rhs[i]);
+            newSenses.push_back(original.senses[i]);
+        }
+
+        SparseLPModel reduced(static_cast<int>(newRhs.size()), newRhs, newSenses);
+        for (int j = 0; j < original.numCols; ++j)
+        {
+            if (!colActive[j])
+                continue;
+            colMap[j] = reduced.numCols;
+            reducedLower.push_back(declaredLower[j]);
+            reducedUpper.push_back(declaredUpper[j]);
+            std::vector<std::pair<int, double>> entries;
+            for (int k = original.ColBegin(j); k < original.ColEnd(j); ++k)
+            {
+                int row = rowMap[original.rowIndex[k]];
+                if (row != -1)
+                    entries.push_back({row, original.values[k]});
+            }
+            reduced.AddColumn(original.objective[j], entries);
+        }
+        return reduced;
+    }
+
+public:
+    struct PresolveResult
+    {
+        PresolveStatus status;
+        SparseLPModel model;
+        double objectiveOffset;
+        PresolveStats stats;
+        // declared bounds of the kept columns; bounds read from singleton rows stay in the model as rows
+        std::vector<double> colLower;
+        std::vector<double> colUpper;
+    };
+
+    struct PostsolveResult
+    {
+        std::vector<double> changingVars;
+        std::vector<double> duals;
+        double optimalSolution;
+    };
+
+    // colLower and colUpper may be shorter than the column count, missing entries being 0 and +inf
+    PresolveResult DoPresolve(const SparseLPModel &model, bool isMin, const std::vector<double> &colLower = {}, const std::vector<double> &colUpper = {})
+    {
+        original = model;
+        this->isMin = isMin;
+
+        rowEntries.assign(model.numRows, {});
+        for (int j = 0; j < model.numCols; ++j)
+        {
+            for (int k = model.ColBegin(j); k < model.ColEnd(j); ++k)
+            {
+                rowEntries[model.rowIndex[k]].push_back({j, model.values[k]});
+            }
+        }
+        rhs = model.rhs;
+        rowActive.assign(model.numRows, true);
+        colActive.assign(model.numCols, true);
+        declaredLower.assign(model.numCols, 0.0);
+        declaredUpper.assign(model.numCols, INF);
+        std::copy_n(colLower.begin(), std::min<size_t>(colLower.size(), model.numCols), declaredLower.begin());
+        std::copy_n(colUpper.begin(), std::min<size_t>(colUpper.size(), model.numCols), declaredUpper.begin());
+        lower = declaredLower;
+        upper = declaredUpper;
+        lowerRow.assign(model.numCols, -1);
+        upperRow.assign(model.numCols, -1);
+        fixedValue.assign(model.numCols, 0.0);
+        objectiveOffset = 0.0;
+        reductions.clear();
+
+        stats = PresolveStats();
+        stats.rowsBefore = model.numRows;
+        stats.colsBefore = model.numCols;
+        stats.nonZerosBefore = model.NumNonZeros();
+
+        PresolveStatus status = PresolveStatus::Reduced;
+        bool changed = true;
+        while (changed && status == PresolveStatus::Reduced && stats.passes < 50)
+        {
+            changed = false;
+            stats.passes++;
+            for (auto pass : {&Presolve::RowPass, &Presolve::ColumnPass, &Presolve::DuplicatePass, &Presolve::ActivityPass})
+            {
+                status = (this->*pass)(changed);
+                if (status != PresolveStatus::Reduced)
+                    break;
+            }
+        }
+
+        std::vector<double> reducedLower, reducedUpper;
+        SparseLPModel reduced = BuildReducedModel(reducedLower, reducedUpper);
+        stats.rowsAfter = reduced.numRows;
+        stats.colsAfter = reduced.numCols;
+        stats.nonZerosAfter = reduced.NumNonZeros();
+
+        return {status, reduced, objectiveOffset, stats, reducedLower, reducedUpper};
+    }
+
+    // reducedDuals may be left empty when only the primal solution is needed
+    PostsolveResult DoPostsolve(const std::vector<double> &reducedVars, double reducedObjective, const std::vector<double> &reducedDuals = {}) const
+    {
+        PostsolveResult res;
+        res.optimalSolution = reducedObjective + objectiveOffset;
+
+        res.changingVars.assign(original.numCols, 0.0);
+        for (int j = 0; j < original.numCols; ++j)
+        {
+            if (colMap[j] == -1)
+                res.changingVars[j] = fixedValue[j];
+            else if (colMap[j] < static_cast<int>(reducedVars.size()))
+                res.changingVars[j] = reducedVars[colMap[j]];
+        }
+
+        if (reducedDuals.empty())
+            return res;
+
+        std::vector<double> &y = res.duals;
+        y.assign(original.numRows, 0.0);
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (rowMap[i] != -1 && rowMap[i] < static_cast<int>(reducedDuals.size()))
+                y[i] = reducedDuals[rowMap[i]];
+        }
+
+        auto reducedCost = [&](int j)
+        {
+            double d = original.objective[j];
+            for (int k = original.ColBegin(j); k < original.ColEnd(j); ++k)
+                d -= original.values[k] * y[original.rowIndex[k]];
+            return d;
+        };
+
+        for (auto it = reductions.rbegin(); it != reductions.rend(); ++it)
+        {
+            if (it->kind == Reduction::Kind::ForcingRow)
+            {
+                // the dual has to absorb the worst reduced cost among the forced columns
+                int i = it->index;
+                double sign = DualSign(i);
+                double best = 0.0;
+                for (int j : it->cols)
+                {
+                    double a = original.Coefficient(i, j);
+                    double cand = (reducedCost(j) + a * y[i]) / a;
+                    if (sign * cand > sign * best)
+                        best = cand;
+                }
+                y[i] = best;
+                continue;
+            }
+
+            // a fixed column passes its reduced cost to the first bound row whose dual sign allows it
+            int j = it->index;
+            for (int i : it->rows)
+            {
+                double a = original.Coefficient(i, j);
+                double cand = (reducedCost(j) + a * y[i]) / a;
+                if (DualSign(i) * cand > 0.0)
+                {
+                    y[i] = cand;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    // removed rows keep their slack basic and removed columns sit at the bound they were fixed to,
+    // so the result stays a square, nonsingular basis of the original model
+    LPBasis PostsolveBasis(const LPBasis &reducedBasis) const
+    {
+        LPBasis basis;
+        basis.colStatus.assign(original.numCols, BasisStatus::AtLower);
+        basis.rowStatus.assign(original.numRows, BasisStatus::Basic);
+        for (int j = 0; j < original.numCols; ++j)
+        {
+            if (colMap[j] != -1 && colMap[j] < static_cast<int>(reducedBasis.colStatus.size()))
+                basis.colStatus[j] = reducedBasis.colStatus[colMap[j]];
+            else if (colMap[j] == -1 && std::isfinite(upper[j]) && upper[j] > lower[j] && fixedValue[j] >= upper[j])
+                basis.colStatus[j] = BasisStatus::AtUpper;
+        }
+        for (int i = 0; i < original.numRows; ++i)
+        {
+            if (rowMap[i] != -1 && rowMap[i] < static_cast<int>(reducedBasis.rowStatus.size()))
+                basis.rowStatus[i] = reducedBasis.rowStatus[rowMap[i]];
+        }
+        return basis;
+    }
+
+    const std::vector<int> &GetRowMap() const { return rowMap; }
+    const std::vector<int> &GetColMap() const { return colMap; }
+    const PresolveStats &GetStats() const { return stats; }
+};
@@ -0,0 +1,862 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "tableau.hpp"
+#include "lp_model.hpp"
+#include "degeneracy.hpp"
+
+enum class RevisedSimplexStatus
+{
+    Optimal,
+    Infeasible,
+    Unbounded,
+    IterationLimit
+};
+
+// Revised primal/dual simplex working on the same input as DualSimplex. The basis is kept as a dense
+// LU factorization with partial pivoting, each pivot appends a product form (eta) update and the
+// basis is refactorized every refactorFrequency updates. Only the final tableau is ever formed.
+class RevisedSimplex
+{
+private:
+    struct EtaColumn
+    {
+        int pivotPos;
+        double pivotValue;
+        std::vector<int> index;
+        std::vector<double> value;
+    };
+
+    bool isConsoleOutput;
+    int refactorFrequency = 50;
+    int maxIterations = 0;
+    int iterationLimit = 0;
+
+    static constexpr double FEAS_TOL = 1e-9;
+    static constexpr double OPT_TOL = 1e-9;
+    static constexpr double PIVOT_TOL = 1e-11;
+    static constexpr int DEGENERATE_LIMIT = 50;
+    static constexpr double PUSH_TOL = 1e-9;
+
+    // model in compressed sparse column form, slack columns included
+    int numRows = 0;
+    int numCols = 0;
+    int lenObj = 0;
+    std::vector<int> colStart;
+    std::vector<int> rowIndex;
+    std::vector<double> values;
+    std::vector<double> rhs;
+    std::vector<double> cost;
+    double objOffset = 0.0;
+    bool isMin = false;
+    std::vector<std::string> headerRow;
+
+    // basis state
+    std::vector<int> basis;
+    std::vector<int> basisPos;
+    std::vector<double> xB;
+    std::vector<double> lu;
+    std::vector<int> perm;
+    std::vector<EtaColumn> etas;
+
+    std::vector<int> pivotCols;
+    std::vector<int> pivotRows;
+    std::vector<int> phases;
+    RevisedSimplexStatus status = RevisedSimplexStatus::Optimal;
+    int iterationCount = 0;
+    int refactorCount = 0;
+    int degenerateCount = 0;
+    // a revisited basis switches the primal phase to Bland's rule straight away
+    BasisCycleDetector cycleDetector;
+    int cyclesDetected = 0;
+
+    double MaxCost(int j) const
+    {
+        return isMin ? -cost[j] : cost[j];
+    }
+
+    void AddColumn(const std::vector<std::pair<int, double>> &entries)
+    {
+        for (const auto &[row, val] : entries)
+        {
+            if (val != 0.0)
+            {
+                rowIndex.push_back(row);
+                values.push_back(val);
+            }
+        }
+        colStart.push_back(static_cast<int>(rowIndex.size()));
+    }
+
+    void ScatterColumn(int j, std::vector<double> &out) const
+    {
+        std::fill(out.begin(), out.end(), 0.0);
+        for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+        {
+            out[rowIndex[k]] = values[k];
+        }
+    }
+
+    double DotColumn(int j, const std::vector<double> &y) const
+    {
+        double sum = 0.0;
+        for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+        {
+            sum += values[k] * y[rowIndex[k]];
+        }
+        return sum;
+    }
+
+    void Factorize()
+    {
+        int m = numRows;
+        lu.assign(static_cast<size_t>(m) * m, 0.0);
+        for (int pos = 0; pos < m; ++pos)
+        {
+            int j = basis[pos];
+            for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+            {
+                lu[static_cast<size_t>(rowIndex[k]) * m + pos] = values[k];
+            }
+        }
+
+        perm.resize(m);
+        for (int i = 0; i < m; ++i)
+            perm[i] = i;
+
+        for (int k = 0; k < m; ++k)
+        {
+            int best = k;
+            double bestVal = std::abs(lu[static_cast<size_t>(k) * m + k]);
+            for (int i = k + 1; i < m; ++i)
+            {
+                double v = std::abs(lu[static_cast<size_t>(i) * m + k]);
+                if (v > bestVal)
+                {
+                    bestVal = v;
+                    best = i;
+                }
+            }
+            if (bestVal < PIVOT_TOL)
+            {
+                throw std::runtime_error("Revised simplex basis is singular.");
+            }
+            if (best != k)
+            {
+                std::swap_ranges(lu.begin() + static_cast<size_t>(k) * m, lu.begin() + static_cast<size_t>(k + 1) * m, lu.begin() + static_cast<size_t>(best) * m);
+                std::swap(perm[k], perm[best]);
+            }
+
+            double pivot = lu[static_cast<size_t>(k) * m + k];
+            for (int i = k + 1; i < m; ++i)
+            {
+                double &lik = lu[static_cast<size_t>(i) * m + k];
+                if (lik == 0.0)
+                    continue;
+                lik /= pivot;
+                for (int j = k + 1; j < m; ++j)
+                {
+                    lu[static_cast<size_t>(i) * m + j] -= lik * lu[static_cast<size_t>(k) * m + j];
+                }
+            }
+        }
+
+        etas.clear();
+        refactorCount++;
+
+        // recompute the basic solution from scratch after every refactorization
+        xB = rhs;
+        Ftran(xB);
+    }
+
+    // v := B^-1 v
+    void Ftran(std::vector<double> &v) const
+    {
+        int m = numRows;
+        std::vector<double> pv(m);
+        for (int i = 0; i < m; ++i)
+            pv[i] = v[perm[i]];
+
+        for (int i = 0; i < m; ++i)
+        {
+            double sum = pv[i];
+            for (int j = 0; j < i; ++j)
+                sum -= lu[static_cast<size_t>(i) * m + j] * pv[j];
+            pv[i] = sum;
+        }
+        for (int i = m - 1; i >= 0; --i)
+        {
+            double sum = pv[i];
+            for (int j = i + 1; j < m; ++j)
+                sum -= lu[static_cast<size_t>(i) * m + j] * pv[j];
+            pv[i] = sum / lu[static_cast<size_t>(i) * m + i];
+        }
+
+        for (const auto &eta : etas)
+        {
+            double vr = pv[eta.pivotPos] / eta.pivotValue;
+            if (vr != 0.0)
+            {
+                for (size_t k = 0; k < eta.index.size(); ++k)
+                    pv[eta.index[k]] -= eta.value[k] * vr;
+            }
+            pv[eta.pivotPos] = vr;
+        }
+        v.swap(pv);
+    }
+
+    // v := B^-T v
+    void Btran(std::vector<double> &v) const
+    {
+        int m = numRows;
+        for (auto it = etas.rbegin(); it != etas.rend(); ++it)
+        {
+            double sum = v[it->pivotPos];
+            for (size_t k = 0; k < it->index.size(); ++k)
+                sum -= it->value[k] * v[it->index[k]];
+            v[it->pivotPos] = sum / it->pivotValue;
+        }
+
+        for (int i = 0; i < m; ++i)
+        {
+            double sum = v[i];
+            for (int j = 0; j < i; ++j)
+                sum -= lu[static_cast<size_t>(j) * m + i] * v[j];
+            v[i] = sum / lu[static_cast<size_t>(i) * m + i];
+        }
+        for (int i = m - 1; i >= 0; --i)
+        {
+            double sum = v[i];
+            for (int j = i + 1; j < m; ++j)
+                sum -= lu[static_cast<size_t>(j) * m + i] * v[j];
+            v[i] = sum;
+        }
+
+        std::vector<double> out(m);
+        for (int i = 0; i < m; ++i)
+            out[perm[i]] = v[i];
+        v.swap(out);
+    }
+
+    std::vector<double> ComputeDuals(bool zeroCost) const
+    {
+        std::vector<double> y(numRows, 0.0);
+        if (!zeroCost)
+        {
+            for (int pos = 0; pos < numRows; ++pos)
+                y[pos] = MaxCost(basis[pos]);
+            Btran(y);
+        }
+        return y;
+    }
+
+    void Pivot(int leavingPos, int enteringCol, const std::vector<double> &alpha, int phase)
+    {
+        double theta = xB[leavingPos] / alpha[leavingPos];
+        degenerateCount = std::abs(theta) <= FEAS_TOL ? degenerateCount + 1 : 0;
+        if (cycleDetector.Pivot(basis[leavingPos], enteringCol))
+            cyclesDetected++;
+
+        for (int i = 0; i < numRows; ++i)
+        {
+            if (i != leavingPos)
+                xB[i] -= theta * alpha[i];
+        }
+        xB[leavingPos] = theta;
+
+        EtaColumn eta;
+        eta.pivotPos = leavingPos;
+        eta.pivotValue = alpha[leavingPos];
+        for (int i = 0; i < numRows; ++i)
+        {
+            if (i != leavingPos && alpha[i] != 0.0)
+            {
+                eta.index.push_back(i);
+                eta.value.push_back(alpha[i]);
+            }
+        }
+        etas.push_back(std::move(eta));
+
+        basisPos[basis[leavingPos]] = -1;
+        basis[leavingPos] = enteringCol;
+        basisPos[enteringCol] = leavingPos;
+
+        pivotCols.push_back(enteringCol);
+        pivotRows.push_back(leavingPos + 1);
+        phases.push_back(phase);
+        iterationCount++;
+
+        if (isConsoleOutput)
+        {
+            std::cout << "revised simplex " << (phase == 0 ? "dual" : "primal") << " pivot col " << enteringCol + 1
+                      << " row " << leavingPos + 2 << std::endl;
+        }
+
+        if (static_cast<int>(etas.size()) >= refactorFrequency)
+        {
+            Factorize();
+        }
+    }
+
+    bool IsDualFeasible() const
+    {
+        auto y = ComputeDuals(false);
+        for (int j = 0; j < numCols; ++j)
+        {
+            if (basisPos[j] == -1 && MaxCost(j) - DotColumn(j, y) > OPT_TOL)
+                return false;
+        }
+        return true;
+    }
+
+    bool IsPrimalFeasible() const
+    {
+        return std::all_of(xB.begin(), xB.end(), [](double v)
+                           { return v >= -FEAS_TOL; });
+    }
+
+    bool IterationLimitReached()
+    {
+        if (iterationCount >= iterationLimit)
+        {
+            status = RevisedSimplexStatus::IterationLimit;
+            return true;
+        }
+        return false;
+    }
+
+    // dual simplex iterations; with zeroCost every basis is dual feasible so this doubles as a phase 1
+    bool DualPhase(bool zeroCost)
+    {
+        std::vector<double> rho(numRows);
+        std::vector<double> alpha(numRows);
+
+        while (!IterationLimitReached())
+        {
+            int leavingPos = -1;
+            double mostNegative = -FEAS_TOL;
+            for (int i = 0; i < numRows; ++i)
+            {
+                if (xB[i] < mostNegative)
+                {
+                    mostNegative = xB[i];
+                    leavingPos = i;
+                }
+            }
+            if (leavingPos == -1)
+                return true;
+
+            std::fill(rho.begin(), rho.end(), 0.0);
+            rho[leavingPos] = 1.0;
+            Btran(rho);
+            auto y = ComputeDuals(zeroCost);
+
+            int enteringCol = -1;
+            double bestRatio = std::numeric_limits<double>::infinity();
+            double bestAlpha = 0.0;
+            for (int j = 0; j < numCols; ++j)
+            {
+                if (basisPos[j] != -1)
+                    continue;
+                double alphaR = DotColumn(j, rho);
+                if (alphaR >= -PIVOT_TOL)
+                    continue;
+                double d = zeroCost ? 0.0 : std::min(0.0, MaxCost(j) - DotColumn(j, y));
+                double ratio = d / alphaR;
+                if (ratio < bestRatio - OPT_TOL || (ratio <= bestRatio + OPT_TOL && std::abs(alphaR) > bestAlpha))
+                {
+                    bestRatio = ratio;
+                    bestAlpha = std::abs(alphaR);
+                    enteringCol = j;
+                }
+            }
+
+            if (enteringCol == -1)
+            {
+                status = RevisedSimplexStatus::Infeasible;
+                return false;
+            }
+
+            ScatterColumn(enteringCol, alpha);
+            Ftran(alpha);
+            Pivot(leavingPos, enteringCol, alpha, 0);
+        }
+        return false;
+    }
+
+    bool PrimalPhase()
+    {
+        std::vector<double> alpha(numRows);
+
+        while (!IterationLimitReached())
+        {
+            bool useBland = cyclesDetected > 0 || degenerateCount > DEGENERATE_LIMIT;
+            auto y = ComputeDuals(false);
+
+            int enteringCol = -1;
+            double bestD = OPT_TOL;
+            for (int j = 0; j < numCols; ++j)
+            {
+                if (basisPos[j] != -1)
+                    continue;
+                double d = MaxCost(j) - DotColumn(j, y);
+                if (d > bestD)
+                {
+                    bestD = d;
+                    enteringCol = j;
+                    if (useBland)
+                        break;
+                }
+            }
+            if (enteringCol == -1)
+                return true;
+
+            ScatterColumn(enteringCol, alpha);
+            Ftran(alpha);
+
+            int leavingPos = -1;
+            double bestRatio = std::numeric_limits<double>::infinity();
+            for (int i = 0; i < numRows; ++i)
+            {
+                if (alpha[i] <= PIVOT_TOL)
+                    continue;
+                double ratio = std::max(0.0, xB[i]) / alpha[i];
+                bool better = ratio < bestRatio - FEAS_TOL;
+                bool tie = !better && ratio <= bestRatio + FEAS_TOL;
+                if (better || (tie && (useBland ? basis[i] < basis[leavingPos] : alpha[i] > alpha[leavingPos])))
+                {
+                    bestRatio = ratio;
+                    leavingPos = i;
+                }
+            }
+
+            if (leavingPos == -1)
+            {
+                status = RevisedSimplexStatus::Unbounded;
+                return false;
+            }
+
+            Pivot(leavingPos, enteringCol, alpha, 1);
+        }
+        return false;
+    }
+
+    void Run()
+    {
+        basisPos.assign(numCols, -1);
+        for (int pos = 0; pos < numRows; ++pos)
+            basisPos[basis[pos]] = pos;
+
+        pivotCols.clear();
+        pivotRows.clear();
+        phases.clear();
+        iterationCount = 0;
+        refactorCount = 0;
+        degenerateCount = 0;
+        cycleDetector.Reset(basis);
+        cyclesDetected = 0;
+        status = RevisedSimplexStatus::Optimal;
+        iterationLimit = maxIterations > 0 ? maxIterations : 50 * (numRows + numCols) + 1000;
+
+        Factorize();
+
+        if (!IsPrimalFeasible())
+        {
+            // a dual feasible start goes straight to optimality, otherwise reach feasibility with zero costs first
+            if (!DualPhase(!IsDualFeasible()))
+                return;
+        }
+        PrimalPhase();
+    }
+
+    std::vector<double> CurrentSolution() const
+    {
+        std::vector<double> x(numCols, 0.0);
+        for (int pos = 0; pos < numRows; ++pos)
+            x[basis[pos]] = xB[pos];
+        return x;
+    }
+
+    Tableau BuildFinalTableau() const
+    {
+        Tableau tab(numRows + 1, numCols + 1, 0.0);
+        std::vector<double> cB(numRows);
+        for (int pos = 0; pos < numRows; ++pos)
+            cB[pos] = cost[basis[pos]];
+
+        // B^-1 is formed once, column by column, so each nonbasic column costs its nonzeros times m
+        // instead of a full Ftran; the model columns are sparse and far outnumber the rows
+        std::vector<double> inverse(static_cast<size_t>(numRows) * numRows);
+        std::vector<double> unit(numRows);
+        for (int k = 0; k < numRows; ++k)
+        {
+            std::fill(unit.begin(), unit.end(), 0.0);
+            unit[k] = 1.0;
+            Ftran(unit);
+            std::copy(unit.begin(), unit.end(), inverse.begin() + static_cast<size_t>(k) * numRows);
+        }
+
+        std::vector<double> alpha(numRows);
+        for (int j = 0; j < numCols; ++j)
+        {
+            if (basisPos[j] != -1)
+            {
+                tab(basisPos[j] + 1, j) = 1.0;
+                continue;
+            }
+            std::fill(alpha.begin(), alpha.end(), 0.0);
+            for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+            {
+                const double *inverseCol = &inverse[static_cast<size_t>(rowIndex[k]) * numRows];
+                for (int i = 0; i < numRows; ++i)
+                    alpha[i] += values[k] * inverseCol[i];
+            }
+            double zj = 0.0;
+            for (int i = 0; i < numRows; ++i)
+            {
+                tab(i + 1, j) = alpha[i];
+                zj += cB[i] * alpha[i];
+            }
+            tab(0, j) = zj - cost[j];
+        }
+
+        double objective = objOffset;
+        for (int pos = 0; pos < numRows; ++pos)
+        {
+            tab.Rhs(pos + 1) = xB[pos];
+            objective += cB[pos] * xB[pos];
+        }
+        tab.Rhs(0) = objective;
+        tab.CleanNegativeZeros();
+        return tab;
+    }
+
+    // sparse model with a +1 slack column per row and the slack basis
+    void LoadModel(const SparseLPModel &model, bool isMin)
+    {
+        this->isMin = isMin;
+        numRows = model.numRows;
+        lenObj = model.numCols;
+        numCols = lenObj + numRows;
+        objOffset = 0.0;
+
+        // >= rows are negated so every row gets a +1 slack column
+        std::vector<double> rowSign(numRows, 1.0);
+        int excessCount = 0;
+        rhs.assign(numRows, 0.0);
+        for (int i = 0; i < numRows; ++i)
+        {
+            if (model.IsGreaterEqual(i))
+            {
+                rowSign[i] = -1.0;
+                excessCount++;
+            }
+            rhs[i] = rowSign[i] * model.rhs[i];
+        }
+
+        colStart.assign(1, 0);
+        rowIndex.clear();
+        values.clear();
+        rowIndex.reserve(model.NumNonZeros() + numRows);
+        values.reserve(model.NumNonZeros() + numRows);
+        for (int j = 0; j < lenObj; ++j)
+        {
+            for (int k = model.ColBegin(j); k < model.ColEnd(j); ++k)
+            {
+                rowIndex.push_back(model.rowIndex[k]);
+                values.push_back(rowSign[model.rowIndex[k]] * model.values[k]);
+            }
+            colStart.push_back(static_cast<int>(rowIndex.size()));
+        }
+        for (int i = 0; i < numRows; ++i)
+            AddColumn({{i, 1.0}});
+
+        cost.assign(numCols, 0.0);
+        std::copy(model.objective.begin(), model.objective.end(), cost.begin());
+
+        headerRow.clear();
+        for (int j = 0; j < lenObj; ++j)
+            headerRow.push_back("x" + std::to_string(j + 1));
+        int imCtr = 1;
+        for (int i = 0; i < excessCount; ++i)
+            headerRow.push_back("e" + std::to_string(imCtr++));
+        for (int i = 0; i < numRows - excessCount; ++i)
+            headerRow.push_back("s" + std::to_string(imCtr++));
+        headerRow.push_back("rhs");
+
+        basis.resize(numRows);
+        for (int i = 0; i < numRows; ++i)
+            basis[i] = lenObj + i;
+    }
+
+    // false (slack basis kept) unless startBasis is one distinct column per row and factors
+    bool SetStartBasis(const std::vector<int> &startBasis)
+    {
+        std::vector<bool> seen(numCols, false);
+        if (static_cast<int>(startBasis.size()) != numRows)
+            return false;
+        for (int j : startBasis)
+        {
+            if (j < 0 || j >= numCols || seen[j])
+                return false;
+            seen[j] = true;
+        }
+
+        std::vector<int> slackBasis = basis;
+        basis = startBasis;
+        try
+        {
+            Factorize();
+        }
+        catch (const std::runtime_error &)
+        {
+            basis = slackBasis;
+            return false;
+        }
+        return true;
+    }
+
+    // expects basis factored; tiny values an interior point leaves on its nonbasic columns are snapped to zero
+    void PrimalPush(std::vector<double> point)
+    {
+        basisPos.assign(numCols, -1);
+        for (int pos = 0; pos < numRows; ++pos)
+            basisPos[basis[pos]] = pos;
+
+        double scale = 1.0;
+        for (double &v : point)
+        {
+            v = std::max(v, 0.0);
+            scale = std::max(scale, v);
+        }
+        for (int j = 0; j < numCols; ++j)
+        {
+            if (basisPos[j] == -1 && point[j] <= PUSH_TOL * scale)
+                point[j] = 0.0;
+        }
+
+        // basic values that keep the rows satisfied with the nonbasic values as given
+        std::vector<double> residual = rhs;
+        for (int j = 0; j < numCols; ++j)
+        {
+            if (basisPos[j] != -1 || point[j] == 0.0)
+                continue;
+            for (int k = colStart[j]; k < colStart[j + 1]; ++k)
+                residual[rowIndex[k]] -= values[k] * point[j];
+        }
+        Ftran(residual);
+        for (int pos = 0; pos < numRows; ++pos)
+            point[basis[pos]] = residual[pos];
+
+        std::vector<double> alpha(numRows);
+        for (int j = 0; j < numCols; ++j)
+        {
+            if (basisPos[j] != -1 || point[j] == 0.0)
+                continue;
+
+            ScatterColumn(j, alpha);
+            Ftran(alpha);
+            double d = MaxCost(j);
+            for (int pos = 0; pos < numRows; ++pos)
+                d -= MaxCost(basis[pos]) * alpha[pos];
+
+            // moving x_j by dir * t moves basic value pos by -dir * t * alpha[pos]
+            for (double dir : {d > OPT_TOL ? 1.0 : -1.0, -1.0})
+            {
+                double step = dir < 0.0 ? point[j] : std::numeric_limits<double>::infinity();
+                int blockPos = -1;
+                for (int pos = 0; pos < numRows; ++pos)
+                {
+                    double rate = dir * alpha[pos];
+                    if (rate <= PIVOT_TOL)
+                        continue;
+                    double limit = std::max(0.0, point[basis[pos]]) / rate;
+                    if (limit < step)
+                    {
+                        step = limit;
+                        blockPos = pos;
+                    }
+                }
+                if (std::isinf(step))
+                    continue;
+
+                for (int pos = 0; pos < numRows; ++pos)
+                    point[basis[pos]] -= dir * step * alpha[pos];
+                point[j] += dir * step;
+
+                if (blockPos == -1)
+                {
+                    point[j] = 0.0;
+                }
+                else
+                {
+                    point[basis[blockPos]] = 0.0;
+                    Pivot(blockPos, j, alpha, 1);
+                }
+                break;
+            }
+        }
+    }
+
+public:
+    struct RevisedSimplexResult
+    {
+        std::vector<std::vector<std::vector<double>>> tableaus;
+        std::vector<double> changingVars;
+        double optimalSolution;
+        std::vector<int> pivotCols;
+        std::vector<int> pivotRows;
+        std::vector<std::string> headerRow;
+    };
+
+    RevisedSimplex(bool isConsoleOutput = false) : isConsoleOutput(isConsoleOutput) {}
+
+    void SetRefactorFrequency(int frequency) { refactorFrequency = std::max(1, frequency); }
+    // 0 picks a limit from the problem size
+    void SetMaxIterations(int iterations) { maxIterations = iterations; }
+
+    RevisedSimplexStatus GetStatus() const { return status; }
+    int GetIterationCount() const { return iterationCount; }
+    int GetRefactorCount() const { return refactorCount; }
+    int GetCyclesDetected() const { return cyclesDetected; }
+    const std::vector<int> &GetPhases() const { return phases; }
+    const std::vector<int> &GetBasis() const { return basis; }
+
+    // same dense input as DualSimplex: each constraint row is coefficients, rhs, sign (1 is >=)
+    RevisedSimplexResult DoRevisedSimplex(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
+    {
+        return DoRevisedSimplex(SparseLPModel::FromDense(objFunc, constraints), isMin);
+    }
+
+    RevisedSimplexResult DoRevisedSimplex(const SparseLPModel &model, bool isMin)
+    {
+        LoadModel(model, isMin);
+        Run();
+        return BuildResult();
+    }
+
+    // warm start from the basic column of each row: j for a model column, lenObj + i for the slack of
+    // row i. A list that is not one distinct column per row, or that does not factor, uses the slack basis
+    RevisedSimplexResult DoRevisedSimplex(const SparseLPModel &model, bool isMin, const std::vector<int> &startBasis)
+    {
+        LoadModel(model, isMin);
+        SetStartBasis(startBasis);
+        Run();
+        return BuildResult();
+    }
+
+    // crossover from a point that satisfies the rows, e.g. an interior-point solution, with one value per
+    // column in the numbering above. Each nonbasic column with a nonzero value is pushed to zero, or into
+    // the basis where a basic value reaches zero first, in the direction that does not worsen the objective,
+    // so the simplex starts from a vertex at least as good as the point. Push pivots are not reported
+    RevisedSimplexResult DoRevisedSimplex(const SparseLPModel &model, bool isMin, const std::vector<int> &startBasis, const std::vector<double> &startPoint)
+    {
+        LoadModel(model, isMin);
+        if (SetStartBasis(startBasis) && static_cast<int>(startPoint.size()) == numCols)
+            PrimalPush(startPoint);
+        Run();
+        return BuildResult();
+    }
+
+    // warm start from a tableau in DualSimplex layout; every constraint row needs a unit column
+    RevisedSimplexResult DoRevisedSimplex(const Tableau &startTab, bool isMin)
+    {
+        if (!CanStartFrom(startTab))
+        {
+            throw std::invalid_argument("Tableau has no identifiable starting basis.");
+        }
+
+        this->isMin = isMin;
+        numRows = static_cast<int>(startTab.Rows()) - 1;
+        numCols = static_cast<int>(startTab.Cols()) - 1;
+        lenObj = numCols;
+        objOffset = startTab.Rhs(0);
+
+        colStart.assign(1, 0);
+        rowIndex.clear();
+        values.clear();
+        rhs.assign(numRows, 0.0);
+        cost.assign(numCols, 0.0);
+
+        std::vector<std::pair<int, double>> entries;
+        for (int j = 0; j < numCols; ++j)
+        {
+            entries.clear();
+            for (int i = 0; i < numRows; ++i)
+                entries.push_back({i, startTab(i + 1, j)});
+            AddColumn(entries);
+            cost[j] = -startTab(0, j);
+        }
+        for (int i = 0; i < numRows; ++i)
+            rhs[i] = startTab.Rhs(i + 1);
+
+        basis = FindUnitBasis(startTab);
+        headerRow.clear();
+
+        Run();
+        return BuildResult();
+    }
+
+    static std::vector<int> FindUnitBasis(const Tableau &tab)
+    {
+        int m = static_cast<int>(tab.Rows()) - 1;
+        std::vector<int> unitBasis(std::max(m, 0), -1);
+        for (int j = 0; j + 1 < static_cast<int>(tab.Cols()); ++j)
+        {
+            int oneRow = -1;
+            bool isUnit = true;
+            for (int i = 1; i <= m && isUnit; ++i)
+            {
+                double v = tab(i, j);
+                if (std::abs(v - 1.0) <= 1e-9 && oneRow == -1)
+                    oneRow = i - 1;
+                else if (std::abs(v) > 1e-9)
+                    isUnit = false;
+            }
+            if (isUnit && oneRow != -1 && unitBasis[oneRow] == -1)
+                unitBasis[oneRow] = j;
+        }
+        return unitBasis;
+    }
+
+    static bool CanStartFrom(const Tableau &tab)
+    {
+        if (tab.Rows() < 2 || tab.Cols() < 2)
+            return false;
+        auto unitBasis = FindUnitBasis(tab);
+        return std::none_of(unitBasis.begin(), unitBasis.end(), [](int j)
+                            { return j == -1; });
+    }
+
+private:
+    RevisedSimplexResult BuildResult()
+    {
+        Factorize();
+        Tableau finalTab = BuildFinalTableau();
+
+        RevisedSimplexResult res;
+        res.tableaus.push_back(finalTab.ToVectors());
+        res.pivotCols = pivotCols;
+        res.pivotRows = pivotRows;
+        res.headerRow = headerRow;
+
+        // an unbounded or capped run stops at a basis that is not optimal, so its objective is no answer
+        if (status != RevisedSimplexStatus::Optimal)
+        {
+            res.optimalSolution = std::numeric_limits<double>::quiet_NaN();
+            return res;
+        }
+
+        auto x = CurrentSolution();
+        res.changingVars.assign(x.begin(), x.begin() + std::min(lenObj, numCols));
+        res.optimalSolution = finalTab.Rhs(0);
+        return res;
+    }
+};
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+#include "lp_model.hpp"
+
+// Row and column factors for the scaled matrix R A C, so x = C x' and y = R y'. Geometric-mean
+// passes shrink the spread of every row and column, then one equilibration pass brings the largest
+// entry of each to one. Factors are powers of two, which keeps scaling and unscaling exact.
+class LPScaling
+{
+private:
+    struct Entry
+    {
+        int row;
+        int col;
+        double value;
+    };
+
+    int maxGeometricPasses;
+    std::vector<double> rowScale;
+    std::vector<double> colScale;
+
+    static double PowerOfTwo(double factor)
+    {
+        if (!std::isfinite(factor) || factor <= 0.0)
+            return 1.0;
+        return std::exp2(std::round(std::log2(factor)));
+    }
+
+    double Spread(const std::vector<Entry> &entries) const
+    {
+        double lo = std::numeric_limits<double>::infinity(), hi = 0.0;
+        for (const auto &e : entries)
+        {
+            double v = std::abs(e.value) * rowScale[e.row] * colScale[e.col];
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        return entries.empty() ? 1.0 : hi / lo;
+    }
+
+    // one geometric-mean (or, with equilibrate, max-norm) pass over either the rows or the columns
+    void ScalePass(const std::vector<Entry> &entries, bool rows, bool equilibrate)
+    {
+        std::vector<double> &scale = rows ? rowScale : colScale;
+        std::vector<double> lo(scale.size(), std::numeric_limits<double>::infinity());
+        std::vector<double> hi(scale.size(), 0.0);
+        for (const auto &e : entries)
+        {
+            int k = rows ? e.row : e.col;
+            double v = std::abs(e.value) * rowScale[e.row] * colScale[e.col];
+            lo[k] = std::min(lo[k], v);
+            hi[k] = std::max(hi[k], v);
+        }
+        for (std::size_t k = 0; k < scale.size(); ++k)
+        {
+            if (hi[k] == 0.0)
+                continue;
+            scale[k] *= equilibrate ? 1.0 / hi[k] : 1.0 / std::sqrt(lo[k] * hi[k]);
+        }
+    }
+
+    void Compute(const std::vector<Entry> &entries, int numRows, int numCols, bool scaleRows, bool scaleCols)
+    {
+        rowScale.assign(numRows, 1.0);
+        colScale.assign(numCols, 1.0);
+
+        // stop once a pass no longer shrinks the spread by a tenth
+        double spread = Spread(entries);
+        for (int pass = 0; pass < maxGeometricPasses; ++pass)
+        {
+            auto prevRow = rowScale;
+            auto prevCol = colScale;
+            if (scaleRows)
+                ScalePass(entries, true, false);
+            if (scaleCols)
+                ScalePass(entries, false, false);
+
+            double next = Spread(entries);
+            if (next > 0.9 * spread)
+            {
+                if (next > spread)
+                {
+                    rowScale = prevRow;
+                    colScale = prevCol;
+                }
+                break;
+            }
+            spread = next;
+        }
+
+        if (scaleRows)
+            ScalePass(entries, true, true);
+        if (scaleCols)
+            ScalePass(entries, false, true);
+
+        for (double &s : rowScale)
+            s = PowerOfTwo(s);
+        for (double &s : colScale)
+            s = PowerOfTwo(s);
+    }
+
+public:
+    explicit LPScaling(int maxGeometricPasses = 8) : maxGeometricPasses(maxGeometricPasses) {}
+
+    void Compute(const SparseLPModel &model, bool scaleRows = true, bool scaleCols = true)
+    {
+        std::vector<Entry> entries;
+        entries.reserve(model.NumNonZeros());
+        for (int j = 0; j < model.numCols; ++j)
+        {
+            for (int k = model.ColBegin(j); k < model.ColEnd(j); ++k)
+                entries.push_back({model.rowIndex[k], j, model.values[k]});
+        }
+        Compute(entries, model.numRows, model.numCols, scaleRows, scaleCols);
+    }
+
+    // dense rows are coefficients, rhs, sign; several blocks (e.g. goals and hard constraints) share the columns
+    void Compute(const std::vector<const std::vector<std::vector<double>> *> &blocks, int numCols, bool scaleRows = true, bool scaleCols = true)
+    {
+        std::vector<Entry> entries;
+        int numRows = 0;
+        for (const auto *block : blocks)
+        {
+            for (const auto &row : *block)
+            {
+                for (int j = 0; j < numCols && j + 2 < static_cast<int>(row.size()); ++j)
+                {
+                    if (row[j] != 0.0)
+                        entries.push_back({numRows, j, row[j]});
+                }
+                numRows++;
+            }
+        }
+        Compute(entries, numRows, numCols, scaleRows, scaleCols);
+    }
+
+    SparseLPModel ScaleModel(const SparseLPModel &model) const
+    {
+        SparseLPModel scaled = model;
+        for (int j = 0; j < model.numCols; ++j)
+        {
+            scaled.objective[j] *= colScale[j];
+            for (int k = model.ColBegin(j); k < model.ColEnd(j); ++k)
+                scaled.values[k] *= rowScale[model.rowIndex[k]] * colScale[j];
+        }
+        for (int i = 0; i < model.numRows; ++i)
+            scaled.rhs[i] *= rowScale[i];
+        return scaled;
+    }
+
+    // firstRow is where the block starts in the row numbering given to Compute
+    std::vector<std::vector<double>> ScaleRows(const std::vector<std::vector<double>> &rows, int firstRow = 0) const
+    {
+        auto scaled = rows;
+        for (std::size_t i = 0; i < scaled.size(); ++i)
+        {
+            double r = rowScale[firstRow + i];
+            auto &row = scaled[i];
+            for (std::size_t j = 0; j + 1 < row.size(); ++j)
+            {
+                double c = j + 2 < row.size() && j < colScale.size() ? colScale[j] : 1.0;
+                row[j] *= r * c;
+            }
+        }
+        return scaled;
+    }
+
+    std::vector<double> ScaleObjective(const std::vector<double> &objective) const
+    {
+        auto scaled = objective;
+        for (std::size_t j = 0; j < scaled.size() && j < colScale.size(); ++j)
+            scaled[j] *= colScale[j];
+        return scaled;
+    }
+
+    // bounds on x become bounds on x' = x / colScale
+    std::vector<double> ScaleBounds(const std::vector<double> &bounds) const
+    {
+        auto scaled = bounds;
+        for (std::size_t j = 0; j < scaled.size() && j < colScale.size(); ++j)
+            scaled[j] /= colScale[j];
+        return scaled;
+    }
+
+    std::vector<double> UnscaleSolution(const std::vector<double> &x) const
+    {
+        auto unscaled = x;
+        for (std::size_t j = 0; j < unscaled.size() && j < colScale.size(); ++j)
+            unscaled[j] *= colScale[j];
+        return unscaled;
+    }
+
+    std::vector<double> UnscaleDuals(const std::vector<double> &y) const
+    {
+        auto unscaled = y;
+        for (std::size_t i = 0; i < unscaled.size() && i < rowScale.size(); ++i)
+            unscaled[i] *= rowScale[i];
+        return unscaled;
+    }
+
+    const std::vector<double> &GetRowScale() const { return rowScale; }
+    const std::vector<double> &GetColScale() const { return colScale; }
+};
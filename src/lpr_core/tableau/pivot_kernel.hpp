@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && !defined(__EMSCRIPTEN__)
+#define LPR_PIVOT_KERNEL_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define LPR_PIVOT_KERNEL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Strict computes every row as a multiply followed by a subtract, so results match the plain scalar
+// loop bit for bit. Fast skips rows whose factor is zero and uses fused multiply-subtract where the
+// CPU has it.
+enum class PivotKernelMode
+{
+    Strict,
+    Fast
+};
+
+// Rank-1 row update dst[j] = src[j] - factor * pivot[j] shared by every tableau engine. The SIMD
+// variant is picked once at runtime from what the CPU supports.
+class PivotKernel
+{
+public:
+    using RowUpdateFn = void (*)(double *, const double *, const double *, double, std::size_t);
+
+    // dst may alias src but not pivot
+    static void RowUpdate(double *dst, const double *src, const double *pivot, double factor, std::size_t n, PivotKernelMode mode = PivotKernelMode::Strict)
+    {
+        if (mode == PivotKernelMode::Fast)
+        {
+            if (factor == 0.0)
+            {
+                if (dst != src)
+                    std::copy(src, src + n, dst);
+                return;
+            }
+            FastFn()(dst, src, pivot, factor, n);
+            return;
+        }
+        StrictFn()(dst, src, pivot, factor, n);
+    }
+
+    // float and long double take the plain loop the compiler can vectorize; exact scalars also skip
+    // zero entries since each of their operations allocates. factor is a copy because dst may hold it
+    template <typename Scalar>
+    static void RowUpdate(Scalar *dst, const Scalar *src, const Scalar *pivot, Scalar factor, std::size_t n, PivotKernelMode mode = PivotKernelMode::Strict)
+    {
+        if (factor == Scalar(0) && (mode == PivotKernelMode::Fast || !std::is_floating_point_v<Scalar>))
+        {
+            if (dst != src)
+                std::copy(src, src + n, dst);
+            return;
+        }
+        for (std::size_t j = 0; j < n; j++)
+        {
+            if constexpr (std::is_floating_point_v<Scalar>)
+            {
+                dst[j] = src[j] - (factor * pivot[j]);
+            }
+            else if (pivot[j] != Scalar(0))
+            {
+                dst[j] = src[j] - factor * pivot[j];
+            }
+            else if (dst != src)
+            {
+                dst[j] = src[j];
+            }
+        }
+    }
+
+    static const char *ActiveIsa(PivotKernelMode mode)
+    {
+        RowUpdateFn fn = mode == PivotKernelMode::Fast ? FastFn() : StrictFn();
+#if defined(LPR_PIVOT_KERNEL_X86)
+        if (fn == &RowUpdateAvx512Fma)
+            return "avx512f";
+        if (fn == &RowUpdateAvx2Fma)
+            return "avx2+fma";
+        if (fn == &RowUpdateAvx2)
+            return "avx2";
+#elif defined(LPR_PIVOT_KERNEL_NEON)
+        if (fn == &RowUpdateNeonFma)
+            return "neon";
+#endif
+        (void)fn;
+        return "scalar";
+    }
+
+private:
+    static void RowUpdateScalar(double *dst, const double *src, const double *pivot, double factor, std::size_t n)
+    {
+        for (std::size_t j = 0; j < n; j++)
+        {
+            dst[j] = src[j] - (factor * pivot[j]);
+        }
+    }
+
+#if defined(LPR_PIVOT_KERNEL_X86)
+    // no fma in the target list so the compiler cannot contract the multiply and subtract
+    __attribute__((target("avx2"))) static void RowUpdateAvx2(double *dst, const double *src, const double *pivot, double factor, std::size_t n)
+    {
+        const __m256d f = _mm256_set1_pd(factor);
+        std::size_t j = 0;
+        for (; j + 4 <= n; j += 4)
+        {
+            __m256d prod = _mm256_mul_pd(f, _mm256_loadu_pd(pivot + j));
+            _mm256_storeu_pd(dst + j, _mm256_sub_pd(_mm256_loadu_pd(src + j), prod));
+        }
+        for (; j < n; j++)
+        {
+            dst[j] = src[j] - (factor * pivot[j]);
+        }
+    }
+
+    __attribute__((target("avx2,fma"))) static void RowUpdateAvx2Fma(double *dst, const double *src, const double *pivot, double factor, std::size_t n)
+    {
+        const __m256d f = _mm256_set1_pd(factor);
+        std::size_t j = 0;
+        for (; j + 4 <= n; j += 4)
+        {
+            _mm256_storeu_pd(dst + j, _mm256_fnmadd_pd(f, _mm256_loadu_pd(pivot + j), _mm256_loadu_pd(src + j)));
+        }
+        for (; j < n; j++)
+        {
+            dst[j] = src[j] - (factor * pivot[j]);
+        }
+    }
+
+    __attribute__((target("avx512f"))) static void RowUpdateAvx512Fma(double *dst, const double *src, const double *pivot, double factor, std::size_t n)
+    {
+        const __m512d f = _mm512_set1_pd(factor);
+        std::size_t j = 0;
+        for (; j + 8 <= n; j += 8)
+        {
+            _mm512_storeu_pd(dst + j, _mm512_fnmadd_pd(f, _mm512_loadu_pd(pivot + j), _mm512_loadu_pd(src + j)));
+        }
+        if (j < n)
+        {
+            __mmask8 mask = static_cast<__mmask8>((1u << (n - j)) - 1u);
+            __m512d res = _mm512_fnmadd_pd(f, _mm512_maskz_loadu_pd(mask, pivot + j), _mm512_maskz_loadu_pd(mask, src + j));
+            _mm512_mask_storeu_pd(dst + j, mask, res);
+        }
+    }
+#elif defined(LPR_PIVOT_KERNEL_NEON)
+    static void RowUpdateNeonFma(double *dst, const double *src, const double *pivot, double factor, std::size_t n)
+    {
+        const float64x2_t f = vdupq_n_f64(factor);
+        std::size_t j = 0;
+        for (; j + 2 <= n; j += 2)
+        {
+            vst1q_f64(dst + j, vfmsq_f64(vld1q_f64(src + j), f, vld1q_f64(pivot + j)));
+        }
+        for (; j < n; j++)
+        {
+            dst[j] = src[j] - (factor * pivot[j]);
+        }
+    }
+#endif
+
+    static RowUpdateFn StrictFn()
+    {
+        static const RowUpdateFn fn = []() -> RowUpdateFn
+        {
+#if defined(LPR_PIVOT_KERNEL_X86)
+            if (__builtin_cpu_supports("avx2"))
+                return &RowUpdateAvx2;
+#endif
+            // without a contraction-free vector path the plain loop is the reference result
+            return &RowUpdateScalar;
+        }();
+        return fn;
+    }
+
+    static RowUpdateFn FastFn()
+    {
+        static const RowUpdateFn fn = []() -> RowUpdateFn
+        {
+#if defined(LPR_PIVOT_KERNEL_X86)
+            if (__builtin_cpu_supports("avx512f"))
+                return &RowUpdateAvx512Fma;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return &RowUpdateAvx2Fma;
+            if (__builtin_cpu_supports("avx2"))
+                return &RowUpdateAvx2;
+#elif defined(LPR_PIVOT_KERNEL_NEON)
+            return &RowUpdateNeonFma;
+#endif
+            return &RowUpdateScalar;
+        }();
+        return fn;
+    }
+};
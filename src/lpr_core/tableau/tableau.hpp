@@ -0,0 +1,202 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+#include "scalar_traits.hpp"
+
+// Dense simplex tableau stored as one contiguous row-major buffer.
+// Rows are Stride() scalars apart so columns can be inserted before the rhs
+// without reallocating every row. Inputs and ToVectors snapshots stay double.
+template <typename Scalar>
+class BasicTableau
+{
+public:
+    template <typename T>
+    class ColumnView
+    {
+    private:
+        T *base = nullptr;
+        std::size_t stride = 0;
+        std::size_t count = 0;
+
+    public:
+        ColumnView() = default;
+        ColumnView(T *base, std::size_t stride, std::size_t count) : base(base), stride(stride), count(count) {}
+
+        T &operator[](std::size_t i) const { return base[i * stride]; }
+        std::size_t size() const { return count; }
+
+        std::vector<std::remove_const_t<T>> ToVector() const
+        {
+            std::vector<std::remove_const_t<T>> out(count);
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = base[i * stride];
+            return out;
+        }
+    };
+
+private:
+    std::size_t numRows = 0;
+    std::size_t numCols = 0;
+    std::size_t rowStride = 0;
+    std::vector<Scalar> buffer;
+
+    void Regrow(std::size_t newStride)
+    {
+        std::vector<Scalar> grown(numRows * newStride, Scalar(0));
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            std::copy(buffer.begin() + i * rowStride, buffer.begin() + i * rowStride + numCols, grown.begin() + i * newStride);
+        }
+        buffer.swap(grown);
+        rowStride = newStride;
+    }
+
+public:
+    using ScalarType = Scalar;
+
+    BasicTableau() = default;
+
+    BasicTableau(std::size_t rows, std::size_t cols, Scalar value = Scalar(0), std::size_t spareCols = 0)
+        : numRows(rows), numCols(cols), rowStride(cols + spareCols), buffer(rows * (cols + spareCols), value)
+    {
+    }
+
+    explicit BasicTableau(const std::vector<std::vector<double>> &rows, std::size_t spareCols = 0)
+    {
+        Assign(rows, spareCols);
+    }
+
+    void Assign(const std::vector<std::vector<double>> &rows, std::size_t spareCols = 0)
+    {
+        numRows = rows.size();
+        numCols = rows.empty() ? 0 : rows[0].size();
+        rowStride = numCols + spareCols;
+        buffer.assign(numRows * rowStride, Scalar(0));
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            std::transform(rows[i].begin(), rows[i].begin() + std::min(rows[i].size(), numCols), buffer.begin() + i * rowStride,
+                           [](double val)
+                           { return ScalarTraits<Scalar>::FromDouble(val); });
+        }
+    }
+
+    // copies shape and values while reusing this tableau's buffer when it is large enough
+    void CopyFrom(const BasicTableau &other)
+    {
+        numRows = other.numRows;
+        numCols = other.numCols;
+        rowStride = other.rowStride;
+        buffer.resize(other.buffer.size());
+        std::copy(other.buffer.begin(), other.buffer.end(), buffer.begin());
+    }
+
+    std::size_t Rows() const { return numRows; }
+    std::size_t Cols() const { return numCols; }
+    std::size_t Stride() const { return rowStride; }
+    bool Empty() const { return numRows == 0 || numCols == 0; }
+
+    Scalar *Data() { return buffer.data(); }
+    const Scalar *Data() const { return buffer.data(); }
+
+    Scalar &operator()(std::size_t i, std::size_t j) { return buffer[i * rowStride + j]; }
+    const Scalar &operator()(std::size_t i, std::size_t j) const { return buffer[i * rowStride + j]; }
+
+    Scalar &Rhs(std::size_t i) { return buffer[i * rowStride + numCols - 1]; }
+    const Scalar &Rhs(std::size_t i) const { return buffer[i * rowStride + numCols - 1]; }
+
+    std::span<Scalar> Row(std::size_t i) { return {buffer.data() + i * rowStride, numCols}; }
+    std::span<const Scalar> Row(std::size_t i) const { return {buffer.data() + i * rowStride, numCols}; }
+
+    ColumnView<Scalar> Col(std::size_t j) { return {buffer.data() + j, rowStride, numRows}; }
+    ColumnView<const Scalar> Col(std::size_t j) const { return {buffer.data() + j, rowStride, numRows}; }
+
+    // inserts a column directly before the rhs column
+    void InsertColumnBeforeRhs(Scalar value = Scalar(0))
+    {
+        if (numCols + 1 > rowStride)
+        {
+            Regrow(std::max(numCols + 1, rowStride * 2));
+        }
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            Scalar *row = buffer.data() + i * rowStride;
+            row[numCols] = row[numCols - 1];
+            row[numCols - 1] = value;
+        }
+        numCols++;
+    }
+
+    void AppendRow(std::span<const Scalar> values)
+    {
+        buffer.resize((numRows + 1) * rowStride, Scalar(0));
+        Scalar *row = buffer.data() + numRows * rowStride;
+        std::fill(row, row + rowStride, Scalar(0));
+        std::copy(values.begin(), values.begin() + std::min(values.size(), numCols), row);
+        numRows++;
+    }
+
+    void PopRow()
+    {
+        if (numRows == 0)
+            return;
+        numRows--;
+        buffer.resize(numRows * rowStride);
+    }
+
+    // replaces -0.0 with 0.0 the way the solvers do after each pivot; exact scalars have no signed zero
+    void CleanNegativeZeros()
+    {
+        if constexpr (std::is_floating_point_v<Scalar>)
+        {
+            for (std::size_t i = 0; i < numRows; ++i)
+            {
+                for (Scalar &val : Row(i))
+                {
+                    if (val == -0.0)
+                        val = 0.0;
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<double>> ToVectors() const
+    {
+        std::vector<std::vector<double>> out(numRows);
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            auto row = Row(i);
+            if constexpr (std::is_same_v<Scalar, double>)
+            {
+                out[i].assign(row.begin(), row.end());
+            }
+            else
+            {
+                out[i].resize(row.size());
+                std::transform(row.begin(), row.end(), out[i].begin(), [](const Scalar &val)
+                               { return ScalarTraits<Scalar>::ToDouble(val); });
+            }
+        }
+        return out;
+    }
+
+    bool operator==(const BasicTableau &other) const
+    {
+        if (numRows != other.numRows || numCols != other.numCols)
+            return false;
+        for (std::size_t i = 0; i < numRows; ++i)
+        {
+            auto a = Row(i);
+            auto b = other.Row(i);
+            if (!std::equal(a.begin(), a.end(), b.begin()))
+                return false;
+        }
+        return true;
+    }
+};
+
+using Tableau = BasicTableau<double>;
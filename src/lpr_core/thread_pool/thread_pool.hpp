@@ -0,0 +1,294 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Persistent work-stealing pool. Every worker owns a deque it pushes and pops at the back while idle
+// threads steal from the front; tasks submitted from outside the pool go to one extra shared deque.
+// ParallelFor and ForEach block until their work is done and the calling thread runs queued tasks
+// while it waits, so nested calls cannot starve the pool. The web build has no threads and runs
+// everything on the caller.
+class ThreadPool
+{
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::mutex sleepMutex;
+    std::condition_variable taskAvailable;
+    std::atomic<std::size_t> queued{0};
+    bool stopping = false;
+
+    inline static thread_local ThreadPool *currentPool = nullptr;
+    inline static thread_local std::size_t currentIndex = 0;
+
+    // the worker's own deque, or the shared one for threads outside the pool
+    std::size_t HomeQueue() const { return currentPool == this ? currentIndex : queues.size() - 1; }
+
+    bool TakeTask(std::function<void()> &task)
+    {
+        std::size_t home = HomeQueue();
+        bool isWorker = currentPool == this;
+        for (std::size_t k = 0; k < queues.size(); ++k)
+        {
+            std::size_t index = (home + k) % queues.size();
+            WorkQueue &queue = *queues[index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+            if (isWorker && index == home)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+            queued--;
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(std::size_t index)
+    {
+        currentPool = this;
+        currentIndex = index;
+        while (true)
+        {
+            std::function<void()> task;
+            if (TakeTask(task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            taskAvailable.wait(lock, [this]
+                               { return stopping || queued > 0; });
+            if (stopping && queued == 0)
+                return;
+        }
+    }
+
+    bool RunPendingTask()
+    {
+        std::function<void()> task;
+        if (!TakeTask(task))
+            return false;
+        task();
+        return true;
+    }
+
+public:
+    // threadCount counts the caller, so a pool of n starts n - 1 workers
+    explicit ThreadPool(std::size_t threadCount = std::thread::hardware_concurrency())
+    {
+#ifndef __EMSCRIPTEN__
+        std::size_t workerCount = threadCount > 1 ? threadCount - 1 : 0;
+#else
+        (void)threadCount;
+        std::size_t workerCount = 0;
+#endif
+        for (std::size_t i = 0; i <= workerCount; ++i)
+            queues.push_back(std::make_unique<WorkQueue>());
+
+        workers.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            workers.emplace_back([this, i]
+                                 { WorkerLoop(i); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        taskAvailable.notify_all();
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t Size() const { return workers.size() + 1; }
+
+    // a worker submitting keeps the task on its own deque, where it runs next unless it is stolen first
+    void Submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            queued++;
+        }
+        {
+            WorkQueue &queue = *queues[HomeQueue()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        taskAvailable.notify_one();
+    }
+
+    // splits [begin, end) into at most Size() chunks of at least minChunk and calls body(chunkBegin, chunkEnd)
+    void ParallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t, std::size_t)> &body, std::size_t minChunk = 1)
+    {
+        if (end <= begin)
+            return;
+
+        std::size_t count = end - begin;
+        std::size_t chunks = std::min(Size(), std::max<std::size_t>(1, count / std::max<std::size_t>(1, minChunk)));
+        if (chunks <= 1)
+        {
+            body(begin, end);
+            return;
+        }
+
+        // remaining is only touched under doneMutex so the caller cannot return while a worker still holds it
+        std::size_t remaining = chunks - 1;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::mutex doneMutex;
+        std::condition_variable done;
+
+        auto runChunk = [&](std::size_t chunk)
+        {
+            std::size_t chunkBegin = begin + count * chunk / chunks;
+            std::size_t chunkEnd = begin + count * (chunk + 1) / chunks;
+            try
+            {
+                body(chunkBegin, chunkEnd);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            Submit([&, chunk]
+                   {
+                       runChunk(chunk);
+                       std::lock_guard<std::mutex> lock(doneMutex);
+                       if (--remaining == 0)
+                           done.notify_all(); });
+        }
+
+        runChunk(0);
+
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (remaining == 0)
+                    break;
+            }
+            if (!RunPendingTask())
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                done.wait(lock, [&]
+                          { return remaining == 0; });
+                break;
+            }
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // calls body(i) for every i in [begin, end). Ranges are halved onto the local deque down to grain items,
+    // so idle threads steal the large halves and uneven items still balance
+    void ForEach(std::size_t begin, std::size_t end, const std::function<void(std::size_t)> &body, std::size_t grain = 1)
+    {
+        if (end <= begin)
+            return;
+        grain = std::max<std::size_t>(1, grain);
+
+        std::size_t outstanding = 0;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::mutex doneMutex;
+        std::condition_variable done;
+
+        std::function<void(std::size_t, std::size_t)> run = [&](std::size_t lo, std::size_t hi)
+        {
+            while (hi - lo > grain && Size() > 1)
+            {
+                std::size_t mid = lo + (hi - lo) / 2;
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    outstanding++;
+                }
+                Submit([&, mid, hi]
+                       {
+                           run(mid, hi);
+                           std::lock_guard<std::mutex> lock(doneMutex);
+                           if (--outstanding == 0)
+                               done.notify_all(); });
+                hi = mid;
+            }
+            try
+            {
+                for (std::size_t i = lo; i < hi; ++i)
+                    body(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        };
+
+        run(begin, end);
+
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                if (outstanding == 0)
+                    break;
+            }
+            if (!RunPendingTask())
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                done.wait(lock, [&]
+                          { return outstanding == 0; });
+                break;
+            }
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // process wide pool sized to the machine, created on first use
+    static ThreadPool &Shared()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+};
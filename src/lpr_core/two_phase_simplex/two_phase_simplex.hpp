@@ -7,12 +7,51 @@
 #include <cmath>
 #include <limits>
 #include <iomanip>
-
-class TwoPhaseSimplex
+#include <span>
+#include <type_traits>
+
+#include "tableau.hpp"
+#include "scalar_traits.hpp"
+#include "pivot_kernel.hpp"
+#include "thread_pool.hpp"
+#include "lp_model.hpp"
+#include "presolve.hpp"
+#include "lp_scaling.hpp"
+
+// entering column rule for phase 2. Dantzig scans the whole z row for the most improving entry,
+// Bland takes the lowest improving index, Partial scans a rotating window of columns and stops at the
+// first window with an improving entry, Multiple keeps the best few columns of a full scan and picks
+// among them until none still improves
+enum class PrimalPricingRule
+{
+    Dantzig,
+    Bland,
+    Partial,
+    Multiple
+};
+
+// Scalar is what both phases pivot the tableau in, as for BasicDualSimplex; inputs, the returned
+// tableaus and the result stay double
+template <typename Scalar>
+class BasicTwoPhaseSimplex
 {
 private:
+    using TableauType = BasicTableau<Scalar>;
+    using Traits = ScalarTraits<Scalar>;
+
     bool isConsoleOutput;
     bool useBlandsRule; // New flag to control Bland's rule usage
+    PivotKernelMode pivotKernelMode = PivotKernelMode::Strict;
+    bool parallelPivot = false;
+    std::size_t parallelPivotMinRows = 256;
+    bool presolveEnabled = false;
+    PresolveStats presolveStats;
+    bool scalingEnabled = false;
+    PrimalPricingRule primalPricing = PrimalPricingRule::Dantzig;
+    int pricingWindow = 0;
+    int pricingCandidates = 4;
+    int pricingStart = 0;
+    std::vector<int> candidateCols;
     int testInputSelected;
 
     std::vector<int> IMPivotCols;
@@ -58,7 +97,7 @@ private:
     LPRResult result;
 
 public:
-    TwoPhaseSimplex(bool consoleOutput = false, bool blandsRule = false)
+    BasicTwoPhaseSimplex(bool consoleOutput = false, bool blandsRule = false)
         : isConsoleOutput(consoleOutput), useBlandsRule(blandsRule)
     {
         testInputSelected = -1;
@@ -361,21 +400,31 @@ public:
         bool valid;
     };
 
-    PivotResult DoPivotOperationsPhase1(const std::vector<std::vector<double>> &tab)
+    struct TableauPivotResult
+    {
+        TableauType tableau;
+        bool isOptimal;
+        bool valid;
+    };
+
+    TableauPivotResult DoPivotOperationsPhase1(const TableauType &tab)
     {
-        PivotResult result;
+        const Scalar eps = Traits::PivotTolerance();
+        TableauPivotResult result;
         result.valid = false;
         result.isOptimal = false;
 
+        auto wRow = tab.Row(0);
+
         // Choose pivot column based on Bland's rule flag
         int pivotCol = -1;
 
         if (useBlandsRule)
         {
             // Bland's rule: Choose smallest index among positive elements
-            for (int i = 0; i < tab[0].size() - 1; i++)
+            for (int i = 0; i < static_cast<int>(wRow.size()) - 1; i++)
             {
-                if (tab[0][i] > 1e-12)
+                if (wRow[i] > eps)
                 {
                     pivotCol = i;
                     break;
@@ -385,12 +434,12 @@ public:
         else
         {
             // Standard rule: Choose largest positive element
-            double largestW = -1;
-            for (int i = 0; i < tab[0].size() - 1; i++)
+            Scalar largestW = -1;
+            for (int i = 0; i < static_cast<int>(wRow.size()) - 1; i++)
             {
-                if (tab[0][i] > largestW)
+                if (wRow[i] > largestW)
                 {
-                    largestW = tab[0][i];
+                    largestW = wRow[i];
                     pivotCol = i;
                 }
             }
@@ -403,53 +452,48 @@ public:
             return result;
         }
 
-        std::vector<double> thetas;
-        for (int i = 2; i < tab.size(); i++)
+        std::vector<Scalar> thetas;
+        for (int i = 2; i < static_cast<int>(tab.Rows()); i++)
         {
-            if (tab[i][pivotCol] <= 1e-12)
+            if (tab(i, pivotCol) <= eps)
             { // Use epsilon for numerical stability
-                thetas.push_back(std::numeric_limits<double>::infinity());
+                thetas.push_back(Traits::Infinity());
             }
             else
             {
-                thetas.push_back(tab[i].back() / tab[i][pivotCol]);
+                thetas.push_back(tab.Rhs(i) / tab(i, pivotCol));
             }
         }
 
         // Find minimum positive theta
-        double theta = std::numeric_limits<double>::infinity();
-        for (double x : thetas)
+        Scalar theta = Traits::Infinity();
+        for (const Scalar &x : thetas)
         {
-            if (x > 1e-12 && x != std::numeric_limits<double>::infinity())
+            if (x > eps && x != Traits::Infinity())
             {
                 theta = std::min(theta, x);
             }
         }
 
+        // no row bounds the step, so there is nothing to pivot on
+        if (theta == Traits::Infinity())
+        {
+            return result;
+        }
+
         // Apply pivot row selection (always use smallest index for ties, regardless of Bland's rule flag)
         int pivotRow = -1;
-        for (int i = 0; i < thetas.size(); i++)
+        for (int i = 0; i < static_cast<int>(thetas.size()); i++)
         {
-            if (std::abs(thetas[i] - theta) < 1e-12)
+            if (thetas[i] == theta || Traits::Abs(thetas[i] - theta) < eps)
             {
                 pivotRow = i + 2;
                 break;
             }
         }
 
-        std::vector<std::vector<double>> newTab = tab;
-
-        // Initialize newTab with zeros
-        for (int i = 0; i < newTab.size(); i++)
-        {
-            for (int j = 0; j < newTab[i].size(); j++)
-            {
-                newTab[i][j] = 0;
-            }
-        }
-
         // The div row
-        double divNum = tab[pivotRow][pivotCol];
+        Scalar divNum = tab(pivotRow, pivotCol);
 
         if (divNum == 0)
         {
@@ -460,34 +504,35 @@ public:
             return result;
         }
 
-        for (int j = 0; j < tab[pivotRow].size(); j++)
+        TableauType newTab(tab.Rows(), tab.Cols());
+
+        auto divRow = newTab.Row(pivotRow);
+        auto oldDivRow = tab.Row(pivotRow);
+        for (size_t j = 0; j < divRow.size(); j++)
         {
-            newTab[pivotRow][j] = tab[pivotRow][j] / divNum;
+            divRow[j] = oldDivRow[j] / divNum;
         }
 
         // Apply pivot formula
-        for (int i = 0; i < tab.size(); i++)
+        for (int i = 0; i < static_cast<int>(tab.Rows()); i++)
         {
-            for (int j = 0; j < tab[i].size(); j++)
-            {
-                if (i != pivotRow)
-                {
-                    newTab[i][j] = tab[i][j] - (tab[i][pivotCol] * newTab[pivotRow][j]);
-                }
-            }
+            if (i == pivotRow)
+                continue;
+            auto row = newTab.Row(i);
+            PivotKernel::RowUpdate(row.data(), tab.Row(i).data(), divRow.data(), tab(i, pivotCol), row.size(), pivotKernelMode);
         }
 
         // Clean up near-zero values
-        for (int i = 0; i < newTab[0].size(); i++)
+        for (Scalar &val : newTab.Row(0))
         {
-            if (std::abs(newTab[0][i]) < 1e-12)
+            if (Traits::Abs(val) < eps)
             {
-                newTab[0][i] = 0.0;
+                val = 0;
             }
         }
 
         bool isAllNegW = true;
-        for (double num : newTab[0])
+        for (const Scalar &num : newTab.Row(0))
         {
             if (num > 0)
             {
@@ -505,196 +550,210 @@ public:
         IMPivotCols.push_back(pivotCol);
         IMPivotRows.push_back(pivotRow);
 
-        result.tableau = newTab;
+        result.tableau = std::move(newTab);
         result.isOptimal = isAllNegW;
         result.valid = true;
 
         return result;
     }
 
-#include <vector>
-#include <algorithm>
-#include <limits>
-#include <cmath>
-#include <iostream>
+    PivotResult DoPivotOperationsPhase1(const std::vector<std::vector<double>> &tab)
+    {
+        auto pivot = DoPivotOperationsPhase1(TableauType(tab));
+        return {pivot.tableau.ToVectors(), pivot.isOptimal, pivot.valid};
+    }
 
-    std::pair<std::vector<std::vector<double>>, bool> DoPivotOperationsPhase2(const std::vector<std::vector<double>> &tab, bool isMin)
+private:
+    // how much entering column j improves the objective per unit; positive means it improves
+    static Scalar Improvement(const Scalar &zCoefficient, bool isMin)
     {
+        return isMin ? zCoefficient : -zCoefficient;
+    }
 
-        double largestZ;
-        if (isMin)
-        {
-            // Get all elements except the last one from row 1
-            std::vector<double> row1_subset(tab[1].begin(), tab[1].end() - 1);
-            largestZ = *std::max_element(row1_subset.begin(), row1_subset.end());
-        }
-        else
+    int PriceDantzig(std::span<const Scalar> zCoefficients, bool isMin)
+    {
+        // first index of the largest entry for min and the smallest for max, in one pass
+        int pivotCol = zCoefficients.empty() ? -1 : 0;
+        for (int i = 1; i < static_cast<int>(zCoefficients.size()); i++)
         {
-            std::vector<double> row1_subset(tab[1].begin(), tab[1].end() - 1);
-            largestZ = *std::min_element(row1_subset.begin(), row1_subset.end());
+            if (Improvement(zCoefficients[i], isMin) > Improvement(zCoefficients[pivotCol], isMin))
+                pivotCol = i;
         }
+        return pivotCol;
+    }
 
-        // Find pivot column (index of largestZ in the subset)
-        int pivotCol = -1;
-        for (int i = 0; i < tab[1].size() - 1; i++)
+    int PriceBland(std::span<const Scalar> zCoefficients, bool isMin)
+    {
+        for (int i = 0; i < static_cast<int>(zCoefficients.size()); i++)
         {
-            if (tab[1][i] == largestZ)
-            {
-                pivotCol = i;
-                break;
-            }
+            if (Improvement(zCoefficients[i], isMin) > Traits::PivotTolerance())
+                return i;
         }
+        return -1;
+    }
 
-        // Calculate thetas
-        std::vector<double> thetas;
-        for (int i = 2; i < tab.size(); i++)
+    int PricePartial(std::span<const Scalar> zCoefficients, bool isMin)
+    {
+        int n = static_cast<int>(zCoefficients.size());
+        if (n == 0)
+            return -1;
+        int window = pricingWindow > 0 ? pricingWindow : std::max(1, static_cast<int>(std::ceil(std::sqrt(n))));
+        int begin = pricingStart % n;
+
+        // the windows wrap around the row, so a full lap without an improving entry means none exists
+        for (int scanned = 0; scanned < n; scanned += window)
         {
-            if (tab[i][pivotCol] == 0)
+            int pivotCol = -1;
+            Scalar best = Traits::PivotTolerance();
+            for (int k = 0; k < window && scanned + k < n; k++)
             {
-                thetas.push_back(std::numeric_limits<double>::infinity());
+                int i = (begin + k) % n;
+                if (Improvement(zCoefficients[i], isMin) > best)
+                {
+                    best = Improvement(zCoefficients[i], isMin);
+                    pivotCol = i;
+                }
             }
-            else
+            begin = (begin + window) % n;
+            if (pivotCol != -1)
             {
-                thetas.push_back(tab[i].back() / tab[i][pivotCol]);
-            }
-        }
-
-        // Check if all thetas are negative
-        bool allNegativeThetas = true;
-        for (double theta : thetas)
-        {
-            if (theta >= 0)
-            {
-                allNegativeThetas = false;
-                break;
+                pricingStart = begin;
+                return pivotCol;
             }
         }
+        return -1;
+    }
 
-        if (allNegativeThetas)
-        {
-            return std::make_pair(std::vector<std::vector<double>>(), false);
-        }
+    int PriceMultiple(std::span<const Scalar> zCoefficients, bool isMin)
+    {
+        // the pivots keep the candidates' z entries current, so a minor iteration only reads those
+        std::erase_if(candidateCols, [&](int i)
+                      { return Improvement(zCoefficients[i], isMin) <= Traits::PivotTolerance(); });
 
-        // Handle very small values (close to zero)
-        for (int i = 0; i < thetas.size(); i++)
+        if (candidateCols.empty())
         {
-            if (std::abs(thetas[i]) < 1e-12)
+            for (int i = 0; i < static_cast<int>(zCoefficients.size()); i++)
             {
-                thetas[i] = 0.0;
+                if (Improvement(zCoefficients[i], isMin) > Traits::PivotTolerance())
+                    candidateCols.push_back(i);
             }
+            auto better = [&](int a, int b)
+            {
+                return Improvement(zCoefficients[a], isMin) > Improvement(zCoefficients[b], isMin);
+            };
+            std::size_t keep = std::min(candidateCols.size(), static_cast<std::size_t>(std::max(1, pricingCandidates)));
+            std::partial_sort(candidateCols.begin(), candidateCols.begin() + keep, candidateCols.end(), better);
+            candidateCols.resize(keep);
         }
 
-        // Check if any positive thetas exist (excluding 0 and inf)
-        bool hasPositiveTheta = false;
-        for (double theta : thetas)
+        int pivotCol = -1;
+        for (int i : candidateCols)
         {
-            if (theta > 0 && !std::isinf(theta))
-            {
-                hasPositiveTheta = true;
-                break;
-            }
+            if (pivotCol == -1 || Improvement(zCoefficients[i], isMin) > Improvement(zCoefficients[pivotCol], isMin))
+                pivotCol = i;
         }
+        return pivotCol;
+    }
 
-        double theta;
-        if (!hasPositiveTheta)
+public:
+    std::pair<TableauType, bool> DoPivotOperationsPhase2(const TableauType &tab, bool isMin)
+    {
+        auto zRow = tab.Row(1);
+        auto zCoefficients = zRow.first(zRow.size() - 1);
+
+        int pivotCol;
+        switch (primalPricing)
         {
-            // Check if 0 is in thetas
-            bool hasZero = std::find(thetas.begin(), thetas.end(), 0.0) != thetas.end();
-            if (hasZero)
-            {
-                theta = 0.0;
-            }
-            else
-            {
-                return std::make_pair(std::vector<std::vector<double>>(), false);
-            }
+        case PrimalPricingRule::Bland:
+            pivotCol = PriceBland(zCoefficients, isMin);
+            break;
+        case PrimalPricingRule::Partial:
+            pivotCol = PricePartial(zCoefficients, isMin);
+            break;
+        case PrimalPricingRule::Multiple:
+            pivotCol = PriceMultiple(zCoefficients, isMin);
+            break;
+        default:
+            pivotCol = PriceDantzig(zCoefficients, isMin);
+            break;
         }
-        else
+        if (pivotCol == -1)
         {
-            // Find minimum positive theta (excluding inf)
-            theta = std::numeric_limits<double>::infinity();
-            for (double x : thetas)
-            {
-                if (x > 0 && !std::isinf(x) && x < theta)
-                {
-                    theta = x;
-                }
-            }
+            return std::make_pair(TableauType(), false);
         }
 
-        // Find pivot row
+        // only rows with a positive entry bound the step, whatever rule chose the column; the first row with
+        // the smallest ratio leaves, and a row already at zero is a degenerate pivot taken like any other
         int pivotRow = -1;
-        for (int i = 0; i < thetas.size(); i++)
+        Scalar theta = Traits::Infinity();
+        for (int i = 2; i < static_cast<int>(tab.Rows()); i++)
         {
-            if (thetas[i] == theta)
+            Scalar entry = tab(i, pivotCol);
+            if (entry <= Traits::PivotTolerance())
+                continue;
+            Scalar ratio = tab.Rhs(i) > 0 ? tab.Rhs(i) / entry : Scalar(0);
+            if (pivotRow == -1 || ratio < theta)
             {
+                theta = ratio;
                 pivotRow = i;
-                break;
             }
         }
-        pivotRow += 2; // Adjust for the offset
 
-        // Create newTab (deep copy initialized with zeros)
-        std::vector<std::vector<double>> newTab(tab.size());
-        for (int i = 0; i < tab.size(); i++)
+        if (pivotRow == -1)
         {
-            newTab[i].resize(tab[i].size(), 0.0);
+            return std::make_pair(TableauType(), false);
         }
 
         // Division row operation
-        double divNum = tab[pivotRow][pivotCol];
+        Scalar divNum = tab(pivotRow, pivotCol);
         if (divNum == 0)
         {
             if (isConsoleOutput)
             {
                 std::cout << "Divide by 0 error" << std::endl;
             }
-            return std::make_pair(std::vector<std::vector<double>>(), false);
+            return std::make_pair(TableauType(), false);
         }
 
+        TableauType newTab(tab.Rows(), tab.Cols());
+
         // Divide the pivot row
-        for (int j = 0; j < tab[pivotRow].size(); j++)
+        auto divRow = newTab.Row(pivotRow);
+        auto oldDivRow = tab.Row(pivotRow);
+        for (size_t j = 0; j < divRow.size(); j++)
         {
-            newTab[pivotRow][j] = tab[pivotRow][j] / divNum;
+            divRow[j] = oldDivRow[j] / divNum;
         }
 
         // Apply the pivot formula to all other rows
-        for (int i = 0; i < tab.size(); i++)
+        auto updateRows = [&](std::size_t begin, std::size_t end)
         {
-            for (int j = 0; j < tab[i].size(); j++)
+            for (std::size_t i = begin; i < end; i++)
             {
-                if (i != pivotRow)
-                {
-                    newTab[i][j] = tab[i][j] - (tab[i][pivotCol] * newTab[pivotRow][j]);
-                }
+                if (static_cast<int>(i) == pivotRow)
+                    continue;
+                auto row = newTab.Row(i);
+                PivotKernel::RowUpdate(row.data(), tab.Row(i).data(), divRow.data(), tab(i, pivotCol), row.size(), pivotKernelMode);
             }
-        }
+        };
+
+        if (parallelPivot && tab.Rows() >= parallelPivotMinRows)
+            ThreadPool::Shared().ParallelFor(0, tab.Rows(), updateRows, 16);
+        else
+            updateRows(0, tab.Rows());
 
         // Check termination condition
+        auto newZ = newTab.Row(1).first(newTab.Cols() - 1);
         bool isAllNegZ;
         if (isMin)
         {
-            isAllNegZ = true;
-            for (int i = 0; i < newTab[1].size() - 1; i++)
-            {
-                if (newTab[1][i] > 0)
-                {
-                    isAllNegZ = false;
-                    break;
-                }
-            }
+            isAllNegZ = std::all_of(newZ.begin(), newZ.end(), [](const Scalar &num)
+                                    { return !(num > 0); });
         }
         else
         {
-            isAllNegZ = true;
-            for (int i = 0; i < newTab[1].size() - 1; i++)
-            {
-                if (newTab[1][i] < 0)
-                {
-                    isAllNegZ = false;
-                    break;
-                }
-            }
+            isAllNegZ = std::all_of(newZ.begin(), newZ.end(), [](const Scalar &num)
+                                    { return !(num < 0); });
         }
 
         if (isConsoleOutput)
@@ -707,38 +766,86 @@ public:
         IMPivotCols.push_back(pivotCol);
         IMPivotRows.push_back(pivotRow);
 
-        return std::make_pair(newTab, isAllNegZ);
+        return std::make_pair(std::move(newTab), isAllNegZ);
+    }
+
+    std::pair<std::vector<std::vector<double>>, bool> DoPivotOperationsPhase2(const std::vector<std::vector<double>> &tab, bool isMin)
+    {
+        auto [newTab, isAllNegZ] = DoPivotOperationsPhase2(TableauType(tab), isMin);
+        return std::make_pair(newTab.ToVectors(), isAllNegZ);
     }
 
     std::vector<std::vector<std::vector<double>>> DoTwoPhase(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
+    {
+        if (!presolveEnabled)
+        {
+            return RunScaled(objFunc, constraints, isMin);
+        }
+
+        // infeasible, unbounded and fully reduced models are solved as given so the tableaus stay meaningful
+        Presolve presolve;
+        auto reduced = presolve.DoPresolve(SparseLPModel::FromDense(objFunc, constraints), isMin);
+        presolveStats = reduced.stats;
+        if (reduced.status != PresolveStatus::Reduced || reduced.model.numRows == 0 || reduced.model.numCols == 0)
+        {
+            return RunScaled(objFunc, constraints, isMin);
+        }
+
+        auto tabs = RunScaled(reduced.model.objective, reduced.model.ToDense(), isMin);
+        auto post = presolve.DoPostsolve(result.changingVars, result.optimalSolution);
+        result.changingVars = post.changingVars;
+        result.optimalSolution = post.optimalSolution;
+        return tabs;
+    }
+
+    std::vector<std::vector<std::vector<double>>> RunScaled(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
+    {
+        if (!scalingEnabled)
+        {
+            return RunTwoPhase(objFunc, constraints, isMin);
+        }
+
+        LPScaling scaling;
+        scaling.Compute({&constraints}, static_cast<int>(objFunc.size()));
+        auto tabs = RunTwoPhase(scaling.ScaleObjective(objFunc), scaling.ScaleRows(constraints), isMin);
+        result.changingVars = scaling.UnscaleSolution(result.changingVars);
+        return tabs;
+    }
+
+    std::vector<std::vector<std::vector<double>>> RunTwoPhase(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin)
     {
         std::vector<std::vector<std::vector<double>>> tabs;
         bool isAllNegW = false;
         std::vector<int> aCols;
+        pricingStart = 0;
+        candidateCols.clear();
 
         // Formulate first tableau
         auto [tab, cols] = formulateFirstTab1(objFunc, constraints);
         aCols = cols;
+        TableauType current(tab);
         tabs.push_back(tab);
 
         // Check if all elements in first row are non-positive
-        isAllNegW = tabs.back()[0].empty() ? false : std::all_of(tabs.back()[0].begin(), tabs.back()[0].end(), [](double num)
-                                                                 { return num <= 0; });
+        auto wRow = current.Row(0);
+        isAllNegW = wRow.empty() ? false : std::all_of(wRow.begin(), wRow.end(), [](const Scalar &num)
+                                                        { return num <= 0; });
 
         int phase1Ctr = 0;
         while (!isAllNegW)
         {
-            auto [newTab, newIsAllNegW, pivotValid] = DoPivotOperationsPhase1(tabs.back());
+            auto [newTab, newIsAllNegW, pivotValid] = DoPivotOperationsPhase1(current);
             if (!pivotValid)
             {
                 break;
             }
-            if (!newTab.size() && newIsAllNegW == false)
+            if (newTab.Empty() && newIsAllNegW == false)
             {
                 break;
             }
 
-            tabs.push_back(newTab);
+            current = std::move(newTab);
+            tabs.push_back(current.ToVectors());
             isAllNegW = newIsAllNegW;
 
             phase1Ctr++;
@@ -752,26 +859,25 @@ public:
 
         int tabPhaseNum = phase1Ctr + 1;
 
-        // Deep copy last tableau
-        std::vector<std::vector<double>> newTab = tabs.back();
-
         // Zero out columns specified in aCols
         for (int k = 0; k < aCols.size(); k++)
         {
-            for (size_t i = 0; i < newTab.size(); i++)
+            auto aCol = current.Col(aCols[k]);
+            for (size_t i = 0; i < aCol.size(); i++)
             {
-                newTab[i][aCols[k]] = 0.0;
+                aCol[i] = 0;
             }
         }
 
-        tabs.push_back(newTab);
+        tabs.push_back(current.ToVectors());
 
         // Check objective row (second row, excluding last element)
-        bool AllPosZ = isMin ? std::all_of(tabs.back()[1].begin(), tabs.back()[1].end() - 1,
-                                           [](double num)
+        auto zRow = current.Row(1).first(current.Cols() - 1);
+        bool AllPosZ = isMin ? std::all_of(zRow.begin(), zRow.end(),
+                                           [](const Scalar &num)
                                            { return num <= 0; })
-                             : std::all_of(tabs.back()[1].begin(), tabs.back()[1].end() - 1,
-                                           [](double num)
+                             : std::all_of(zRow.begin(), zRow.end(),
+                                           [](const Scalar &num)
                                            { return num >= 0; });
 
         // Find index of duplicate tableau
@@ -790,15 +896,16 @@ public:
 
         while (!AllPosZ)
         {
-            prevZ = tabs.back()[1].back();
-            auto [newTab, newAllPosZ] = DoPivotOperationsPhase2(tabs.back(), isMin);
+            prevZ = Traits::ToDouble(current.Rhs(1));
+            auto [newTab, newAllPosZ] = DoPivotOperationsPhase2(current, isMin);
 
-            if (!newTab.size() && newAllPosZ == false)
+            if (newTab.Empty() && newAllPosZ == false)
             {
                 break;
             }
 
-            tabs.push_back(newTab);
+            current = std::move(newTab);
+            tabs.push_back(current.ToVectors());
             AllPosZ = newAllPosZ;
             phases.push_back(1);
 
@@ -905,6 +1012,32 @@ public:
     // Setter to enable/disable Bland's rule
     void SetBlandsRule(bool enable) { useBlandsRule = enable; }
 
+    // phase 2 entering rule; SetBlandsRule still only covers phase 1. window is the Partial scan width
+    // (0 picks about sqrt of the column count), candidates the Multiple list length
+    void SetPrimalPricingRule(PrimalPricingRule rule, int window = 0, int candidates = 4)
+    {
+        primalPricing = rule;
+        pricingWindow = window;
+        pricingCandidates = candidates;
+    }
+    PrimalPricingRule GetPrimalPricingRule() const { return primalPricing; }
+
+    void SetPivotKernelMode(PivotKernelMode mode) { pivotKernelMode = mode; }
+
+    // the returned tableaus belong to the reduced model; GetResult reports the original variables
+    void SetPresolve(bool enable) { presolveEnabled = enable; }
+    const PresolveStats &GetPresolveStats() const { return presolveStats; }
+
+    // scaled solves return scaled tableaus; GetResult reports the variables unscaled
+    void SetScaling(bool enable) { scalingEnabled = enable; }
+
+    // phase 2 pivots on tableaus with fewer than minRows rows stay on the calling thread
+    void SetParallelPivot(bool enable, std::size_t minRows = 256)
+    {
+        parallelPivot = enable;
+        parallelPivotMinRows = minRows;
+    }
+
     // Getters for accessing private members
     const std::vector<int> &GetPivotCols() const { return IMPivotCols; }
     const std::vector<int> &GetPivotRows() const { return IMPivotRows; }
@@ -917,4 +1050,6 @@ public:
     {
         return result;
     }
-};
\ No newline at end of file
+};
+
+using TwoPhaseSimplex = BasicTwoPhaseSimplex<double>;
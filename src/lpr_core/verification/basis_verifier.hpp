@@ -0,0 +1,234 @@
+#pragma once
+
+#include <vector>
+#include <stdexcept>
+
+#include "lp_model.hpp"
+#include "rational.hpp"
+#include "tableau.hpp"
+#include "dual_simplex.hpp"
+
+// Optimal: the basis as given is primal and dual feasible in exact arithmetic. Repaired: it was not,
+// but a few exact pivots reached one that is. NotRepaired: the repair ran out of pivots, so the LP
+// should be solved again.
+enum class BasisVerifyStatus
+{
+    Optimal,
+    Repaired,
+    Infeasible,
+    Unbounded,
+    NotRepaired
+};
+
+// Post-solve check of a final basis. The model is refactorized onto the basis in Rational, so the
+// feasibility and optimality tests have no tolerance at all, and a basis the floating-point solve got
+// slightly wrong is fixed with exact dual or primal pivots instead of a second solve.
+class BasisVerifier
+{
+private:
+    using ExactTableau = BasicTableau<Rational>;
+
+    int maxRepairPivots = 50;
+    BasicDualSimplex<Rational> exactSolver;
+
+    static bool IsPrimalFeasible(const ExactTableau &tab)
+    {
+        for (std::size_t i = 1; i < tab.Rows(); i++)
+        {
+            if (tab.Rhs(i) < 0)
+                return false;
+        }
+        return true;
+    }
+
+    // row 0 holds -c, so a max basis is optimal with no negative entry and a min basis with no positive one
+    static bool IsImproving(const Rational &reducedCost, bool isMin)
+    {
+        return isMin ? reducedCost > 0 : reducedCost < 0;
+    }
+
+    static bool IsDualFeasible(const ExactTableau &tab, bool isMin)
+    {
+        for (std::size_t j = 0; j + 1 < tab.Cols(); j++)
+        {
+            if (IsImproving(tab(0, j), isMin))
+                return false;
+        }
+        return true;
+    }
+
+    void Pivot(ExactTableau &tab, int pivotRow, int pivotCol)
+    {
+        Rational pivot = tab(pivotRow, pivotCol);
+        for (Rational &val : tab.Row(pivotRow))
+            val /= pivot;
+        exactSolver.EliminatePivotColumn(tab, pivotRow, pivotCol);
+    }
+
+    // most negative rhs leaves, the smallest |d_j / a_rj| over a_rj < 0 enters, lowest index on ties.
+    // ignoreCosts takes the largest |a_rj| instead, to regain primal feasibility from a dual infeasible basis
+    BasisVerifyStatus DualStep(ExactTableau &tab, std::vector<int> &basicCol, bool ignoreCosts)
+    {
+        int pivotRow = -1;
+        for (int i = 1; i < static_cast<int>(tab.Rows()); i++)
+        {
+            if (tab.Rhs(i) < 0 && (pivotRow == -1 || tab.Rhs(i) < tab.Rhs(pivotRow)))
+                pivotRow = i;
+        }
+        if (pivotRow == -1)
+            return BasisVerifyStatus::Optimal;
+
+        int pivotCol = -1;
+        Rational bestRatio;
+        for (int j = 0; j + 1 < static_cast<int>(tab.Cols()); j++)
+        {
+            if (tab(pivotRow, j) >= 0)
+                continue;
+            Rational ratio = ignoreCosts ? tab(pivotRow, j) : abs(tab(0, j) / tab(pivotRow, j));
+            if (pivotCol == -1 || ratio < bestRatio)
+            {
+                bestRatio = ratio;
+                pivotCol = j;
+            }
+        }
+        if (pivotCol == -1)
+            return BasisVerifyStatus::Infeasible;
+
+        Pivot(tab, pivotRow, pivotCol);
+        basicCol[pivotRow] = pivotCol;
+        return BasisVerifyStatus::Repaired;
+    }
+
+    // Bland's rule: lowest improving column enters, the min ratio row with the lowest basic index leaves
+    BasisVerifyStatus PrimalStep(ExactTableau &tab, std::vector<int> &basicCol, bool isMin)
+    {
+        int pivotCol = -1;
+        for (int j = 0; j + 1 < static_cast<int>(tab.Cols()); j++)
+        {
+            if (IsImproving(tab(0, j), isMin))
+            {
+                pivotCol = j;
+                break;
+            }
+        }
+        if (pivotCol == -1)
+            return BasisVerifyStatus::Optimal;
+
+        int pivotRow = -1;
+        Rational bestRatio;
+        for (int i = 1; i < static_cast<int>(tab.Rows()); i++)
+        {
+            if (tab(i, pivotCol) <= 0)
+                continue;
+            Rational ratio = tab.Rhs(i) / tab(i, pivotCol);
+            if (pivotRow == -1 || ratio < bestRatio || (ratio == bestRatio && basicCol[i] < basicCol[pivotRow]))
+            {
+                bestRatio = ratio;
+                pivotRow = i;
+            }
+        }
+        if (pivotRow == -1)
+            return BasisVerifyStatus::Unbounded;
+
+        Pivot(tab, pivotRow, pivotCol);
+        basicCol[pivotRow] = pivotCol;
+        return BasisVerifyStatus::Repaired;
+    }
+
+public:
+    struct VerifyResult
+    {
+        BasisVerifyStatus status = BasisVerifyStatus::NotRepaired;
+        // feasibility of the basis as it was handed in, before any repair
+        bool primalFeasible = false;
+        bool dualFeasible = false;
+        int repairPivots = 0;
+        LPBasis basis;
+        std::vector<Rational> exactVars;
+        Rational exactObjective;
+        std::vector<double> changingVars;
+        double optimalSolution = 0.0;
+        std::vector<std::vector<double>> tableau;
+    };
+
+    void SetMaxRepairPivots(int pivots) { maxRepairPivots = pivots; }
+    int GetMaxRepairPivots() const { return maxRepairPivots; }
+
+    VerifyResult Verify(const std::vector<double> &objFunc, const std::vector<std::vector<double>> &constraints, bool isMin, const LPBasis &basis)
+    {
+        return Verify(SparseLPModel::FromDense(objFunc, constraints), isMin, basis);
+    }
+
+    // basis is usually DualSimplex::GetFinalBasis() from a solve of the same model without variable bounds
+    VerifyResult Verify(const SparseLPModel &model, bool isMin, const LPBasis &basis)
+    {
+        for (BasisStatus status : basis.colStatus)
+        {
+            if (status == BasisStatus::AtUpper)
+                throw std::invalid_argument("The basis verifier does not support variable bounds.");
+        }
+
+        // every double converts to a Rational exactly, so this is the model as the solver saw it
+        exactSolver = BasicDualSimplex<Rational>();
+        ExactTableau tab(exactSolver.DoFormulationOperation(model));
+        std::vector<int> basicCol = exactSolver.PivotOntoBasis(tab, model.numCols, basis);
+
+        VerifyResult res;
+        res.primalFeasible = IsPrimalFeasible(tab);
+        res.dualFeasible = IsDualFeasible(tab, isMin);
+
+        if (res.primalFeasible && res.dualFeasible)
+        {
+            res.status = BasisVerifyStatus::Optimal;
+        }
+        else
+        {
+            // dual pivots restore primal feasibility, keeping dual feasibility when the basis has it;
+            // primal pivots then finish the job
+            res.status = BasisVerifyStatus::NotRepaired;
+            while (true)
+            {
+                bool primalFeasible = IsPrimalFeasible(tab);
+                bool dualFeasible = IsDualFeasible(tab, isMin);
+                if (primalFeasible && dualFeasible)
+                {
+                    res.status = BasisVerifyStatus::Repaired;
+                    break;
+                }
+                if (res.repairPivots >= maxRepairPivots)
+                    break;
+                BasisVerifyStatus step = primalFeasible ? PrimalStep(tab, basicCol, isMin) : DualStep(tab, basicCol, !dualFeasible);
+                if (step != BasisVerifyStatus::Repaired)
+                {
+                    res.status = step;
+                    break;
+                }
+                res.repairPivots++;
+            }
+        }
+
+        res.basis.colStatus.assign(model.numCols, BasisStatus::AtLower);
+        res.basis.rowStatus.assign(model.numRows, BasisStatus::AtLower);
+        res.exactVars.assign(model.numCols, Rational());
+        for (int i = 1; i < static_cast<int>(basicCol.size()); i++)
+        {
+            int j = basicCol[i];
+            if (j < model.numCols)
+            {
+                res.basis.colStatus[j] = BasisStatus::Basic;
+                res.exactVars[j] = tab.Rhs(i);
+            }
+            else
+            {
+                res.basis.rowStatus[j - model.numCols] = BasisStatus::Basic;
+            }
+        }
+
+        res.exactObjective = tab.Rhs(0);
+        res.optimalSolution = res.exactObjective.ToDouble();
+        for (const Rational &val : res.exactVars)
+            res.changingVars.push_back(val.ToDouble());
+        res.tableau = tab.ToVectors();
+        return res;
+    }
+};
@@ -1,8 +1,14 @@
 #ifdef EMSCRIPTEN
 #include "web/web_bindings.hpp"
+#else
+#include "cli/cli.hpp"
 #endif
 
 int main(int argc, char *argv[])
 {
+#ifndef EMSCRIPTEN
+    return BatchCli().Run(argc, argv);
+#else
     return 0;
-}
\ No newline at end of file
+#endif
+}
@@ -0,0 +1,747 @@
+// Regression cases for solver bugs found in review. Built only with -DLPR_BUILD_TESTS=ON; each case
+// prints what it expected when it fails and the exit code is the number of failures
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "batch_solver.hpp"
+#include "cli.hpp"
+#include "branch_and_bound.hpp"
+#include "dual_simplex.hpp"
+#include "lp_reader.hpp"
+#include "mps_reader.hpp"
+#include "two_phase_simplex.hpp"
+
+static int failures = 0;
+
+static void Check(bool ok, const std::string &what)
+{
+    if (!ok)
+    {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static bool Near(double a, double b, double tol = 1e-3)
+{
+    return std::abs(a - b) <= tol;
+}
+
+// min 5x1 + x2 + 2x3 with 4x1 + 7x2 + 4x3 >= 20 and 6x1 + x2 + 8x3 >= 18, optimum 6 at (0, 2, 2).
+// The node LPs of the bound-change search used to be solved as Max
+static void MinBoundChangesBranchAndBound()
+{
+    std::vector<double> objFunc = {5, 1, 2};
+    std::vector<std::vector<double>> constraints = {{4, 7, 4, 20, 1}, {6, 1, 8, 18, 1}};
+
+    BranchAndBound bb;
+    bb.SetBranchingMode(BranchingMode::BoundChanges);
+    bb.RunBranchAndBound(objFunc, constraints, true);
+
+    const BranchAndBound::SearchResult &result = bb.GetLastResult();
+    Check(result.incumbent && Near(*result.incumbent, 6.0), "bound-change min IP objective 6");
+    Check(bb.getSolutionStr().find("Best integer solution: [0.000000, 2.000000, 2.000000]") != std::string::npos,
+          "bound-change min IP solution (0, 2, 2)");
+}
+
+// max 2x1 + 6x2 + 6x3 with 8x1 + 8x2 + 8x3 <= 26.5 and 7x1 + 2x2 + 6x3 <= 20.5, optimum 18. Columns
+// whose entries merely summed to 1 were taken as basic, which undid the fix-up of a new branch row
+static void ConstraintRowsBasicColumns()
+{
+    std::vector<double> objFunc = {2, 6, 6};
+    std::vector<std::vector<double>> constraints = {{8, 8, 8, 26.5, 0}, {7, 2, 6, 20.5, 0}};
+
+    BranchAndBound bb;
+    BranchAndBound::SearchLimits limits;
+    limits.nodeLimit = 400;
+    bb.SetLimits(limits);
+    bb.RunBranchAndBound(objFunc, constraints, false);
+
+    const BranchAndBound::SearchResult &result = bb.GetLastResult();
+    Check(result.stop == SearchStop::Completed && result.incumbent && Near(*result.incumbent, 18.0),
+          "constraint-row max IP objective 18");
+}
+
+// the same min IP under search limits. bestBound is the lowest bound left for a Min problem and the
+// gaps are measured up from it; with the member isMin unset both sides were taken as for Max
+static void MinSearchLimits()
+{
+    std::vector<double> objFunc = {5, 1, 2};
+    std::vector<std::vector<double>> constraints = {{4, 7, 4, 20, 1}, {6, 1, 8, 18, 1}};
+
+    for (BranchingMode mode : {BranchingMode::ConstraintRows, BranchingMode::BoundChanges})
+    {
+        std::string name = mode == BranchingMode::BoundChanges ? "bound-change" : "constraint-row";
+
+        BranchAndBound complete;
+        complete.SetBranchingMode(mode);
+        complete.RunBranchAndBound(objFunc, constraints, true);
+        const BranchAndBound::SearchResult &done = complete.GetLastResult();
+        Check(done.stop == SearchStop::Completed, name + " min search completes");
+        Check(done.incumbent && Near(*done.incumbent, 6.0) && Near(done.bestBound, 6.0) && Near(done.gap, 0.0),
+              name + " min search ends with incumbent and bound 6 and no gap");
+
+        BranchAndBound limited;
+        limited.SetBranchingMode(mode);
+        BranchAndBound::SearchLimits limits;
+        limits.nodeLimit = 3;
+        limited.SetLimits(limits);
+        limited.RunBranchAndBound(objFunc, constraints, true);
+        const BranchAndBound::SearchResult &cut = limited.GetLastResult();
+        Check(cut.stop == SearchStop::NodeLimit, name + " min search stops at the node limit");
+        Check(cut.bestBound <= 6.0 + 1e-3 && cut.bestBound >= 5.7692 - 1e-3,
+              name + " min best bound lies between the root LP and the optimum, got " + std::to_string(cut.bestBound));
+
+        BranchAndBound first;
+        first.SetBranchingMode(mode);
+        limits = BranchAndBound::SearchLimits();
+        limits.stopAtFirstIncumbent = true;
+        first.SetLimits(limits);
+        first.RunBranchAndBound(objFunc, constraints, true);
+        const BranchAndBound::SearchResult &early = first.GetLastResult();
+        Check(early.incumbent && *early.incumbent >= 6.0 - 1e-3 && early.bestBound <= *early.incumbent + 1e-9 &&
+                  early.gap >= 0.0,
+              name + " min first incumbent lies above its best bound");
+    }
+}
+
+// max 7x1 + 5x2 + 5x3 with 7x1 + 4x2 + 4x3 <= 16 and 6x1 + 7x2 + 7x3 <= 28, optimum 20. x2 and x3 have
+// identical columns, so both looked basic in the same row and the incumbent was costed at [0, 4, 4]
+static void IdenticalColumnsIncumbent()
+{
+    std::vector<double> objFunc = {7, 5, 5};
+    std::vector<std::vector<double>> constraints = {{7, 4, 4, 16, 0}, {6, 7, 7, 28, 0}};
+
+    for (BranchingMode mode : {BranchingMode::ConstraintRows, BranchingMode::BoundChanges})
+    {
+        std::string name = mode == BranchingMode::BoundChanges ? "bound-change" : "constraint-row";
+
+        BranchAndBound bb;
+        bb.SetBranchingMode(mode);
+        bb.RunBranchAndBound(objFunc, constraints, false);
+
+        const BranchAndBound::SearchResult &result = bb.GetLastResult();
+        Check(result.incumbent && Near(*result.incumbent, 20.0), name + " identical columns max IP objective 20");
+    }
+}
+
+// max x1 + x2 with 1000x1 <= 2999.5 and x2 <= 1, optimum 3 at (2, 1). The LP value 2.9995 is within the
+// integrality tolerance of 3, but (3, 1) breaks the first row, so the search has to branch on it
+static void IntegralitySnapFeasible()
+{
+    std::vector<double> objFunc = {1, 1};
+    std::vector<std::vector<double>> constraints = {{1000, 0, 2999.5, 0}, {0, 1, 1, 0}};
+
+    for (BranchingMode mode : {BranchingMode::ConstraintRows, BranchingMode::BoundChanges})
+    {
+        std::string name = mode == BranchingMode::BoundChanges ? "bound-change" : "constraint-row";
+
+        BranchAndBound bb;
+        bb.SetBranchingMode(mode);
+        bb.RunBranchAndBound(objFunc, constraints, false);
+
+        const BranchAndBound::SearchResult &result = bb.GetLastResult();
+        Check(result.incumbent && Near(*result.incumbent, 3.0), name + " snapped point stays feasible, objective 3");
+    }
+}
+
+// the node order changes how the tree is searched, not its answer: every rule finishes the max IP at 18
+// and the min IP at 6, in both branching modes
+static void NodeSelectionRulesAgree()
+{
+    std::vector<double> maxObj = {2, 6, 6};
+    std::vector<std::vector<double>> maxRows = {{8, 8, 8, 26.5, 0}, {7, 2, 6, 20.5, 0}};
+    std::vector<double> minObj = {5, 1, 2};
+    std::vector<std::vector<double>> minRows = {{4, 7, 4, 20, 1}, {6, 1, 8, 18, 1}};
+
+    for (NodeSelection selection : {NodeSelection::DepthFirst, NodeSelection::BestBound, NodeSelection::BestEstimate, NodeSelection::Hybrid})
+    {
+        for (BranchingMode mode : {BranchingMode::ConstraintRows, BranchingMode::BoundChanges})
+        {
+            std::string name = std::string(mode == BranchingMode::BoundChanges ? "bound-change" : "constraint-row") +
+                               " node selection " + std::to_string(static_cast<int>(selection));
+
+            BranchAndBound maxSearch;
+            maxSearch.SetBranchingMode(mode);
+            maxSearch.SetNodeSelection(selection);
+            maxSearch.RunBranchAndBound(maxObj, maxRows, false);
+            const BranchAndBound::SearchResult &maxResult = maxSearch.GetLastResult();
+            Check(maxResult.stop == SearchStop::Completed && maxResult.incumbent && Near(*maxResult.incumbent, 18.0),
+                  name + ": max IP objective 18");
+
+            BranchAndBound minSearch;
+            minSearch.SetBranchingMode(mode);
+            minSearch.SetNodeSelection(selection);
+            minSearch.RunBranchAndBound(minObj, minRows, true);
+            const BranchAndBound::SearchResult &minResult = minSearch.GetLastResult();
+            Check(minResult.stop == SearchStop::Completed && minResult.incumbent && Near(*minResult.incumbent, 6.0),
+                  name + ": min IP objective 6");
+        }
+    }
+}
+
+// the weighted pricing rules reach the optimum 6 at (1/6, 2/3), not the degenerate vertex worth 4
+static void WeightedPricingRulesOptimal()
+{
+    std::vector<double> objFunc = {4, 8};
+    std::vector<std::vector<double>> constraints = {{2, 1, 1, 0}, {4, 8, 4, 1}, {-2, 2, 1, 0}, {4, 8, 10, 0}};
+
+    for (DualPricingRule rule : {DualPricingRule::Devex, DualPricingRule::SteepestEdge})
+    {
+        DualSimplex dual;
+        dual.SetDualPricingRule(rule);
+        auto result = dual.DoDualSimplex(objFunc, constraints, false);
+
+        std::string label = rule == DualPricingRule::Devex ? "devex" : "steepest edge";
+        Check(Near(result.optimalSolution, 6.0), label + ": optimal solution is 6");
+    }
+}
+
+// optimum 10.75 with a negative objective value on the way. Row 0 holds the objective, so only the
+// constraint rows decide whether the dual loop is done and which row leaves, under every rule
+static void DualRowsSkipObjective()
+{
+    std::vector<double> objFunc = {-2, -3, 9, -2};
+    std::vector<std::vector<double>> constraints = {
+        {-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}};
+
+    for (DualPricingRule rule : {DualPricingRule::MostNegativeRhs, DualPricingRule::Devex, DualPricingRule::SteepestEdge})
+    {
+        DualSimplex dual;
+        dual.SetDualPricingRule(rule);
+        auto result = dual.DoDualSimplex(objFunc, constraints, false);
+
+        std::string label = rule == DualPricingRule::MostNegativeRhs ? "most negative rhs"
+                            : rule == DualPricingRule::Devex       ? "devex"
+                                                                   : "steepest edge";
+        Check(Near(result.optimalSolution, 10.75), label + ": optimal solution is 10.75");
+    }
+}
+
+// max 8x1 - 3x3 + 5x4 is unbounded, x1 + x2 <= 2 with x1 + x2 >= 5 is infeasible and the 10.75 case
+// needs more than one pivot. None of the three ends at an optimal basis, so none reports an objective
+static void RevisedNonOptimalStatus()
+{
+    std::vector<double> unboundedObj = {8, 0, -3, 5};
+    std::vector<std::vector<double>> unboundedRows = {
+        {3, -3, 1, -3, 9, 0}, {4, 2, 3, 4, 1, 1}, {9, -1, 7, 1, 14, 0}, {8, -3, 9, 7, 26, 1}};
+    std::vector<double> infeasibleObj = {1, 1};
+    std::vector<std::vector<double>> infeasibleRows = {{1, 1, 2, 0}, {1, 1, 5, 1}};
+    std::vector<double> cappedObj = {-2, -3, 9, -2};
+    std::vector<std::vector<double>> cappedRows = {
+        {-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}};
+
+    RevisedSimplex unbounded;
+    auto result = unbounded.DoRevisedSimplex(unboundedObj, unboundedRows, false);
+    Check(unbounded.GetStatus() == RevisedSimplexStatus::Unbounded && std::isnan(result.optimalSolution),
+          "revised: unbounded max has no objective");
+
+    RevisedSimplex infeasible;
+    result = infeasible.DoRevisedSimplex(infeasibleObj, infeasibleRows, false);
+    Check(infeasible.GetStatus() == RevisedSimplexStatus::Infeasible && std::isnan(result.optimalSolution),
+          "revised: infeasible max has no objective");
+
+    RevisedSimplex capped;
+    capped.SetMaxIterations(1);
+    result = capped.DoRevisedSimplex(cappedObj, cappedRows, false);
+    Check(capped.GetStatus() == RevisedSimplexStatus::IterationLimit && std::isnan(result.optimalSolution),
+          "revised: a run stopped by the iteration cap has no objective");
+
+    DualSimplex dual;
+    dual.SetEngine(SimplexEngine::Revised);
+    Check(std::isnan(dual.DoDualSimplex(unboundedObj, unboundedRows, false).optimalSolution),
+          "revised engine: unbounded max has no objective");
+    Check(std::isnan(dual.DoDualSimplex(infeasibleObj, infeasibleRows, false).optimalSolution),
+          "revised engine: infeasible max has no objective");
+}
+
+// the interior point engine crosses over to the revised engine, whose status is the answer: the
+// unbounded and infeasible cases above come back as such with no objective, the 10.75 case as optimal
+static void InteriorPointCrossoverStatus()
+{
+    struct Case
+    {
+        std::vector<double> objFunc;
+        std::vector<std::vector<double>> constraints;
+        RevisedSimplexStatus status;
+        std::string label;
+    };
+    std::vector<Case> cases = {
+        {{8, 0, -3, 5}, {{3, -3, 1, -3, 9, 0}, {4, 2, 3, 4, 1, 1}, {9, -1, 7, 1, 14, 0}, {8, -3, 9, 7, 26, 1}},
+         RevisedSimplexStatus::Unbounded, "unbounded"},
+        {{1, 1}, {{1, 1, 2, 0}, {1, 1, 5, 1}}, RevisedSimplexStatus::Infeasible, "infeasible"},
+        {{-2, -3, 9, -2}, {{-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}},
+         RevisedSimplexStatus::Optimal, "optimal"}};
+
+    for (const Case &lp : cases)
+    {
+        DualSimplex dual;
+        dual.SetEngine(SimplexEngine::InteriorPoint);
+        auto result = dual.DoDualSimplex(lp.objFunc, lp.constraints, false);
+
+        Check(dual.GetRevisedStatus() == lp.status, "interior point: " + lp.label + " status after crossover");
+        bool objective = lp.status == RevisedSimplexStatus::Optimal ? Near(result.optimalSolution, 10.75)
+                                                                     : std::isnan(result.optimalSolution);
+        Check(objective, "interior point: " + lp.label + " objective");
+    }
+}
+
+// the unbounded max from above on the bounded path: with the trivial bounds [0, inf) the primal phase
+// finds no bound or row to stop the entering column and reports no solution; boxing every variable in
+// [0, 10] gives 62.444, the same as adding the bounds as rows, with and without bound flipping
+static void BoundedUnboundedPrimal()
+{
+    std::vector<double> objFunc = {8, 0, -3, 5};
+    std::vector<std::vector<double>> constraints = {
+        {3, -3, 1, -3, 9, 0}, {4, 2, 3, 4, 1, 1}, {9, -1, 7, 1, 14, 0}, {8, -3, 9, 7, 26, 1}};
+    double inf = std::numeric_limits<double>::infinity();
+
+    for (bool flipping : {true, false})
+    {
+        std::string label = flipping ? "bound flipping" : "no bound flipping";
+
+        DualSimplex trivial;
+        trivial.SetBoundFlipping(flipping);
+        trivial.SetVariableBounds({0, 0, 0, 0}, {inf, inf, inf, inf});
+        Check(std::isnan(trivial.DoDualSimplex(objFunc, constraints, false).optimalSolution),
+              label + ": unbounded max under [0, inf) bounds has no objective");
+
+        DualSimplex boxed;
+        boxed.SetBoundFlipping(flipping);
+        boxed.SetVariableBounds({0, 0, 0, 0}, {10, 10, 10, 10});
+        Check(Near(boxed.DoDualSimplex(objFunc, constraints, false).optimalSolution, 62.4444),
+              label + ": max boxed in [0, 10] is 62.444");
+    }
+}
+
+// max -3x1 + x2 + 9x4 has optimum 84 and max 2x1 + 3x2 optimum 0 at the origin. The phase 2 ratio test
+// took rows with negative entries and -0 ratios, stepping past rows it should have stopped at
+static void PhaseTwoRatioTest()
+{
+    struct Case
+    {
+        std::vector<double> objFunc;
+        std::vector<std::vector<double>> constraints;
+        double optimum;
+    };
+    std::vector<Case> cases = {
+        {{-3, 1, 0, 9}, {{7, 1, -3, 1, 28, 0}, {0, 0, 1, 4, 28, 0}, {1, 1, -3, 0, 0, 0}}, 84.0},
+        {{2, 3}, {{8, -1, 19, 0}, {4, 2, 4, 0}, {6, 2, 0, 0}}, 0.0}};
+
+    for (PrimalPricingRule rule : {PrimalPricingRule::Dantzig, PrimalPricingRule::Bland, PrimalPricingRule::Partial, PrimalPricingRule::Multiple})
+    {
+        std::string label = rule == PrimalPricingRule::Dantzig ? "dantzig"
+                            : rule == PrimalPricingRule::Bland ? "bland"
+                            : rule == PrimalPricingRule::Partial ? "partial"
+                                                                 : "multiple";
+        for (std::size_t k = 0; k < cases.size(); k++)
+        {
+            TwoPhaseSimplex twoPhase;
+            twoPhase.SetPrimalPricingRule(rule);
+            twoPhase.DoTwoPhase(cases[k].objFunc, cases[k].constraints, false);
+            Check(Near(twoPhase.GetResult().optimalSolution, cases[k].optimum),
+                  label + ": two phase case " + std::to_string(k + 1) + " optimum is " + std::to_string(cases[k].optimum));
+        }
+    }
+}
+
+// presolve renumbers the columns it keeps, so the declared bounds have to follow them
+static void PresolveKeepsVariableBounds()
+{
+    std::vector<double> objFunc = {3, 9};
+    std::vector<std::vector<double>> constraints = {{3, 7, 7, 1}, {8, 9, 10, 1}, {1, 0, 1, 0}, {0, 5, 19, 1}};
+
+    for (bool presolve : {false, true})
+    {
+        DualSimplex dual;
+        dual.SetPresolve(presolve);
+        dual.SetVariableBounds({0, 0}, {2, std::numeric_limits<double>::infinity()});
+        auto result = dual.DoDualSimplex(objFunc, constraints, true);
+
+        std::string label = presolve ? "presolve on" : "presolve off";
+        Check(Near(result.optimalSolution, 34.2), label + ": bounded min is 34.2");
+    }
+}
+
+// scaling changes the tableau the pivots see but not the answer: the badly scaled max 3x1 + 2x2 and the
+// 10.75 case above give the same objective and point with scaling on and off, dense and revised
+static void ScaledMatchesUnscaled()
+{
+    struct Case
+    {
+        std::vector<double> objFunc;
+        std::vector<std::vector<double>> constraints;
+        double optimum;
+    };
+    std::vector<Case> cases = {
+        {{3, 2}, {{1000, 2000, 4000, 0}, {0.001, 0.003, 0.0045, 0}, {50, -20, 10, 1}}, 12.0},
+        {{-2, -3, 9, -2}, {{-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}}, 10.75}};
+
+    for (std::size_t k = 0; k < cases.size(); k++)
+    {
+        for (SimplexEngine engine : {SimplexEngine::Dense, SimplexEngine::Revised})
+        {
+            std::string label = std::string(engine == SimplexEngine::Dense ? "dense" : "revised") + " case " + std::to_string(k + 1);
+
+            DualSimplex plain;
+            plain.SetEngine(engine);
+            auto unscaled = plain.DoDualSimplex(cases[k].objFunc, cases[k].constraints, false);
+
+            DualSimplex scaledSolver;
+            scaledSolver.SetEngine(engine);
+            scaledSolver.SetScaling(true);
+            auto scaled = scaledSolver.DoDualSimplex(cases[k].objFunc, cases[k].constraints, false);
+
+            Check(Near(unscaled.optimalSolution, cases[k].optimum) && Near(scaled.optimalSolution, cases[k].optimum),
+                  label + ": scaled and unscaled objectives are " + std::to_string(cases[k].optimum));
+            bool samePoint = scaled.changingVars.size() == unscaled.changingVars.size();
+            for (std::size_t j = 0; samePoint && j < scaled.changingVars.size(); j++)
+                samePoint = Near(scaled.changingVars[j], unscaled.changingVars[j]);
+            Check(samePoint, label + ": scaled and unscaled solutions agree");
+        }
+    }
+}
+
+// a batch answers each LP as a lone solve would and in input order, whatever the thread count; the
+// unbounded and infeasible LPs come back as NoSolution and a tiny memory budget skips every solve
+static void BatchMatchesSingleSolves()
+{
+    std::vector<BatchLP> problems = {
+        {SparseLPModel::FromDense({-2, -3, 9, -2}, {{-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}}), false},
+        {SparseLPModel::FromDense({8, 0, -3, 5}, {{3, -3, 1, -3, 9, 0}, {4, 2, 3, 4, 1, 1}, {9, -1, 7, 1, 14, 0}, {8, -3, 9, 7, 26, 1}}), false},
+        {SparseLPModel::FromDense({5, 1, 2}, {{4, 7, 4, 20, 1}, {6, 1, 8, 18, 1}}), true},
+        {SparseLPModel::FromDense({1, 1}, {{1, 1, 2, 0}, {1, 1, 5, 1}}), false},
+        {SparseLPModel::FromDense({2, 6, 6}, {{8, 8, 8, 26.5, 0}, {7, 2, 6, 20.5, 0}}), false}};
+
+    std::vector<double> expected;
+    for (const BatchLP &problem : problems)
+    {
+        DualSimplex dual;
+        expected.push_back(dual.DoDualSimplex(problem.model, problem.isMin).optimalSolution);
+    }
+    Check(Near(expected[0], 10.75) && std::isnan(expected[1]) && Near(expected[2], 5.7692) && std::isnan(expected[3]) &&
+              Near(expected[4], 19.875),
+          "batch: lone solves give 10.75, none, 5.769, none and 19.875");
+
+    for (std::size_t threads : {1, 4})
+    {
+        BatchSolver batch;
+        batch.SetThreadCount(threads);
+        auto results = batch.SolveBatch(problems);
+
+        bool same = results.size() == problems.size();
+        for (std::size_t i = 0; same && i < results.size(); i++)
+        {
+            if (std::isnan(expected[i]))
+                same = results[i].status == BatchSolveStatus::NoSolution;
+            else
+                same = results[i].status == BatchSolveStatus::Optimal && Near(results[i].result.optimalSolution, expected[i]);
+        }
+        Check(same, "batch on " + std::to_string(threads) + " threads matches the lone solves in order");
+    }
+
+    BatchSolver tight;
+    tight.SetMemoryBudget(1);
+    auto skipped = tight.SolveBatch(problems);
+    Check(std::all_of(skipped.begin(), skipped.end(), [](const BatchSolver::BatchSolveResult &res)
+                      { return res.status == BatchSolveStatus::OverMemoryBudget; }),
+          "batch: a one byte budget skips every solve");
+}
+
+// restarting from the final basis of a solve needs no pivots, and after the first rhs moves from 6 to 7
+// it takes one pivot where the cold solve takes seven, for the same optimum 12.6, on both engines
+static void WarmStartFromFinalBasis()
+{
+    std::vector<double> objFunc = {-2, -3, 9, -2};
+    std::vector<std::vector<double>> constraints = {
+        {-1, 5, 5, 2, 6, 0}, {8, 1, 2, 6, 16, 0}, {2, 3, 6, -3, 8, 1}, {6, -3, 9, 6, 16, 0}};
+    auto changed = constraints;
+    changed[0][4] = 7;
+
+    DualSimplex cold;
+    auto first = cold.DoDualSimplex(objFunc, constraints, false);
+    LPBasis basis = cold.GetFinalBasis();
+    DualSimplex coldChanged;
+    auto second = coldChanged.DoDualSimplex(objFunc, changed, false);
+    Check(Near(first.optimalSolution, 10.75) && Near(second.optimalSolution, 12.6), "warm start: cold solves give 10.75 and 12.6");
+
+    for (SimplexEngine engine : {SimplexEngine::Dense, SimplexEngine::Revised})
+    {
+        std::string label = engine == SimplexEngine::Dense ? "dense" : "revised";
+
+        DualSimplex same;
+        same.SetEngine(engine);
+        auto again = same.DoDualSimplex(objFunc, constraints, false, basis);
+        Check(Near(again.optimalSolution, 10.75) && again.pivotCols.empty(), label + " warm start from the optimal basis needs no pivots");
+
+        DualSimplex moved;
+        moved.SetEngine(engine);
+        auto resolved = moved.DoDualSimplex(objFunc, changed, false, basis);
+        Check(Near(resolved.optimalSolution, 12.6) && resolved.pivotCols.size() < second.pivotCols.size(),
+              label + " warm start after an rhs change reaches 12.6 in fewer pivots than a cold solve");
+    }
+}
+
+// min x + 2y - z with x + y + z >= 2, -1 <= x - y <= 3, -2 <= x <= 5 and z <= 6, written once as MPS with
+// a RANGES entry and once as LP with the range as a second row. Both read to the same model and bounds,
+// the range twin last, and solve to -7 at (-1, 0, 6)
+static void ModelFilesAgree()
+{
+    const char *mps = "NAME RANGED\n"
+                      "ROWS\n N obj\n G c1\n L c2\n"
+                      "COLUMNS\n x obj 1 c1 1\n x c2 1\n y obj 2 c1 1\n y c2 -1\n z obj -1 c1 1\n"
+                      "RHS\n rhs c1 2 c2 3\n"
+                      "RANGES\n rng c2 4\n"
+                      "BOUNDS\n LO bnd x -2\n UP bnd x 5\n UP bnd z 6\n"
+                      "ENDATA\n";
+    const char *lp = "Minimize\n obj: x + 2 y - z\n"
+                     "Subject To\n c1: x + y + z >= 2\n c2: x - y <= 3\n c2: x - y >= -1\n"
+                     "Bounds\n -2 <= x <= 5\n z <= 6\n"
+                     "End\n";
+
+    MpsReader mpsReader;
+    ModelFile fromMps = mpsReader.ReadText(mps);
+    LpReader lpReader;
+    ModelFile fromLp = lpReader.ReadText(lp);
+
+    const SparseLPModel &a = fromMps.model;
+    const SparseLPModel &b = fromLp.model;
+    Check(a.numRows == 3 && a.rhs == std::vector<double>({2, 3, -1}) && a.senses == std::vector<int>({1, 0, 1}),
+          "mps: the range adds a >= -1 twin of c2 after the file's rows");
+    Check(a.numRows == b.numRows && a.numCols == b.numCols && a.objective == b.objective && a.rhs == b.rhs &&
+              a.senses == b.senses && a.colStart == b.colStart && a.rowIndex == b.rowIndex && a.values == b.values,
+          "mps and lp give the same model");
+    Check(fromMps.isMin && fromLp.isMin && fromMps.lower == fromLp.lower && fromMps.upper == fromLp.upper &&
+              fromMps.lower[0] == -2 && fromMps.upper[0] == 5 && fromMps.upper[2] == 6,
+          "mps and lp give the same bounds, x in [-2, 5]");
+
+    for (const ModelFile *file : {&fromMps, &fromLp})
+    {
+        std::string label = file == &fromMps ? "mps" : "lp";
+        DualSimplex dual;
+        dual.SetVariableBounds(file->lower, file->upper);
+        auto result = dual.DoDualSimplex(file->model, file->isMin);
+        Check(Near(result.optimalSolution, -7.0) && result.changingVars.size() == 3 && Near(result.changingVars[0], -1.0) &&
+                  Near(result.changingVars[1], 0.0) && Near(result.changingVars[2], 6.0),
+              label + ": min is -7 at (-1, 0, 6)");
+    }
+}
+
+// a bad record fails on its own: the batch front end writes an error result for the ragged constraints
+// and the unknown solver, solves the records around them and exits with 1
+static void CliRecordErrors()
+{
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string recordsPath = (dir / "lpr_regression_records.jsonl").string();
+    std::string resultsPath = (dir / "lpr_regression_results.jsonl").string();
+    {
+        std::ofstream records(recordsPath);
+        records << R"({"id":"ok","objective":[3,2],"constraints":[[1,1,4,0],[1,3,6,0]],"problemType":"Max"})" << '\n'
+                << R"({"id":"ragged","objective":[3,2],"constraints":[[1,1,4,0],[1,6,0]]})" << '\n'
+                << R"({"id":"unknown","solver":"simplexPlus","objective":[3,2],"constraints":[[1,1,4,0]]})" << '\n'
+                << R"({"id":"last","solver":"twoPhaseSimplex","objective":[3,2],"constraints":[[1,1,4,0],[1,3,6,0]],"problemType":"Max"})" << '\n';
+    }
+
+    std::vector<std::string> args = {"linprog-toolset", "-j", "1", "-o", resultsPath, recordsPath};
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+        argv.push_back(arg.data());
+    BatchCli cli;
+    int code = cli.Run(static_cast<int>(argv.size()), argv.data());
+
+    std::vector<std::string> lines;
+    std::ifstream results(resultsPath);
+    for (std::string line; std::getline(results, line);)
+        lines.push_back(line);
+    results.close();
+    std::filesystem::remove(recordsPath);
+    std::filesystem::remove(resultsPath);
+
+    auto has = [&](std::size_t i, const std::string &text)
+    {
+        return i < lines.size() && lines[i].find(text) != std::string::npos;
+    };
+    Check(code == 1 && lines.size() == 4, "cli: four results and exit code 1 with failed records");
+    Check(has(0, R"("id":"ok")") && has(0, R"("optimalSolution":12)"), "cli: the first record solves to 12");
+    Check(has(1, R"("status":"error")") && has(1, R"(row 2 of \"constraints\" has 3 entries)"), "cli: ragged constraints are an error");
+    Check(has(2, R"("status":"error")") && has(2, "unknown solver 'simplexPlus'"), "cli: an unknown solver is an error");
+    Check(has(3, R"("id":"last")") && has(3, R"("optimalSolution":12)"), "cli: the record after the errors still solves");
+}
+
+// max 5x1 + 4x2 + 3x3 + 7x4 over three knapsack rows, optimum 18 after 58 nodes. A deterministic search
+// takes nodes in fixed rounds, so four threads have to write out the same tree as one
+static void DeterministicTreeAcrossThreads()
+{
+    std::vector<double> objFunc = {5, 4, 3, 7};
+    std::vector<std::vector<double>> constraints = {{2, 3, 1, 4, 10.5, 0}, {4, 1, 2, 3, 11.3, 0}, {3, 4, 2, 5, 12.7, 0}};
+
+    for (BranchingMode mode : {BranchingMode::ConstraintRows, BranchingMode::BoundChanges})
+    {
+        std::vector<std::string> trees;
+        std::vector<int> nodes;
+        for (std::size_t threads : {1, 4})
+        {
+            BranchAndBound bb;
+            bb.SetBranchingMode(mode);
+            bb.SetThreadCount(threads);
+            bb.SetDeterministic(true, 4);
+            bb.RunBranchAndBound(objFunc, constraints, false);
+            trees.push_back(bb.getJSON() + bb.getSolutionStr());
+            nodes.push_back(bb.GetLastResult().nodes);
+        }
+        std::string label = mode == BranchingMode::BoundChanges ? "bound-change" : "constraint-row";
+        Check(nodes[0] == 58 && nodes[1] == 58, label + " deterministic search takes 58 nodes");
+        Check(trees[0] == trees[1], label + " deterministic tree is the same on one and four threads");
+    }
+}
+
+// the knapsack rows as <= for max, optimum 18, and as >= for min, optimum 21, with bound-change
+// branching. Open nodes kept as branch diffs rebuild their tableau from the root one, which must lead
+// to the same nodes, tree and incumbent as keeping full tableaus
+static void BranchDiffsMatchFullTableau()
+{
+    std::vector<double> objFunc = {5, 4, 3, 7};
+
+    for (bool isMin : {false, true})
+    {
+        double sign = isMin ? 1 : 0;
+        std::vector<std::vector<double>> constraints = {
+            {2, 3, 1, 4, 10.5, sign}, {4, 1, 2, 3, 11.3, sign}, {3, 4, 2, 5, 12.7, sign}};
+
+        std::vector<std::string> trees;
+        std::vector<int> nodes;
+        std::vector<double> incumbents;
+        for (NodeStorage storage : {NodeStorage::FullTableau, NodeStorage::BranchDiffs})
+        {
+            BranchAndBound bb;
+            bb.SetBranchingMode(BranchingMode::BoundChanges);
+            bb.SetNodeStorage(storage);
+            bb.SetTableauRendering(TableauRendering::None);
+            bb.RunBranchAndBound(objFunc, constraints, isMin);
+            const BranchAndBound::SearchResult &result = bb.GetLastResult();
+            trees.push_back(bb.getJSON() + bb.getSolutionStr());
+            nodes.push_back(result.nodes);
+            incumbents.push_back(result.incumbent ? *result.incumbent : std::numeric_limits<double>::quiet_NaN());
+        }
+        std::string label = isMin ? "branch diffs min" : "branch diffs max";
+        Check(Near(incumbents[0], isMin ? 21.0 : 18.0) && Near(incumbents[1], incumbents[0]), label + ": same incumbent");
+        Check(nodes[0] == nodes[1], label + ": same node count");
+        Check(trees[0] == trees[1], label + ": same tree");
+    }
+}
+
+// the knapsack rows with constraint-row branching under each tableau rendering. Rendering only changes
+// what the tree keeps: None writes every tableau field out empty, FinalOnly keeps just final tableaus
+static void TableauRenderingTree()
+{
+    std::vector<double> objFunc = {5, 4, 3, 7};
+    std::vector<std::vector<double>> constraints = {{2, 3, 1, 4, 10.5, 0}, {4, 1, 2, 3, 11.3, 0}, {3, 4, 2, 5, 12.7, 0}};
+
+    auto count = [](const std::string &json, const std::string &text)
+    {
+        std::size_t found = 0;
+        for (std::size_t at = json.find(text); at != std::string::npos; at = json.find(text, at + 1))
+            found++;
+        return found;
+    };
+    // tableau fields of a node in the tree json that hold text
+    auto rendered = [&](const std::string &json, const std::string &field)
+    {
+        return count(json, "\"" + field + "\":\"") - count(json, "\"" + field + "\":\"\"");
+    };
+
+    std::vector<std::string> solutions;
+    std::vector<int> nodes;
+    std::vector<std::string> trees;
+    for (TableauRendering rendering : {TableauRendering::None, TableauRendering::FinalOnly, TableauRendering::Full})
+    {
+        BranchAndBound bb;
+        bb.SetTableauRendering(rendering);
+        bb.RunBranchAndBound(objFunc, constraints, false);
+        solutions.push_back(bb.getSolutionStr());
+        nodes.push_back(bb.GetLastResult().nodes);
+        trees.push_back(bb.getJSON());
+    }
+
+    Check(solutions[0] == solutions[2] && solutions[1] == solutions[2], "rendering: same best solution");
+    Check(nodes[0] == nodes[2] && nodes[1] == nodes[2], "rendering: same node count");
+    Check(rendered(trees[0], "unfixedTab") == 0 && rendered(trees[0], "fixedTab") == 0 &&
+              rendered(trees[0], "finalTableau") == 0 && count(trees[0], "\"intermediateTableaus\":[\"") == 0,
+          "rendering none: every tableau field is empty");
+    Check(rendered(trees[1], "finalTableau") > 0 && rendered(trees[1], "unfixedTab") == 0 &&
+              rendered(trees[1], "fixedTab") == 0,
+          "rendering final only: only final tableaus are written");
+    Check(rendered(trees[2], "finalTableau") > 0 && rendered(trees[2], "unfixedTab") > 0, "rendering full: tableaus are written");
+}
+
+// the exact and float instantiations run the same dense search as double
+template <typename Scalar>
+static void ScalarBranchAndBound(const std::string &label)
+{
+    std::vector<double> objFunc = {2, 6, 6};
+    std::vector<std::vector<double>> constraints = {{8, 8, 8, 26.5, 0}, {7, 2, 6, 20.5, 0}};
+
+    BasicBranchAndBound<Scalar> bb;
+    typename BasicBranchAndBound<Scalar>::SearchLimits limits;
+    limits.nodeLimit = 400;
+    bb.SetLimits(limits);
+    bb.RunBranchAndBound(objFunc, constraints, false);
+
+    const auto &result = bb.GetLastResult();
+    Check(result.incumbent && Near(*result.incumbent, 18.0), label + ": max IP objective 18");
+
+    BasicTwoPhaseSimplex<Scalar> twoPhase;
+    twoPhase.DoTwoPhase(objFunc, constraints, false);
+    Check(Near(twoPhase.GetResult().optimalSolution, 19.875), label + ": two phase LP objective 19.875");
+}
+
+// min 5x1 with 5x1 + 4x2 <= 27, -x2 <= 12 and 5x1 + 7x2 >= 12, optimum 0 at (0, 12/7). The check after
+// the primal loop took rounding below zero in a row for infeasibility and undid the last pivot
+static void LongDoublePrimalFeasibility()
+{
+    std::vector<double> objFunc = {5, 0};
+    std::vector<std::vector<double>> constraints = {{5, 4, 27, 0}, {0, -1, 12, 0}, {5, 7, 12, 1}};
+
+    BasicDualSimplex<long double> dual;
+    auto result = dual.DoDualSimplex(objFunc, constraints, true);
+    Check(Near(result.optimalSolution, 0.0), "long double: min objective is 0");
+}
+
+int main()
+{
+    MinBoundChangesBranchAndBound();
+    ConstraintRowsBasicColumns();
+    MinSearchLimits();
+    IdenticalColumnsIncumbent();
+    IntegralitySnapFeasible();
+    NodeSelectionRulesAgree();
+    WeightedPricingRulesOptimal();
+    DualRowsSkipObjective();
+    RevisedNonOptimalStatus();
+    InteriorPointCrossoverStatus();
+    BoundedUnboundedPrimal();
+    PhaseTwoRatioTest();
+    PresolveKeepsVariableBounds();
+    ScaledMatchesUnscaled();
+    WarmStartFromFinalBasis();
+    ModelFilesAgree();
+    CliRecordErrors();
+    DeterministicTreeAcrossThreads();
+    BranchDiffsMatchFullTableau();
+    TableauRenderingTree();
+    BatchMatchesSingleSolves();
+    ScalarBranchAndBound<float>("float");
+    ScalarBranchAndBound<Rational>("rational");
+    LongDoublePrimalFeasibility();
+
+    if (failures == 0)
+        std::cout << "all regression cases passed" << std::endl;
+    return failures;
+}